@@ -0,0 +1,588 @@
+
+#ifndef GUDOKU_BENCHMARK_BENCH_REPORT_H
+#define GUDOKU_BENCHMARK_BENCH_REPORT_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>    // For std::min()
+
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>    // For GetComputerNameA()
+#else
+#include <unistd.h>     // For gethostname()
+#endif
+
+//
+// The machine-readable results of a benchmark run, and back.
+//
+// JSON (one document per run):
+//
+//   { "gudoku": "1.0.0", "host": ..., "compiler": ..., "timestamp": ..., "dataset": ...,
+//     "puzzles": 49158, "limit": 1, "repetitions": 10, "cpu": 2, "shuffle_seed": 1,
+//     "solvers": [ { "name": "dpll-avx2", "usec_per_puzzle": [ ... ],
+//                    "guesses_per_puzzle": 0.46, "ipc": 2.9, "branch_miss_rate": 0.01 }, ... ] }
+//
+// CSV (one row per solver and repetition, the run in every row):
+//
+//   gudoku,host,compiler,timestamp,dataset,puzzles,limit,cpu,shuffle_seed,solver,repetition,
+//   usec_per_puzzle,guesses_per_puzzle
+//
+// read_report() takes either, and only needs the solvers and their samples.
+//
+
+namespace test {
+
+struct SolverReport {
+    std::string         name;
+    std::vector<double> samples;            // usec/puzzle of every repetition
+    double              guesses_per_puzzle;
+    bool                has_perf;
+    double              ipc;
+    double              branch_miss_rate;
+
+    SolverReport() : guesses_per_puzzle(0.0), has_perf(false), ipc(0.0), branch_miss_rate(0.0) {}
+};
+
+struct BenchReport {
+    std::string version;
+    std::string host;
+    std::string compiler;
+    std::string timestamp;
+    std::string dataset;
+    size_t      puzzles;
+    int         limit;
+    int         repetitions;
+    int         cpu;                // -1: not pinned
+    long        shuffle_seed;       // -1: not shuffled
+
+    std::vector<SolverReport> solvers;
+
+    BenchReport() : puzzles(0), limit(1), repetitions(1), cpu(-1), shuffle_seed(-1) {}
+
+    const SolverReport * find(const std::string & name) const {
+        for (size_t i = 0; i < this->solvers.size(); i++) {
+            if (this->solvers[i].name == name)
+                return &this->solvers[i];
+        }
+        return nullptr;
+    }
+};
+
+static std::string host_name()
+{
+    char name[256];
+    name[0] = '\0';
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    DWORD size = sizeof(name);
+    if (!::GetComputerNameA(name, &size))
+        name[0] = '\0';
+#else
+    if (::gethostname(name, sizeof(name)) != 0)
+        name[0] = '\0';
+    name[sizeof(name) - 1] = '\0';
+#endif
+    return std::string(name);
+}
+
+static std::string compiler_name()
+{
+    char name[256];
+#if defined(__clang__)
+    snprintf(name, sizeof(name), "clang %d.%d.%d", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+    snprintf(name, sizeof(name), "gcc %d.%d.%d", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+    snprintf(name, sizeof(name), "msvc %d", _MSC_VER);
+#else
+    snprintf(name, sizeof(name), "unknown");
+#endif
+    return std::string(name);
+}
+
+// The current time, ISO 8601 in UTC.
+static std::string utc_timestamp()
+{
+    time_t now = ::time(nullptr);
+    struct tm utc;
+#if defined(_MSC_VER)
+    ::gmtime_s(&utc, &now);
+#else
+    ::gmtime_r(&now, &utc);
+#endif
+    char buf[32];
+    ::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return std::string(buf);
+}
+
+namespace detail {
+
+static std::string json_escape(const std::string & str)
+{
+    std::string escaped;
+    for (size_t i = 0; i < str.size(); i++) {
+        char ch = str[i];
+        if (ch == '"' || ch == '\\') {
+            escaped += '\\';
+            escaped += ch;
+        }
+        else if ((unsigned char)ch < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)(unsigned char)ch);
+            escaped += buf;
+        }
+        else {
+            escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+static std::string csv_escape(const std::string & str)
+{
+    if (str.find_first_of(",\"\r\n") == std::string::npos)
+        return str;
+    std::string escaped = "\"";
+    for (size_t i = 0; i < str.size(); i++) {
+        if (str[i] == '"')
+            escaped += '"';
+        escaped += str[i];
+    }
+    escaped += '"';
+    return escaped;
+}
+
+//
+// A minimal JSON reader, for the documents write_json() writes.
+//
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object };
+
+    Type                    type;
+    double                  number;
+    std::string             str;
+    std::vector<JsonValue>  items;      // Array items, or object values
+    std::vector<std::string> keys;      // Object keys
+
+    JsonValue() : type(Null), number(0.0) {}
+
+    const JsonValue * get(const char * key) const {
+        for (size_t i = 0; i < this->keys.size(); i++) {
+            if (this->keys[i] == key)
+                return &this->items[i];
+        }
+        return nullptr;
+    }
+};
+
+class JsonReader {
+private:
+    const char * cur_;
+    const char * end_;
+
+    void skipSpaces() {
+        while (this->cur_ < this->end_ && (*this->cur_ == ' ' || *this->cur_ == '\t' ||
+                                           *this->cur_ == '\r' || *this->cur_ == '\n')) {
+            this->cur_++;
+        }
+    }
+
+    bool match(const char * literal) {
+        size_t len = ::strlen(literal);
+        if ((size_t)(this->end_ - this->cur_) >= len && ::strncmp(this->cur_, literal, len) == 0) {
+            this->cur_ += len;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseString(std::string & out) {
+        if (this->cur_ >= this->end_ || *this->cur_ != '"')
+            return false;
+        this->cur_++;
+        out.clear();
+        while (this->cur_ < this->end_ && *this->cur_ != '"') {
+            char ch = *this->cur_++;
+            if (ch == '\\' && this->cur_ < this->end_) {
+                char esc = *this->cur_++;
+                switch (esc) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                        // Only the control characters json_escape() writes.
+                        if (this->end_ - this->cur_ >= 4) {
+                            out += (char)::strtol(std::string(this->cur_, this->cur_ + 4).c_str(), nullptr, 16);
+                            this->cur_ += 4;
+                        }
+                        break;
+                    default:  out += esc; break;
+                }
+            }
+            else {
+                out += ch;
+            }
+        }
+        if (this->cur_ >= this->end_)
+            return false;
+        this->cur_++;
+        return true;
+    }
+
+    bool parseValue(JsonValue & value) {
+        this->skipSpaces();
+        if (this->cur_ >= this->end_)
+            return false;
+        char ch = *this->cur_;
+        if (ch == '{') {
+            this->cur_++;
+            value.type = JsonValue::Object;
+            this->skipSpaces();
+            if (this->cur_ < this->end_ && *this->cur_ == '}') {
+                this->cur_++;
+                return true;
+            }
+            for (;;) {
+                this->skipSpaces();
+                std::string key;
+                if (!this->parseString(key))
+                    return false;
+                this->skipSpaces();
+                if (this->cur_ >= this->end_ || *this->cur_ != ':')
+                    return false;
+                this->cur_++;
+                value.keys.push_back(key);
+                value.items.push_back(JsonValue());
+                if (!this->parseValue(value.items.back()))
+                    return false;
+                this->skipSpaces();
+                if (this->cur_ < this->end_ && *this->cur_ == ',') {
+                    this->cur_++;
+                    continue;
+                }
+                if (this->cur_ < this->end_ && *this->cur_ == '}') {
+                    this->cur_++;
+                    return true;
+                }
+                return false;
+            }
+        }
+        else if (ch == '[') {
+            this->cur_++;
+            value.type = JsonValue::Array;
+            this->skipSpaces();
+            if (this->cur_ < this->end_ && *this->cur_ == ']') {
+                this->cur_++;
+                return true;
+            }
+            for (;;) {
+                value.items.push_back(JsonValue());
+                if (!this->parseValue(value.items.back()))
+                    return false;
+                this->skipSpaces();
+                if (this->cur_ < this->end_ && *this->cur_ == ',') {
+                    this->cur_++;
+                    continue;
+                }
+                if (this->cur_ < this->end_ && *this->cur_ == ']') {
+                    this->cur_++;
+                    return true;
+                }
+                return false;
+            }
+        }
+        else if (ch == '"') {
+            value.type = JsonValue::String;
+            return this->parseString(value.str);
+        }
+        else if (this->match("true")) {
+            value.type = JsonValue::Bool;
+            value.number = 1.0;
+            return true;
+        }
+        else if (this->match("false")) {
+            value.type = JsonValue::Bool;
+            value.number = 0.0;
+            return true;
+        }
+        else if (this->match("null")) {
+            value.type = JsonValue::Null;
+            return true;
+        }
+        else {
+            char * last = nullptr;
+            std::string rest(this->cur_, (size_t)std::min<ptrdiff_t>(this->end_ - this->cur_, 64));
+            value.number = ::strtod(rest.c_str(), &last);
+            if (last == rest.c_str())
+                return false;
+            value.type = JsonValue::Number;
+            this->cur_ += (last - rest.c_str());
+            return true;
+        }
+    }
+
+public:
+    bool parse(const std::string & text, JsonValue & root) {
+        this->cur_ = text.c_str();
+        this->end_ = text.c_str() + text.size();
+        if (!this->parseValue(root))
+            return false;
+        this->skipSpaces();
+        return (this->cur_ == this->end_);
+    }
+};
+
+static std::vector<std::string> split_csv_line(const std::string & line)
+{
+    std::vector<std::string> fields;
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char ch = line[i];
+        if (quoted) {
+            if (ch == '"') {
+                if (i + 1 < line.size() && line[i + 1] == '"') {
+                    field += '"';
+                    i++;
+                }
+                else {
+                    quoted = false;
+                }
+            }
+            else {
+                field += ch;
+            }
+        }
+        else if (ch == '"') {
+            quoted = true;
+        }
+        else if (ch == ',') {
+            fields.push_back(field);
+            field.clear();
+        }
+        else if (ch != '\r') {
+            field += ch;
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+static std::string json_string(const JsonValue & object, const char * key)
+{
+    const JsonValue * value = object.get(key);
+    return (value != nullptr && value->type == JsonValue::String) ? value->str : std::string();
+}
+
+static double json_number(const JsonValue & object, const char * key, double default_value)
+{
+    const JsonValue * value = object.get(key);
+    return (value != nullptr && value->type == JsonValue::Number) ? value->number : default_value;
+}
+
+} // namespace detail
+
+static bool write_json(const BenchReport & report, const char * filename)
+{
+    FILE * fp = ::fopen(filename, "w");
+    if (fp == nullptr)
+        return false;
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"gudoku\": \"%s\",\n", detail::json_escape(report.version).c_str());
+    fprintf(fp, "  \"host\": \"%s\",\n", detail::json_escape(report.host).c_str());
+    fprintf(fp, "  \"compiler\": \"%s\",\n", detail::json_escape(report.compiler).c_str());
+    fprintf(fp, "  \"timestamp\": \"%s\",\n", detail::json_escape(report.timestamp).c_str());
+    fprintf(fp, "  \"dataset\": \"%s\",\n", detail::json_escape(report.dataset).c_str());
+    fprintf(fp, "  \"puzzles\": %u,\n", (uint32_t)report.puzzles);
+    fprintf(fp, "  \"limit\": %d,\n", report.limit);
+    fprintf(fp, "  \"repetitions\": %d,\n", report.repetitions);
+    fprintf(fp, "  \"cpu\": %d,\n", report.cpu);
+    fprintf(fp, "  \"shuffle_seed\": %ld,\n", report.shuffle_seed);
+    fprintf(fp, "  \"solvers\": [\n");
+    for (size_t i = 0; i < report.solvers.size(); i++) {
+        const SolverReport & solver = report.solvers[i];
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"name\": \"%s\",\n", detail::json_escape(solver.name).c_str());
+        fprintf(fp, "      \"usec_per_puzzle\": [");
+        for (size_t j = 0; j < solver.samples.size(); j++) {
+            fprintf(fp, "%s%0.6f", (j == 0) ? "" : ", ", solver.samples[j]);
+        }
+        fprintf(fp, "],\n");
+        if (solver.has_perf) {
+            fprintf(fp, "      \"ipc\": %0.6f,\n", solver.ipc);
+            fprintf(fp, "      \"branch_miss_rate\": %0.8f,\n", solver.branch_miss_rate);
+        }
+        fprintf(fp, "      \"guesses_per_puzzle\": %0.6f\n", solver.guesses_per_puzzle);
+        fprintf(fp, "    }%s\n", (i + 1 < report.solvers.size()) ? "," : "");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+
+    bool success = (::ferror(fp) == 0);
+    ::fclose(fp);
+    return success;
+}
+
+static bool write_csv(const BenchReport & report, const char * filename)
+{
+    FILE * fp = ::fopen(filename, "w");
+    if (fp == nullptr)
+        return false;
+
+    fprintf(fp, "gudoku,host,compiler,timestamp,dataset,puzzles,limit,cpu,shuffle_seed,"
+                "solver,repetition,usec_per_puzzle,guesses_per_puzzle\n");
+    for (size_t i = 0; i < report.solvers.size(); i++) {
+        const SolverReport & solver = report.solvers[i];
+        for (size_t j = 0; j < solver.samples.size(); j++) {
+            fprintf(fp, "%s,%s,%s,%s,%s,%u,%d,%d,%ld,%s,%u,%0.6f,%0.6f\n",
+                    detail::csv_escape(report.version).c_str(),
+                    detail::csv_escape(report.host).c_str(),
+                    detail::csv_escape(report.compiler).c_str(),
+                    detail::csv_escape(report.timestamp).c_str(),
+                    detail::csv_escape(report.dataset).c_str(),
+                    (uint32_t)report.puzzles, report.limit, report.cpu, report.shuffle_seed,
+                    detail::csv_escape(solver.name).c_str(), (uint32_t)j,
+                    solver.samples[j], solver.guesses_per_puzzle);
+        }
+    }
+
+    bool success = (::ferror(fp) == 0);
+    ::fclose(fp);
+    return success;
+}
+
+//
+// Read a report written by write_json() or write_csv(). Returns false (and why) if the
+// file can't be read or isn't one of them.
+//
+static bool read_report(const char * filename, BenchReport & report, std::string & error)
+{
+    std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+    if (!ifs.good()) {
+        error = "can't open the file";
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << ifs.rdbuf();
+    std::string text = buffer.str();
+
+    report = BenchReport();
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        error = "empty file";
+        return false;
+    }
+
+    if (text[first] == '{') {
+        detail::JsonValue root;
+        detail::JsonReader reader;
+        if (!reader.parse(text, root) || root.type != detail::JsonValue::Object) {
+            error = "malformed JSON";
+            return false;
+        }
+        report.version   = detail::json_string(root, "gudoku");
+        report.host      = detail::json_string(root, "host");
+        report.compiler  = detail::json_string(root, "compiler");
+        report.timestamp = detail::json_string(root, "timestamp");
+        report.dataset   = detail::json_string(root, "dataset");
+        report.puzzles   = (size_t)detail::json_number(root, "puzzles", 0.0);
+        report.limit     = (int)detail::json_number(root, "limit", 1.0);
+        report.repetitions  = (int)detail::json_number(root, "repetitions", 1.0);
+        report.cpu          = (int)detail::json_number(root, "cpu", -1.0);
+        report.shuffle_seed = (long)detail::json_number(root, "shuffle_seed", -1.0);
+
+        const detail::JsonValue * solvers = root.get("solvers");
+        if (solvers == nullptr || solvers->type != detail::JsonValue::Array) {
+            error = "no \"solvers\" array";
+            return false;
+        }
+        for (size_t i = 0; i < solvers->items.size(); i++) {
+            const detail::JsonValue & item = solvers->items[i];
+            SolverReport solver;
+            solver.name = detail::json_string(item, "name");
+            const detail::JsonValue * samples = item.get("usec_per_puzzle");
+            if (samples != nullptr && samples->type == detail::JsonValue::Array) {
+                for (size_t j = 0; j < samples->items.size(); j++) {
+                    solver.samples.push_back(samples->items[j].number);
+                }
+            }
+            solver.guesses_per_puzzle = detail::json_number(item, "guesses_per_puzzle", 0.0);
+            solver.has_perf = (item.get("ipc") != nullptr);
+            solver.ipc = detail::json_number(item, "ipc", 0.0);
+            solver.branch_miss_rate = detail::json_number(item, "branch_miss_rate", 0.0);
+            report.solvers.push_back(solver);
+        }
+        return true;
+    }
+    else {
+        std::istringstream lines(text);
+        std::string line;
+        std::getline(lines, line);
+        std::vector<std::string> header = detail::split_csv_line(line);
+        static const size_t kColumns = 13;
+        if (header.size() != kColumns || header[9] != "solver" || header[11] != "usec_per_puzzle") {
+            error = "not a JSON or CSV benchmark report";
+            return false;
+        }
+        while (std::getline(lines, line)) {
+            if (line.empty() || line == "\r")
+                continue;
+            std::vector<std::string> fields = detail::split_csv_line(line);
+            if (fields.size() != kColumns) {
+                error = "malformed CSV row";
+                return false;
+            }
+            report.version   = fields[0];
+            report.host      = fields[1];
+            report.compiler  = fields[2];
+            report.timestamp = fields[3];
+            report.dataset   = fields[4];
+            report.puzzles   = (size_t)::strtoul(fields[5].c_str(), nullptr, 10);
+            report.limit     = ::atoi(fields[6].c_str());
+            report.cpu       = ::atoi(fields[7].c_str());
+            report.shuffle_seed = ::strtol(fields[8].c_str(), nullptr, 10);
+
+            SolverReport * solver = nullptr;
+            for (size_t i = 0; i < report.solvers.size(); i++) {
+                if (report.solvers[i].name == fields[9])
+                    solver = &report.solvers[i];
+            }
+            if (solver == nullptr) {
+                report.solvers.push_back(SolverReport());
+                solver = &report.solvers.back();
+                solver->name = fields[9];
+            }
+            solver->samples.push_back(::strtod(fields[11].c_str(), nullptr));
+            solver->guesses_per_puzzle = ::strtod(fields[12].c_str(), nullptr);
+        }
+        report.repetitions = report.solvers.empty() ? 0 : (int)report.solvers[0].samples.size();
+        return true;
+    }
+}
+
+} // namespace test
+
+#endif // GUDOKU_BENCHMARK_BENCH_REPORT_H
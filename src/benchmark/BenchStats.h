@@ -0,0 +1,154 @@
+
+#ifndef GUDOKU_BENCHMARK_BENCH_STATS_H
+#define GUDOKU_BENCHMARK_BENCH_STATS_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stddef.h>
+#include <math.h>
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>    // For std::sort()
+
+//
+// Summary statistics of the repetitions of a benchmark, and Welch's t-test to tell whether
+// two sets of repetitions differ by more than their noise.
+//
+
+namespace test {
+
+struct SampleStats {
+    size_t  count;
+    double  mean;
+    double  median;
+    double  stddev;     // Sample standard deviation (n - 1)
+    double  min;
+    double  max;
+
+    SampleStats() : count(0), mean(0.0), median(0.0), stddev(0.0), min(0.0), max(0.0) {}
+
+    explicit SampleStats(const std::vector<double> & samples)
+        : count(samples.size()), mean(0.0), median(0.0), stddev(0.0), min(0.0), max(0.0) {
+        if (samples.empty())
+            return;
+
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        this->min = sorted.front();
+        this->max = sorted.back();
+        size_t half = sorted.size() / 2;
+        this->median = (sorted.size() % 2 != 0) ? sorted[half] : (sorted[half - 1] + sorted[half]) / 2.0;
+
+        double sum = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++) {
+            sum += sorted[i];
+        }
+        this->mean = sum / sorted.size();
+
+        if (sorted.size() > 1) {
+            double squares = 0.0;
+            for (size_t i = 0; i < sorted.size(); i++) {
+                double diff = sorted[i] - this->mean;
+                squares += diff * diff;
+            }
+            this->stddev = std::sqrt(squares / (sorted.size() - 1));
+        }
+    }
+};
+
+struct TTestResult {
+    bool    valid;      // Both sides have at least 2 samples and some variance
+    double  t;
+    double  df;         // Welch-Satterthwaite degrees of freedom
+    double  p;          // Two-sided p-value
+
+    TTestResult() : valid(false), t(0.0), df(0.0), p(1.0) {}
+};
+
+namespace detail {
+
+//
+// The continued fraction of the regularized incomplete beta function, evaluated by the
+// modified Lentz method.
+//
+static double incomplete_beta_cf(double a, double b, double x)
+{
+    static const int    kMaxIterations = 300;
+    static const double kEpsilon = 1.0e-14;
+    static const double kTiny = 1.0e-300;
+
+    double qab = a + b, qap = a + 1.0, qam = a - 1.0;
+    double c = 1.0;
+    double d = 1.0 - qab * x / qap;
+    if (std::fabs(d) < kTiny) d = kTiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= kMaxIterations; m++) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < kTiny) d = kTiny;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < kTiny) c = kTiny;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < kTiny) d = kTiny;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < kTiny) c = kTiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < kEpsilon)
+            break;
+    }
+    return h;
+}
+
+// The regularized incomplete beta function I_x(a, b).
+static double incomplete_beta(double a, double b, double x)
+{
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                            a * std::log(x) + b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0))
+        return front * incomplete_beta_cf(a, b, x) / a;
+    else
+        return 1.0 - front * incomplete_beta_cf(b, a, 1.0 - x) / b;
+}
+
+} // namespace detail
+
+//
+// Welch's unequal-variance t-test of the means of two sets of samples.
+//
+static TTestResult welch_t_test(const SampleStats & a, const SampleStats & b)
+{
+    TTestResult result;
+    if (a.count < 2 || b.count < 2)
+        return result;
+
+    double va = a.stddev * a.stddev / a.count;
+    double vb = b.stddev * b.stddev / b.count;
+    double se2 = va + vb;
+    if (se2 <= 0.0)
+        return result;
+
+    result.valid = true;
+    result.t = (b.mean - a.mean) / std::sqrt(se2);
+    result.df = (se2 * se2) / ((va * va) / (a.count - 1) + (vb * vb) / (b.count - 1));
+    // Two-sided p-value of the Student t distribution with df degrees of freedom.
+    result.p = detail::incomplete_beta(result.df / 2.0, 0.5,
+                                       result.df / (result.df + result.t * result.t));
+    return result;
+}
+
+} // namespace test
+
+#endif // GUDOKU_BENCHMARK_BENCH_STATS_H
@@ -42,8 +42,12 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>      // For std::memset()
+#include <string>
 #include <vector>
 #include <bitset>
+#include <memory>       // For std::unique_ptr<T>
+#include <random>       // For std::mt19937
+#include <algorithm>    // For std::shuffle()
 
 #include <atomic>
 #include <thread>
@@ -51,19 +55,55 @@
 
 #include "gudoku/StopWatch.h"
 #include "gudoku/CPUWarmUp.h"
+#include "gudoku/PerfCounters.h"
+#include "gudoku/CPUAffinity.h"
+#include "gudoku/version.h"
 
 #include "gudoku/gudoku.h"
 #include "gudoku/BitUtils.h"
 
 #include "gudoku/DpllTriadSimdSolver.h"
+#include "gudoku/JczBitboardSolver.h"
+#include "gudoku/HybridSolver.h"
+#include "gudoku/BitSliceSolver.h"
+#include "gudoku/InterleavedDpllSolver.h"
+#include "gudoku/PortfolioSolver.h"
+#include "gudoku/HexadokuSimdSolver.h"
+#include "gudoku/MiniSudokuSolver.h"
+#include "gudoku/KillerSudokuSolver.h"
+#include "gudoku/SudokuVerifier.h"
 
 #include "gudoku/TestCase.h"
 
+#include "SolverRegistry.h"
+#include "BenchStats.h"
+#include "BenchReport.h"
+
 using namespace gudoku;
 
 static std::vector<Board> bm_puzzles;
 static size_t bm_puzzleTotal = 0;
 
+// Count the hardware events of the solve loops (--perf, Linux only).
+static bool bm_use_perf = false;
+
+// Check the solutions of the 9x9 puzzles after the solve loop (--verify).
+static bool bm_verify = false;
+
+// The reproducible runs: pin to a CPU, repeat, shuffle the puzzle order, and save the samples.
+struct BenchOptions {
+    int          cpu;               // --pin=<cpu>, -1: don't pin
+    int          repetitions;       // --repeat=N
+    long         shuffle_seed;      // --shuffle[=seed], -1: keep the file order
+    const char * json_file;         // --json=<file>
+    const char * csv_file;          // --csv=<file>
+
+    BenchOptions() : cpu(-1), repetitions(1), shuffle_seed(-1),
+                     json_file(nullptr), csv_file(nullptr) {}
+};
+
+static BenchOptions bm_options;
+
 // Index: [0 - 4]
 #define TEST_CASE_INDEX         4
 
@@ -179,6 +219,124 @@ size_t load_sudoku_puzzles(const char * filename, std::vector<Board> & puzzles)
     return puzzleCount;
 }
 
+//
+// The cells of a 4x4, 6x6 or 16x16 puzzle line: '0' - '9', 'A' - 'F', and '.' or '-' for
+// an empty cell, up to the size of the board.
+//
+template <typename BoardT>
+size_t read_grid_board(BoardT & board, const std::string & line)
+{
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || line[first] == '#' ||
+        (line[first] == '/' && first + 1 < line.size() && line[first + 1] == '/')) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    for (size_t i = first; i < line.size() && pos < sizeof(board.cells); i++) {
+        char val = line[i];
+        if (HexBoard::digitOf(val) >= 0)
+            board.cells[pos++] = val;
+        else if (val == '.' || val == '-')
+            board.cells[pos++] = '.';
+    }
+    return pos;
+}
+
+// A killer puzzle line: 81 cage ids, ':' and the sums (see KillerSudokuSolver.h).
+bool is_killer_line(const std::string & line)
+{
+    return (line.size() > Sudoku::BoardSize && line[Sudoku::BoardSize] == ':' && line[0] != '#');
+}
+
+size_t read_killer_board(KillerBoard & board, const std::string & line)
+{
+    if (!is_killer_line(line) || line.size() >= sizeof(board.cells))
+        return 0;
+    std::memcpy(&board.cells[0], line.c_str(), line.size() + 1);
+    return Sudoku::BoardSize;
+}
+
+//
+// The grid of the first puzzle of the file: 16 cells a line is 4x4, 36 is 6x6, 256 is 16x16,
+// and 81 cage ids with the sums is a killer puzzle.
+//
+struct GridSize {
+    enum {
+        Sudoku9x9,
+        Sudoku4x4,
+        Sudoku6x6,
+        Hexadoku,
+        Killer
+    };
+};
+
+int grid_size_of_file(const char * filename)
+{
+    std::ifstream ifs(filename, std::ios::in);
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (is_killer_line(line))
+            return GridSize::Killer;
+        HexBoard board;
+        size_t num_grids = read_grid_board(board, line);
+        if (num_grids >= HexBoard::kBoardSize)
+            return GridSize::Hexadoku;
+        else if (num_grids == Sudoku4x4::BoardSize)
+            return GridSize::Sudoku4x4;
+        else if (num_grids == Sudoku6x6::BoardSize)
+            return GridSize::Sudoku6x6;
+        else if (num_grids != 0)
+            break;
+    }
+    return GridSize::Sudoku9x9;
+}
+
+template <typename BoardT>
+size_t load_grid_puzzles(const char * filename, const char * grid_name, std::vector<BoardT> & puzzles)
+{
+    std::ifstream ifs(filename, std::ios::in);
+    if (!ifs.good())
+        return 0;
+
+    std::cout << "------------------------------------------" << std::endl << std::endl;
+    std::cout << "File name: " << filename << " (" << grid_name << ")" << std::endl << std::endl;
+
+    puzzles.clear();
+    std::string line;
+    while (std::getline(ifs, line)) {
+        BoardT board;
+        board.clear();
+        if (read_grid_board(board, line) >= sizeof(board.cells))
+            puzzles.push_back(board);
+    }
+
+    std::cout << "------------------------------------------" << std::endl << std::endl;
+    return puzzles.size();
+}
+
+size_t load_killer_puzzles(const char * filename, std::vector<KillerBoard> & puzzles)
+{
+    std::ifstream ifs(filename, std::ios::in);
+    if (!ifs.good())
+        return 0;
+
+    std::cout << "------------------------------------------" << std::endl << std::endl;
+    std::cout << "File name: " << filename << " (killer)" << std::endl << std::endl;
+
+    puzzles.clear();
+    std::string line;
+    while (std::getline(ifs, line)) {
+        KillerBoard board;
+        board.clear();
+        if (read_killer_board(board, line) != 0)
+            puzzles.push_back(board);
+    }
+
+    std::cout << "------------------------------------------" << std::endl << std::endl;
+    return puzzles.size();
+}
+
 template <typename Slover>
 void run_solver_testcase(size_t index)
 {
@@ -213,11 +371,91 @@ void run_a_testcase(size_t index)
     printf("------------------------------------------\n\n");
 }
 
-template <typename Solver, int LimitSolutions>
-void run_sudoku_test(std::vector<Board> & puzzles, size_t puzzleTotal, const char * name)
+struct BenchResult {
+    const char *        name;
+    size_t              puzzles;
+    size_t              guesses;
+    double              elapsed_time;   // Millisecond(s), of all the repetitions
+    bool                has_perf;
+    double              ipc;
+    double              branch_miss_rate;
+    std::vector<double> samples;        // usec/puzzle of every repetition
+
+    BenchResult() : name(""), puzzles(0), guesses(0), elapsed_time(0.0),
+                    has_perf(false), ipc(0.0), branch_miss_rate(0.0) {}
+};
+
+static inline double perf_ratio(uint64_t num, uint64_t den)
+{
+    return (den != 0) ? ((double)num / den) : 0.0;
+}
+
+void print_perf_counters(const test::PerfCounters & counters, size_t puzzleCount)
+{
+    printf("Perf counters, per puzzle:\n\n");
+    for (int event = 0; event < test::PerfCounters::MaxEvent; event++) {
+        if (counters.available(event)) {
+            printf("  %-16s  %12.1f%s\n", test::PerfCounters::name(event),
+                   perf_ratio(counters.value(event), puzzleCount),
+                   counters.scaled(event) ? "  (multiplexed, scaled)" : "");
+        }
+        else {
+            printf("  %-16s  %12s\n", test::PerfCounters::name(event), "n/a");
+        }
+    }
+    printf("\n");
+
+    if (counters.available(test::PerfCounters::Cycles) &&
+        counters.available(test::PerfCounters::Instructions)) {
+        printf("  IPC: %0.2f", perf_ratio(counters.value(test::PerfCounters::Instructions),
+                                         counters.value(test::PerfCounters::Cycles)));
+    }
+    if (counters.available(test::PerfCounters::Branches) &&
+        counters.available(test::PerfCounters::BranchMisses)) {
+        printf("  branch-miss rate: %0.2f %%",
+               100.0 * perf_ratio(counters.value(test::PerfCounters::BranchMisses),
+                                  counters.value(test::PerfCounters::Branches)));
+    }
+    printf("\n\n");
+}
+
+//
+// The solutions checked by --verify: the 9x9 ones only (the 16x16, killer and mini boards
+// are not checked).
+//
+template <typename BoardT>
+struct SolutionVerifier {
+    static const bool kEnabled = false;
+
+    static size_t verify(const BoardT * puzzles, const BoardT * solutions, size_t count, uint8_t * valid) {
+        return 0;
+    }
+};
+
+template <>
+struct SolutionVerifier<Board> {
+    static const bool kEnabled = true;
+
+    static size_t verify(const Board * puzzles, const Board * solutions, size_t count, uint8_t * valid) {
+        return SudokuVerifier::verifyBatch(&puzzles[0].cells[0], sizeof(Board),
+                                           &solutions[0].cells[0], sizeof(Board), count, valid);
+    }
+};
+
+//
+// One repetition of a solver over the puzzles. The first one prints the details, the
+// others a line each.
+//
+template <int LimitSolutions, typename BoardT>
+void run_sudoku_test(std::vector<BoardT> & puzzles, size_t puzzleTotal,
+                     const test::SolverInfo & info, BenchResult & result, int repetition)
 {
     //printf("------------------------------------------\n\n");
-    printf("gudoku: %s\n\n", name);
+    bool verbose = (repetition == 0);
+    if (verbose)
+        printf("gudoku: %s (%s)\n\n", info.name, info.description);
+
+    static const int kSolutionMode = (LimitSolutions == 1) ? 1: 0;
 
     size_t total_guesses = 0;
     size_t total_no_guess = 0;
@@ -228,40 +466,88 @@ void run_sudoku_test(std::vector<Board> & puzzles, size_t puzzleTotal, const cha
     size_t puzzleMultiSolution = 0;
     double total_time = 0.0;
 
-    Solver solver;
+    std::unique_ptr<test::BenchSolver> solver(info.create(kSolutionMode));
 
-    Board solution;
+    BoardT solution;
     solution.clear();
 
+    // With --verify, the first repetition keeps every solution, to check them after the loop.
+    bool verify = bm_verify && verbose && (kSolutionMode == 1) && SolutionVerifier<BoardT>::kEnabled;
+    std::vector<BoardT> solutions(verify ? puzzleTotal : 0);
+    std::vector<uint8_t> solved(verify ? puzzleTotal : 0);
+
+    size_t batch_size = solver->batch_size();
+    std::vector<BoardT> batch_answers((batch_size > 1 && !verify) ? batch_size : 0);
+    std::vector<size_t> batch_solutions(batch_size), batch_guesses(batch_size);
+
+    test::PerfCounters counters;
+    // Only the first repetition is counted.
+    bool has_perf = bm_use_perf && verbose && counters.open();
+
     test::StopWatch sw;
+    if (has_perf)
+        counters.start();
     sw.start();
 
-    for (size_t i = 0; i < puzzleTotal; i++) {
-        Board & board = puzzles[i];
-        size_t solutions = solver.solve(&board.cells[0], &solution.cells[0], LimitSolutions);
-        if (solutions == 1) {
-            size_t num_guesses = solver.get_num_guesses();
+    auto count_result = [&](size_t i, size_t num_solutions, size_t num_guesses) {
+        if (verify)
+            solved[i] = (uint8_t)(num_solutions == 1);
+        if (num_solutions == 1) {
             total_guesses += num_guesses;
             total_no_guess += (num_guesses == 0);
 
             puzzleSolved++;
         }
-        else if (solutions > 1) {
+        else if (num_solutions > 1) {
             puzzleMultiSolution++;
         }
         else {
             puzzleInvalid++;
         }
         puzzleCount++;
+    };
+
+    if (batch_size > 1) {
+        // The batch engines take batch_size puzzles a call.
+        for (size_t first = 0; first < puzzleTotal; first += batch_size) {
+            size_t count = (std::min)(batch_size, puzzleTotal - first);
+            BoardT * answers = verify ? &solutions[first] : &batch_answers[0];
+            solver->solveBatch(&puzzles[first].cells[0], sizeof(BoardT),
+                               &answers[0].cells[0], sizeof(BoardT), count, LimitSolutions,
+                               &batch_solutions[0], &batch_guesses[0]);
+            for (size_t i = 0; i < count; i++) {
+                count_result(first + i, batch_solutions[i], batch_guesses[i]);
+            }
+        }
+    }
+    else {
+        for (size_t i = 0; i < puzzleTotal; i++) {
+            BoardT & board = puzzles[i];
+            BoardT & answer = verify ? solutions[i] : solution;
+            size_t num_solutions = solver->solve(&board.cells[0], &answer.cells[0], LimitSolutions);
+            count_result(i, num_solutions, (num_solutions == 1) ? solver->get_num_guesses() : 0);
 #ifdef _DEBUG
-        if (puzzleCount > 100000)
-            break;
+            if (puzzleCount > 100000)
+                break;
 #endif
+        }
     }
 
     sw.stop();
+    if (has_perf)
+        counters.stop();
     total_time = sw.getElapsedMillisec();
 
+    result.name = info.name;
+    result.elapsed_time += total_time;
+    result.samples.push_back((puzzleCount != 0) ? (total_time * 1000.0 / puzzleCount) : 0.0);
+
+    if (!verbose) {
+        printf("  %-16s  repetition %3d: %0.3f ms, %0.2f usec/puzzle\n",
+               info.name, repetition + 1, total_time, result.samples.back());
+        return;
+    }
+
     double no_guess_percent = calc_percent(total_no_guess, puzzleCount);
 
     printf("Total puzzle(s): %u / (%u solved, %u invalid, %u multi-solution).\n\n"
@@ -281,43 +567,519 @@ void run_sudoku_test(std::vector<Board> & puzzles, size_t puzzleTotal, const cha
                puzzleCount / (total_time / 1000.0));
     }
 
+    if (verify) {
+        std::vector<uint8_t> valid(puzzleCount);
+        test::StopWatch verify_sw;
+        verify_sw.start();
+        SolutionVerifier<BoardT>::verify(&puzzles[0], &solutions[0], puzzleCount, &valid[0]);
+        verify_sw.stop();
+        double verify_time = verify_sw.getElapsedMillisec();
+
+        size_t puzzleWrong = 0;
+        for (size_t i = 0; i < puzzleCount; i++) {
+            puzzleWrong += (solved[i] && !valid[i]);
+        }
+        printf("Verified %u solution(s): %u wrong, %0.3f ms, %0.1f nsec/solution\n\n",
+               (uint32_t)puzzleSolved, (uint32_t)puzzleWrong, verify_time,
+               (puzzleCount != 0) ? (verify_time * 1000000.0 / puzzleCount) : 0.0);
+    }
+
+    if (has_perf) {
+        print_perf_counters(counters, puzzleCount);
+    }
+    else if (bm_use_perf) {
+        printf("Perf counters: unavailable (no perf_event_open(), or kernel.perf_event_paranoid is too high)\n\n");
+    }
+
     printf("------------------------------------------\n\n");
+
+    result.puzzles = puzzleCount;
+    result.guesses = total_guesses;
+    result.has_perf = has_perf &&
+                      counters.available(test::PerfCounters::Cycles) &&
+                      counters.available(test::PerfCounters::Instructions) &&
+                      counters.available(test::PerfCounters::Branches) &&
+                      counters.available(test::PerfCounters::BranchMisses);
+    result.ipc = perf_ratio(counters.value(test::PerfCounters::Instructions),
+                            counters.value(test::PerfCounters::Cycles));
+    result.branch_miss_rate = perf_ratio(counters.value(test::PerfCounters::BranchMisses),
+                                         counters.value(test::PerfCounters::Branches));
+}
+
+//
+// The side-by-side table of all the solvers run, the speed relative to the first one.
+// With --repeat, usec/puzzle is the mean of the repetitions, followed by their median,
+// standard deviation and minimum.
+//
+void print_benchmark_table(const std::vector<BenchResult> & results)
+{
+    if (results.empty())
+        return;
+
+    // The IPC and branch-miss columns only with --perf, the statistics only with --repeat.
+    bool has_perf = false;
+    bool has_stats = false;
+    for (size_t i = 0; i < results.size(); i++) {
+        has_perf |= results[i].has_perf;
+        has_stats |= (results[i].samples.size() > 1);
+    }
+
+    printf("  %-16s  %12s", "Solver", "usec/puzzle");
+    if (has_stats)
+        printf("  %8s  %8s  %8s", "median", "stddev", "min");
+    printf("  %15s  %14s  %8s", "guesses/puzzle", "puzzles/sec", "speed");
+    if (has_perf)
+        printf("  %6s  %10s", "IPC", "br-miss %");
+    printf("\n");
+    printf("  ----------------  ------------");
+    if (has_stats)
+        printf("  --------  --------  --------");
+    printf("  ---------------  --------------  --------");
+    if (has_perf)
+        printf("  ------  ----------");
+    printf("\n");
+
+    double base_usec = test::SampleStats(results[0].samples).mean;
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult & result = results[i];
+        test::SampleStats stats(result.samples);
+        if (result.puzzles != 0 && stats.mean > 0.0) {
+            printf("  %-16s  %12.2f", result.name, stats.mean);
+            if (has_stats)
+                printf("  %8.2f  %8.3f  %8.2f", stats.median, stats.stddev, stats.min);
+            printf("  %15.2f  %14.1f  %7.2fx",
+                   (double)result.guesses / result.puzzles,
+                   1000000.0 / stats.mean,
+                   base_usec / stats.mean);
+        }
+        else {
+            printf("  %-16s  %12s", result.name, "NaN");
+            if (has_stats)
+                printf("  %8s  %8s  %8s", "NaN", "NaN", "NaN");
+            printf("  %15s  %14s  %8s", "NaN", "NaN", "NaN");
+        }
+        if (has_perf) {
+            if (result.has_perf)
+                printf("  %6.2f  %10.2f", result.ipc, result.branch_miss_rate * 100.0);
+            else
+                printf("  %6s  %10s", "n/a", "n/a");
+        }
+        printf("\n");
+    }
+    printf("\n------------------------------------------\n\n");
+}
+
+void save_benchmark_report(const char * filename, size_t puzzleTotal, int limit_solutions,
+                           const std::vector<BenchResult> & results)
+{
+    test::BenchReport report;
+    report.version      = GUDOKU_VERSION_STRING;
+    report.host         = test::host_name();
+    report.compiler     = test::compiler_name();
+    report.timestamp    = test::utc_timestamp();
+    report.dataset      = filename;
+    report.puzzles      = puzzleTotal;
+    report.limit        = limit_solutions;
+    report.repetitions  = bm_options.repetitions;
+    report.cpu          = bm_options.cpu;
+    report.shuffle_seed = bm_options.shuffle_seed;
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult & result = results[i];
+        test::SolverReport solver;
+        solver.name = result.name;
+        solver.samples = result.samples;
+        solver.guesses_per_puzzle = (result.puzzles != 0) ? ((double)result.guesses / result.puzzles) : 0.0;
+        solver.has_perf = result.has_perf;
+        solver.ipc = result.ipc;
+        solver.branch_miss_rate = result.branch_miss_rate;
+        report.solvers.push_back(solver);
+    }
+
+    if (bm_options.json_file != nullptr) {
+        if (test::write_json(report, bm_options.json_file))
+            printf("Results saved to: %s\n\n", bm_options.json_file);
+        else
+            printf("Can't write the results to: %s\n\n", bm_options.json_file);
+    }
+    if (bm_options.csv_file != nullptr) {
+        if (test::write_csv(report, bm_options.csv_file))
+            printf("Results saved to: %s\n\n", bm_options.csv_file);
+        else
+            printf("Can't write the results to: %s\n\n", bm_options.csv_file);
+    }
+}
+
+//
+// Compare the solvers of two saved runs (JSON or CSV), with Welch's t-test on their
+// repetitions. A change is only called faster or slower if p < 0.05.
+//
+int compare_benchmark_reports(const char * old_file, const char * new_file)
+{
+    static const double kAlpha = 0.05;
+
+    test::BenchReport old_report, new_report;
+    std::string error;
+    if (!test::read_report(old_file, old_report, error)) {
+        printf("Can't read %s: %s\n\n", old_file, error.c_str());
+        return 1;
+    }
+    if (!test::read_report(new_file, new_report, error)) {
+        printf("Can't read %s: %s\n\n", new_file, error.c_str());
+        return 1;
+    }
+
+    printf("old: %s  (%s, %s, %s)\n", old_file, old_report.dataset.c_str(),
+           old_report.host.c_str(), old_report.timestamp.c_str());
+    printf("new: %s  (%s, %s, %s)\n\n", new_file, new_report.dataset.c_str(),
+           new_report.host.c_str(), new_report.timestamp.c_str());
+    if (old_report.dataset != new_report.dataset || old_report.puzzles != new_report.puzzles) {
+        printf("Warning: the two runs are over different puzzles.\n\n");
+    }
+    if (old_report.host != new_report.host) {
+        printf("Warning: the two runs are from different hosts.\n\n");
+    }
+
+    printf("  %-16s  %10s  %10s  %9s  %8s  %7s  %8s  %s\n",
+           "Solver", "old usec", "new usec", "delta", "t", "df", "p", "verdict");
+    printf("  ----------------  ----------  ----------  ---------  --------  -------  --------  "
+           "--------------------\n");
+
+    size_t compared = 0;
+    for (size_t i = 0; i < new_report.solvers.size(); i++) {
+        const test::SolverReport & new_solver = new_report.solvers[i];
+        const test::SolverReport * old_solver = old_report.find(new_solver.name);
+        if (old_solver == nullptr)
+            continue;
+
+        test::SampleStats old_stats(old_solver->samples);
+        test::SampleStats new_stats(new_solver.samples);
+        test::TTestResult ttest = test::welch_t_test(old_stats, new_stats);
+        double delta = (old_stats.mean > 0.0) ? ((new_stats.mean - old_stats.mean) / old_stats.mean * 100.0) : 0.0;
+
+        printf("  %-16s  %10.3f  %10.3f  %+8.2f%%", new_solver.name.c_str(),
+               old_stats.mean, new_stats.mean, delta);
+        if (ttest.valid) {
+            const char * verdict = "no significant change";
+            if (ttest.p < kAlpha)
+                verdict = (ttest.t < 0.0) ? "faster" : "slower";
+            printf("  %8.3f  %7.1f  %8.4f  %s\n", ttest.t, ttest.df, ttest.p, verdict);
+        }
+        else {
+            printf("  %8s  %7s  %8s  %s\n", "n/a", "n/a", "n/a", "n/a (needs --repeat >= 2)");
+        }
+        compared++;
+    }
+    printf("\n");
+
+    if (compared == 0) {
+        printf("No solver in common.\n\n");
+        return 1;
+    }
+    return 0;
+}
+
+// BitSliceSolver on 256 puzzles a batch (a BitVec16x16 slice).
+template <int kSolutionMode>
+using BitSliceSolver256 = BitSliceSolver<kSolutionMode, BitVec16x16>;
+
+// DpllTriadSimdSolver with failed-literal probing before every branch.
+template <int kSolutionMode>
+class DpllProbingSolver : public DpllTriadSimdSolver<kSolutionMode> {
+public:
+    DpllProbingSolver() {
+        this->set_probing(true);
+    }
+};
+
+// InterleavedDpllSolver with the searches of 4 puzzles interleaved.
+template <int kSolutionMode>
+using InterleavedDpllSolver4 = InterleavedDpllSolver<kSolutionMode, 4>;
+
+void register_solvers(test::SolverRegistry & registry)
+{
+    test::register_dpll_sse(registry);
+    test::register_dpll_avx2(registry);
+    test::register_dpll_avx512(registry);
+
+    registry.add<DpllProbingSolver>("dpll-probe", "DpllTriadSimdSolver, failed-literal probing before every branch");
+    registry.add<PortfolioSolver>("dpll-portfolio", "PortfolioSolver, randomized DpllTriadSimdSolver configurations racing with Luby restarts");
+    registry.add<JczBitboardSolver>("jcz", "JczBitboardSolver, JCZSolve-style bitboards (BitVec08x16)");
+    registry.add<HybridSolver>("hybrid", "HybridSolver, JczBitboardSolver or DpllTriadSimdSolver by puzzle class");
+    registry.addBatch<BitSliceSolver256>("bitslice", "BitSliceSolver, bit-sliced singles of 256 puzzles, then DpllTriadSimdSolver");
+    registry.addBatch<InterleavedDpllSolver4>("dpll-amac", "InterleavedDpllSolver, the searches of 4 puzzles interleaved on one core");
+}
+
+// The variant solvers, built for the native ISA of this translation unit.
+void register_variant_solvers(test::SolverRegistry & registry_x, test::SolverRegistry & registry_windoku)
+{
+    registry_x.add<DpllSudokuXSolver>("dpll-x", "DpllTriadSimdSolver<SudokuX>, the two diagonals as extra units");
+    registry_windoku.add<DpllWindokuSolver>("dpll-windoku", "DpllTriadSimdSolver<Windoku>, the four windows as extra units");
+}
+
+void register_killer_solvers(test::SolverRegistry & registry)
+{
+    registry.add<KillerSudokuSolver>("killer", "KillerSudokuSolver, (size, sum) cage tables on the DpllTriadSimdSolver state");
+}
+
+// HexadokuSimdSolver on the two halves of BitVec16x16_SSE, and on BitVec16x16_AVX.
+template <int kSolutionMode>
+using HexadokuSimdSolverSSE = HexadokuSimdSolver<kSolutionMode, BitVec16x16_SSE>;
+
+#if defined(__AVX2__) || defined(__AVX512VL__) || defined(__AVX512F__)
+template <int kSolutionMode>
+using HexadokuSimdSolverAVX2 = HexadokuSimdSolver<kSolutionMode, BitVec16x16_AVX>;
+#endif
+
+void register_hexadoku_solvers(test::SolverRegistry & registry)
+{
+    registry.add<HexadokuSimdSolverSSE>("hex-sse", "HexadokuSimdSolver, 16x16 rows as BitVec16x16_SSE (2 x 128 bit)");
+#if defined(__AVX2__) || defined(__AVX512VL__) || defined(__AVX512F__)
+    registry.add<HexadokuSimdSolverAVX2>("hex-avx2", "HexadokuSimdSolver, 16x16 rows as BitVec16x16_AVX (256 bit)");
+#endif
+}
+
+void register_mini_solvers(test::SolverRegistry & registry4x4, test::SolverRegistry & registry6x6)
+{
+    registry4x4.add<Mini4x4Solver>("mini4x4", "MiniSudokuSolver<Sudoku4x4>, the grid in 1 x BitVec08x16");
+    registry6x6.add<Mini6x6Solver>("mini6x6", "MiniSudokuSolver<Sudoku6x6>, a band per BitVec08x16 (3 x 128 bit)");
+}
+
+void list_solvers(const test::SolverRegistry & registry, const char * title = "Registered solvers")
+{
+    printf("%s:\n\n", title);
+    for (size_t i = 0; i < registry.solvers().size(); i++) {
+        const test::SolverInfo & info = registry.solvers()[i];
+        printf("  %-16s  %s\n", info.name, info.description);
+    }
+    printf("\n");
+}
+
+template <int LimitSolutions, typename BoardT>
+void run_benchmark(const char * filename, const std::vector<BoardT> & all_puzzles, size_t puzzleTotal,
+                   const std::vector<const test::SolverInfo *> & solvers)
+{
+    if (bm_options.cpu >= 0) {
+        if (test::CPU::pin_thread(bm_options.cpu))
+            printf("Pinned to CPU %d.\n\n", bm_options.cpu);
+        else
+            printf("Can't pin to CPU %d, running unpinned.\n\n", bm_options.cpu);
+    }
+
+    test::CPU::WarmUp cpuWarmUp(1000);
+
+    //
+    // The repetitions are the outer loop, so a slow drift of the machine (the clock, the
+    // other load) is spread over all the solvers. With --shuffle, every repetition has its
+    // own order of the puzzles, the same for all the solvers.
+    //
+    std::vector<BoardT> puzzles(all_puzzles.begin(), all_puzzles.begin() + puzzleTotal);
+    std::vector<BenchResult> results(solvers.size());
+    for (int rep = 0; rep < bm_options.repetitions; rep++) {
+        if (bm_options.shuffle_seed >= 0) {
+            std::mt19937 rng((uint32_t)(bm_options.shuffle_seed + rep));
+            puzzles.assign(all_puzzles.begin(), all_puzzles.begin() + puzzleTotal);
+            std::shuffle(puzzles.begin(), puzzles.end(), rng);
+        }
+        for (size_t i = 0; i < solvers.size(); i++) {
+            run_sudoku_test<LimitSolutions>(puzzles, puzzleTotal, *solvers[i], results[i], rep);
+        }
+        if (rep > 0 && solvers.size() > 1)
+            printf("\n");
+    }
+    if (bm_options.repetitions > 1 && solvers.size() <= 1)
+        printf("\n");
+
+    print_benchmark_table(results);
+
+    save_benchmark_report(filename, puzzleTotal, LimitSolutions, results);
 }
 
 template <int LimitSolutions = 1>
-void run_all_benchmark(const char * filename)
+void run_all_benchmark(const char * filename, const std::vector<const test::SolverInfo *> & solvers)
 {
     // Read the puzzles data
     bm_puzzleTotal = load_sudoku_puzzles(filename, bm_puzzles);
 
-    test::CPU::WarmUp cpuWarmUp(1000);
+    run_benchmark<LimitSolutions>(filename, bm_puzzles, bm_puzzleTotal, solvers);
+}
 
-    static const int kSolutionMode = (LimitSolutions == 1) ? 1: 0;
+// The 4x4, 6x6 and 16x16 puzzles.
+template <int LimitSolutions, typename BoardT>
+void run_grid_benchmark(const char * filename, const char * grid_name,
+                        const std::vector<const test::SolverInfo *> & solvers)
+{
+    std::vector<BoardT> puzzles;
+    size_t puzzleTotal = load_grid_puzzles(filename, grid_name, puzzles);
 
-#if !defined(_DEBUG)
-    run_sudoku_test<DpllTriadSimdSolver<kSolutionMode>, LimitSolutions>(bm_puzzles, bm_puzzleTotal, "DpllTriadSimdSolver");
-#else
-    run_sudoku_test<DpllTriadSimdSolver<kSolutionMode>, LimitSolutions>(bm_puzzles, bm_puzzleTotal, "DpllTriadSimdSolver");
-#endif
+    run_benchmark<LimitSolutions>(filename, puzzles, puzzleTotal, solvers);
+}
+
+template <int LimitSolutions>
+void run_killer_benchmark(const char * filename, const std::vector<const test::SolverInfo *> & solvers)
+{
+    std::vector<KillerBoard> puzzles;
+    size_t puzzleTotal = load_killer_puzzles(filename, puzzles);
+
+    run_benchmark<LimitSolutions>(filename, puzzles, puzzleTotal, solvers);
+}
+
+template <int LimitSolutions>
+void run_file_benchmark(const char * filename, int grid_size,
+                        const std::vector<const test::SolverInfo *> & solvers)
+{
+    switch (grid_size) {
+        case GridSize::Killer:
+            run_killer_benchmark<LimitSolutions>(filename, solvers);
+            break;
+        case GridSize::Hexadoku:
+            run_grid_benchmark<LimitSolutions, HexBoard>(filename, "16x16", solvers);
+            break;
+        case GridSize::Sudoku4x4:
+            run_grid_benchmark<LimitSolutions, Sudoku4x4::board_type>(filename, "4x4", solvers);
+            break;
+        case GridSize::Sudoku6x6:
+            run_grid_benchmark<LimitSolutions, Sudoku6x6::board_type>(filename, "6x6", solvers);
+            break;
+        default:
+            run_all_benchmark<LimitSolutions>(filename, solvers);
+            break;
+    }
 }
 
+//
+// Usage: benchmark [options] [puzzles_file [limit_solutions]]
+//
+//   A file of 16x16 puzzles (256 cells a line) runs the 16x16 solvers, one of 4x4 or 6x6
+//   puzzles (16 or 36 cells a line) the mini solvers, one of killer puzzles (81 cage ids,
+//   ':' and the sums) the killer solver.
+//
+//   --variant=x|windoku        the 9x9 puzzles are Sudoku-X or windoku puzzles, run the
+//                              solvers of the variant
+//   --solvers=name1,name2,...  run these solvers, in this order (default: all)
+//   --list                     list the registered solvers
+//   --perf                     count cycles, instructions, branch misses, L1D misses and
+//                              uops of every solve loop (Linux perf_event_open)
+//   --verify                   check the solutions of the 9x9 puzzles (the grid and the
+//                              givens) after the solve loop of the first repetition
+//   --pin=<cpu>                pin the benchmark to this logical CPU
+//   --repeat=N                 run every solver N times, report mean/median/stddev/min
+//   --shuffle[=seed]           shuffle the puzzle order of every repetition (seed: 1)
+//   --json=<file>              save the results as JSON
+//   --csv=<file>               save the results as CSV
+//
+// Usage: benchmark --compare old_results new_results
+//
+//   compare two saved runs (JSON or CSV), solver by solver, with Welch's t-test
+//
 int main(int argc, char * argv[])
 {
     const char * filename = nullptr;
     const char * out_file = nullptr;
+    const char * solver_names = nullptr;
+    bool list_only = false;
+    bool compare = false;
     int limit_solution = 0;
+    int variant = SudokuVariant::Vanilla;
     UNUSED_VARIABLE(out_file);
-    if (argc > 3) {
-        filename = argv[1];
-        limit_solution = atoi(argv[2]);
-        out_file = argv[3];
+
+    std::vector<char *> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--solvers=", 10) == 0)
+            solver_names = argv[i] + 10;
+        else if (std::strcmp(argv[i], "--list") == 0)
+            list_only = true;
+        else if (std::strcmp(argv[i], "--perf") == 0)
+            bm_use_perf = true;
+        else if (std::strcmp(argv[i], "--verify") == 0)
+            bm_verify = true;
+        else if (std::strncmp(argv[i], "--pin=", 6) == 0)
+            bm_options.cpu = atoi(argv[i] + 6);
+        else if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            bm_options.repetitions = (std::max)(atoi(argv[i] + 9), 1);
+        else if (std::strcmp(argv[i], "--shuffle") == 0)
+            bm_options.shuffle_seed = 1;
+        else if (std::strncmp(argv[i], "--shuffle=", 10) == 0)
+            bm_options.shuffle_seed = (std::max)(atol(argv[i] + 10), 0L);
+        else if (std::strncmp(argv[i], "--json=", 7) == 0)
+            bm_options.json_file = argv[i] + 7;
+        else if (std::strncmp(argv[i], "--csv=", 6) == 0)
+            bm_options.csv_file = argv[i] + 6;
+        else if (std::strncmp(argv[i], "--variant=", 10) == 0) {
+            variant = SudokuVariant::find(argv[i] + 10);
+            if (variant < 0) {
+                printf("Error: the variant must be x or windoku: %s\n\n", argv[i] + 10);
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--compare") == 0)
+            compare = true;
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (args.size() > 2) {
+        filename = args[0];
+        limit_solution = atoi(args[1]);
+        out_file = args[2];
+    }
+    else if (args.size() > 1) {
+        filename = args[0];
+        limit_solution = atoi(args[1]);
     }
-    else if (argc > 2) {
-        filename = argv[1];
-        limit_solution = atoi(argv[2]);
+    else if (args.size() > 0) {
+        filename = args[0];
     }
-    else if (argc > 1) {
-        filename = argv[1];
+
+    if (compare) {
+        if (args.size() != 2) {
+            printf("Usage: benchmark --compare old_results new_results\n\n");
+            return 1;
+        }
+        return compare_benchmark_reports(args[0], args[1]);
+    }
+
+    test::SolverRegistry sudoku_registry;
+    register_solvers(sudoku_registry);
+
+    test::SolverRegistry hexadoku_registry;
+    register_hexadoku_solvers(hexadoku_registry);
+
+    test::SolverRegistry mini4x4_registry, mini6x6_registry;
+    register_mini_solvers(mini4x4_registry, mini6x6_registry);
+
+    test::SolverRegistry sudoku_x_registry, windoku_registry;
+    register_variant_solvers(sudoku_x_registry, windoku_registry);
+
+    test::SolverRegistry killer_registry;
+    register_killer_solvers(killer_registry);
+
+    if (list_only) {
+        list_solvers(sudoku_registry);
+        list_solvers(sudoku_x_registry, "Registered Sudoku-X solvers");
+        list_solvers(windoku_registry, "Registered windoku solvers");
+        list_solvers(killer_registry, "Registered killer solvers");
+        list_solvers(hexadoku_registry, "Registered 16x16 solvers");
+        list_solvers(mini4x4_registry, "Registered 4x4 solvers");
+        list_solvers(mini6x6_registry, "Registered 6x6 solvers");
+        return 0;
+    }
+
+    int grid_size = (filename != nullptr) ? grid_size_of_file(filename) : (int)GridSize::Sudoku9x9;
+    const test::SolverRegistry & registry =
+        (grid_size == GridSize::Killer)    ? killer_registry :
+        (grid_size == GridSize::Hexadoku)  ? hexadoku_registry :
+        (grid_size == GridSize::Sudoku4x4) ? mini4x4_registry :
+        (grid_size == GridSize::Sudoku6x6) ? mini6x6_registry :
+        (variant == SudokuVariant::X)       ? sudoku_x_registry :
+        (variant == SudokuVariant::Windoku) ? windoku_registry : sudoku_registry;
+
+    std::vector<const test::SolverInfo *> solvers;
+    std::string unknown;
+    if (!registry.select(solver_names, solvers, unknown)) {
+        printf("Unknown solver: %s\n\n", unknown.c_str());
+        list_solvers(registry);
+        return 1;
     }
 
     if (1)
@@ -331,9 +1093,9 @@ int main(int argc, char * argv[])
     {
         if (filename != nullptr) {
             if (limit_solution <= 0 || limit_solution == 1)
-                run_all_benchmark<1>(filename);
+                run_file_benchmark<1>(filename, grid_size, solvers);
             else
-                run_all_benchmark<2>(filename);
+                run_file_benchmark<2>(filename, grid_size, solvers);
         }
     }
 
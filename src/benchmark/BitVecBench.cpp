@@ -0,0 +1,454 @@
+
+#if defined(_MSC_VER) && !defined(NDEBUG)
+#include <vld.h>
+#endif
+
+#if defined(_MSC_VER)
+#define __MMX__
+#define __SSE__
+#define __SSE2__
+#define __SSE3__
+#define __SSSE3__
+#define __SSE4A__
+#define __SSE4a__
+#define __SSE4_1__
+#define __SSE4_2__
+#define __POPCNT__
+#define __LZCNT__
+#define __AVX__
+#define __AVX2__
+#define __3dNOW__
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>     // For _ReadWriteBarrier()
+#endif
+
+#include "gudoku/StopWatch.h"
+#include "gudoku/CPUWarmUp.h"
+
+#include "gudoku/BitVec.h"
+
+using namespace gudoku;
+
+//
+// Latency and throughput of the BitVec.h primitives, op by op, for BitVec08x16,
+// BitVec16x16_SSE and (if the build targets AVX2) BitVec16x16_AVX.
+//
+// latency:    one dependent chain, every op takes the result of the previous one.
+// throughput: kStreams independent chains interleaved, so the out-of-order core can
+//             overlap them.
+//
+// Both are reported in ns/op and in cycles, estimated from the latency of a chain of
+// vector XORs (1 cycle on every x86 core with SSE2), so no cycle counter is needed.
+//
+// The ops returning a scalar (popcount(), minpos16(), isAllZeros()...) are chained through
+// a scalar round trip, x ^= full32(result). The "scalar round trip" row is the cost of
+// that alone, subtract it from their rows.
+//
+// Usage: bitvec_bench [iterations]
+//
+
+static const size_t kStreams = 8;
+
+//
+// Hide the value of a vector from the optimizer: no instruction is emitted, but the
+// compiler can neither fold the chain nor hoist an op out of the loop.
+//
+static inline void opaque(BitVec08x16 & x) {
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    __asm__ volatile ("" : "+x" (x.m128));
+#endif
+}
+
+static inline void opaque(BitVec16x16_SSE & x) {
+    opaque(x.low);
+    opaque(x.high);
+}
+
+#if defined(__AVX2__)
+static inline void opaque(BitVec16x16_AVX & x) {
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    __asm__ volatile ("" : "+x" (x.m256));
+#endif
+}
+#endif // __AVX2__
+
+template <typename BitVecT>
+struct VecTraits {
+};
+
+template <>
+struct VecTraits<BitVec08x16> {
+    static const size_t kLanes = 8;
+    static const char * name() { return "BitVec08x16"; }
+};
+
+template <>
+struct VecTraits<BitVec16x16_SSE> {
+    static const size_t kLanes = 16;
+    static const char * name() { return "BitVec16x16_SSE"; }
+};
+
+#if defined(__AVX2__)
+template <>
+struct VecTraits<BitVec16x16_AVX> {
+    static const size_t kLanes = 16;
+    static const char * name() { return "BitVec16x16_AVX"; }
+};
+#endif // __AVX2__
+
+//
+// The ops: run(x, y) is one op on x, y is a second operand where the op takes one.
+// kScalar ops return an uint32_t instead of a vector.
+//
+struct OpXor {
+    static const bool kScalar = false;
+    static const char * name() { return "operator ^"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return (x ^ y); }
+};
+
+struct OpAnd {
+    static const bool kScalar = false;
+    static const char * name() { return "operator &"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return (x & y); }
+};
+
+struct OpAndNot {
+    static const bool kScalar = false;
+    static const char * name() { return "and_not"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return x.and_not(y); }
+};
+
+struct OpXorYorZ {
+    static const bool kScalar = false;
+    static const char * name() { return "X_or_Y_or_Z"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) {
+        return BitVecT::X_or_Y_or_Z(x, y, y.rotateCols());
+    }
+};
+
+struct OpXandYorZ {
+    static const bool kScalar = false;
+    static const char * name() { return "X_and_Y_or_Z"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) {
+        return BitVecT::X_and_Y_or_Z(x, y, y.rotateCols());
+    }
+};
+
+struct OpWhichIsEqual {
+    static const bool kScalar = false;
+    static const char * name() { return "whichIsEqual"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return x.whichIsEqual(y); }
+};
+
+struct OpWhichIsNonZero {
+    static const bool kScalar = false;
+    static const char * name() { return "whichIsNonZero"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return x.whichIsNonZero(); }
+};
+
+struct OpShuffle {
+    static const bool kScalar = false;
+    static const char * name() { return "shuffle"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return x.shuffle(y); }
+};
+
+struct OpRotateRows {
+    static const bool kScalar = false;
+    static const char * name() { return "rotateRows"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return x.rotateRows(); }
+};
+
+struct OpRotateCols {
+    static const bool kScalar = false;
+    static const char * name() { return "rotateCols"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) { return x.rotateCols(); }
+};
+
+struct OpPopcount16 {
+    static const bool kScalar = false;
+    static const char * name() { return "popcount16<N, 9>"; }
+    template <typename BitVecT>
+    static inline BitVecT run(const BitVecT & x, const BitVecT & y) {
+        return x.template popcount16<VecTraits<BitVecT>::kLanes, 9>();
+    }
+};
+
+struct OpRoundTrip {
+    static const bool kScalar = true;
+    static const char * name() { return "scalar round trip"; }
+    template <typename BitVecT>
+    static inline uint32_t run(const BitVecT & x, const BitVecT & y) {
+        return (uint32_t)x.template extractU64<0>();
+    }
+};
+
+struct OpPopcount {
+    static const bool kScalar = true;
+    static const char * name() { return "popcount"; }
+    template <typename BitVecT>
+    static inline uint32_t run(const BitVecT & x, const BitVecT & y) { return (uint32_t)x.popcount(); }
+};
+
+struct OpIsAllZeros {
+    static const bool kScalar = true;
+    static const char * name() { return "isAllZeros"; }
+    template <typename BitVecT>
+    static inline uint32_t run(const BitVecT & x, const BitVecT & y) { return (uint32_t)x.isAllZeros(); }
+};
+
+struct OpHasIntersects {
+    static const bool kScalar = true;
+    static const char * name() { return "hasIntersects"; }
+    template <typename BitVecT>
+    static inline uint32_t run(const BitVecT & x, const BitVecT & y) { return (uint32_t)x.hasIntersects(y); }
+};
+
+struct OpMinPos16 {
+    static const bool kScalar = true;
+    static const char * name() { return "minpos16<N>"; }
+    template <typename BitVecT>
+    static inline uint32_t run(const BitVecT & x, const BitVecT & y) {
+        return x.template minpos16<VecTraits<BitVecT>::kLanes>();
+    }
+};
+
+struct OpMinPosGreaterThanOrEqual {
+    static const bool kScalar = true;
+    static const char * name() { return "minPosGreaterThanOrEqual<10>"; }
+    template <typename BitVecT>
+    static inline uint32_t run(const BitVecT & x, const BitVecT & y) {
+        return x.template minPosGreaterThanOrEqual<10>();
+    }
+};
+
+//
+// One step of a chain: the op itself, or the op and the scalar round trip back into x.
+//
+template <typename BitVecT, typename Op, bool kScalar = Op::kScalar>
+struct ChainStep {
+    static inline BitVecT step(const BitVecT & x, const BitVecT & y) {
+        return Op::run(x, y);
+    }
+};
+
+template <typename BitVecT, typename Op>
+struct ChainStep<BitVecT, Op, true> {
+    static inline BitVecT step(const BitVecT & x, const BitVecT & y) {
+        return (x ^ BitVecT::full32(Op::run(x, y)));
+    }
+};
+
+struct BenchResult {
+    double latency;         // ns/op
+    double throughput;      // ns/op
+};
+
+template <typename BitVecT>
+class BitVecBench {
+private:
+    BitVecT seeds_[kStreams];
+    BitVecT operand_;
+    size_t  iterations_;
+    double  ns_per_cycle_;
+    uint32_t checksum_;
+
+public:
+    BitVecBench(size_t iterations, double ns_per_cycle)
+        : iterations_(iterations), ns_per_cycle_(ns_per_cycle), checksum_(0) {
+        // Candidate masks of 9 bits, like in the solvers, all different.
+        alignas(32) uint16_t values[kStreams + 1][16];
+        for (size_t s = 0; s <= kStreams; s++) {
+            for (size_t i = 0; i < 16; i++) {
+                values[s][i] = (uint16_t)(((s + 1) * 0x9E37u + i * 0x61u) & 0x01FFu);
+            }
+        }
+        for (size_t s = 0; s < kStreams; s++) {
+            this->seeds_[s].loadAligned((const void *)&values[s][0]);
+        }
+        // The operand of shuffle() must be a valid byte shuffle control: swap the 16-bit
+        // halves of every 32-bit lane. The other binary ops don't mind its contents.
+        for (size_t i = 0; i < 16; i++) {
+            uint16_t lane = (uint16_t)(i ^ 1u) % 8;
+            values[kStreams][i] = (uint16_t)((lane * 2) | ((lane * 2 + 1) << 8));
+        }
+        this->operand_.loadAligned((const void *)&values[kStreams][0]);
+    }
+
+    uint32_t checksum() const { return this->checksum_; }
+
+    template <typename Op>
+    double latency() {
+        BitVecT x = this->seeds_[0];
+        BitVecT y = this->operand_;
+        double best_time = 0.0;
+        for (int round = 0; round < 3; round++) {
+            test::StopWatch sw;
+            sw.start();
+            for (size_t i = 0; i < this->iterations_; i++) {
+                x = ChainStep<BitVecT, Op>::step(x, y);
+                opaque(x);
+            }
+            sw.stop();
+            double elapsed_time = sw.getElapsedMillisec();
+            if (round == 0 || elapsed_time < best_time)
+                best_time = elapsed_time;
+        }
+        this->checksum_ += (uint32_t)x.template extractU64<0>();
+        return (best_time * 1000000.0 / this->iterations_);
+    }
+
+    template <typename Op>
+    double throughput() {
+        BitVecT x0 = this->seeds_[0], x1 = this->seeds_[1], x2 = this->seeds_[2], x3 = this->seeds_[3];
+        BitVecT x4 = this->seeds_[4], x5 = this->seeds_[5], x6 = this->seeds_[6], x7 = this->seeds_[7];
+        BitVecT y = this->operand_;
+        double best_time = 0.0;
+        for (int round = 0; round < 3; round++) {
+            test::StopWatch sw;
+            sw.start();
+            for (size_t i = 0; i < this->iterations_; i++) {
+                x0 = ChainStep<BitVecT, Op>::step(x0, y);
+                x1 = ChainStep<BitVecT, Op>::step(x1, y);
+                x2 = ChainStep<BitVecT, Op>::step(x2, y);
+                x3 = ChainStep<BitVecT, Op>::step(x3, y);
+                x4 = ChainStep<BitVecT, Op>::step(x4, y);
+                x5 = ChainStep<BitVecT, Op>::step(x5, y);
+                x6 = ChainStep<BitVecT, Op>::step(x6, y);
+                x7 = ChainStep<BitVecT, Op>::step(x7, y);
+                opaque(x0); opaque(x1); opaque(x2); opaque(x3);
+                opaque(x4); opaque(x5); opaque(x6); opaque(x7);
+            }
+            sw.stop();
+            double elapsed_time = sw.getElapsedMillisec();
+            if (round == 0 || elapsed_time < best_time)
+                best_time = elapsed_time;
+        }
+        BitVecT sum = x0 ^ x1 ^ x2 ^ x3 ^ x4 ^ x5 ^ x6 ^ x7;
+        this->checksum_ += (uint32_t)sum.template extractU64<0>();
+        return (best_time * 1000000.0 / (this->iterations_ * kStreams));
+    }
+
+    template <typename Op>
+    void run() {
+        double latency = this->latency<Op>();
+        double throughput = this->throughput<Op>();
+        printf("  %-30s  %8.3f ns  %6.2f cycles   %8.3f ns  %6.2f cycles\n",
+               Op::name(), latency, latency / this->ns_per_cycle_,
+               throughput, throughput / this->ns_per_cycle_);
+    }
+
+    void header() {
+        printf("%s:\n\n", VecTraits<BitVecT>::name());
+        printf("  %-30s  %26s   %26s\n", "op", "latency (dependent chain)", "throughput (8 streams)");
+        printf("  ------------------------------  --------------------------   --------------------------\n");
+    }
+
+    // The ops all the BitVec types have.
+    void run_common() {
+        this->run<OpXor>();
+        this->run<OpAnd>();
+        this->run<OpAndNot>();
+        this->run<OpXorYorZ>();
+        this->run<OpXandYorZ>();
+        this->run<OpWhichIsEqual>();
+        this->run<OpWhichIsNonZero>();
+        this->run<OpShuffle>();
+        this->run<OpRotateRows>();
+        this->run<OpRotateCols>();
+        this->run<OpPopcount16>();
+        this->run<OpRoundTrip>();
+        this->run<OpPopcount>();
+        this->run<OpIsAllZeros>();
+        this->run<OpHasIntersects>();
+        this->run<OpMinPos16>();
+    }
+};
+
+int main(int argc, char * argv[])
+{
+    size_t iterations = 20000000;
+    if (argc > 1) {
+        iterations = (size_t)atol(argv[1]);
+        if (iterations == 0) iterations = 1;
+    }
+
+    printf("------------------------------------------\n\n");
+    printf("gudoku: bitvec_bench, iterations = %u\n\n", (uint32_t)iterations);
+
+    test::CPU::WarmUp cpuWarmUp(1000);
+
+    // Calibrate the cycles: the best of a few XOR chains, after the warm-up.
+    double ns_per_cycle = 0.0;
+    uint32_t checksum = 0;
+    {
+        BitVecBench<BitVec08x16> bench(iterations, 1.0);
+        for (int i = 0; i < 5; i++) {
+            double latency = bench.latency<OpXor>();
+            if (i == 0 || latency < ns_per_cycle)
+                ns_per_cycle = latency;
+        }
+        checksum += bench.checksum();
+    }
+    printf("1 cycle = %0.3f ns (%0.2f GHz, from the latency of a chain of vector XORs)\n\n",
+           ns_per_cycle, 1.0 / ns_per_cycle);
+
+    {
+        BitVecBench<BitVec08x16> bench(iterations, ns_per_cycle);
+        bench.header();
+        bench.run_common();
+        bench.run<OpMinPosGreaterThanOrEqual>();
+        printf("\n");
+        checksum += bench.checksum();
+    }
+    {
+        BitVecBench<BitVec16x16_SSE> bench(iterations, ns_per_cycle);
+        bench.header();
+        bench.run_common();
+        printf("\n");
+        checksum += bench.checksum();
+    }
+#if defined(__AVX2__)
+    {
+        BitVecBench<BitVec16x16_AVX> bench(iterations, ns_per_cycle);
+        bench.header();
+        bench.run_common();
+        printf("\n");
+        checksum += bench.checksum();
+    }
+#else
+    printf("BitVec16x16_AVX: not built (the build doesn't target AVX2)\n\n");
+#endif
+
+    printf("  (checksum: %08X)\n\n", checksum);
+    printf("------------------------------------------\n\n");
+    return 0;
+}
@@ -0,0 +1,27 @@
+
+//
+// DpllTriadSimdSolver built for AVX2 without AVX-512 (BitVec16x16 is BitVec16x16_AVX).
+//
+// This file is compiled with -mno-avx512f (see CMakeLists.txt), the gudoku namespace is
+// renamed for it like in DpllSolverSSE.cpp.
+//
+
+#include "SolverRegistry.h"
+
+#define gudoku          gudoku_avx2
+#define gudoku_solver   gudoku_solver_avx2
+
+#include "gudoku/DpllTriadSimdSolver.h"
+
+namespace test {
+
+void register_dpll_avx2(SolverRegistry & registry)
+{
+#if defined(__AVX2__) && !defined(__AVX512F__)
+    registry.add<DpllVanillaSolver>("dpll-avx2", "DpllTriadSimdSolver, AVX2 (BitVec16x16_AVX)");
+#else
+    (void)registry;
+#endif
+}
+
+} // namespace test
@@ -0,0 +1,28 @@
+
+//
+// DpllTriadSimdSolver built with the AVX-512 VL paths of BitVec.h.
+//
+// This file is compiled with the default -march=native flags, so the engine only exists if
+// the build machine has AVX-512 VL. The gudoku namespace is renamed for it like in
+// DpllSolverSSE.cpp.
+//
+
+#include "SolverRegistry.h"
+
+#define gudoku          gudoku_avx512
+#define gudoku_solver   gudoku_solver_avx512
+
+#include "gudoku/DpllTriadSimdSolver.h"
+
+namespace test {
+
+void register_dpll_avx512(SolverRegistry & registry)
+{
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    registry.add<DpllVanillaSolver>("dpll-avx512", "DpllTriadSimdSolver, AVX-512 VL (BitVec16x16_AVX)");
+#else
+    (void)registry;
+#endif
+}
+
+} // namespace test
@@ -0,0 +1,29 @@
+
+//
+// DpllTriadSimdSolver built for SSE 4.x only (BitVec16x16 is BitVec16x16_SSE).
+//
+// This file is compiled with -mno-avx (see CMakeLists.txt). Every inline function of the
+// gudoku headers is compiled here with other instructions than in the other translation
+// units, so the gudoku namespace (and the C entry point) are renamed for this file: the
+// linker must not merge them with the AVX builds.
+//
+
+#include "SolverRegistry.h"
+
+#define gudoku          gudoku_sse
+#define gudoku_solver   gudoku_solver_sse
+
+#include "gudoku/DpllTriadSimdSolver.h"
+
+namespace test {
+
+void register_dpll_sse(SolverRegistry & registry)
+{
+#if !defined(__AVX__)
+    registry.add<DpllVanillaSolver>("dpll-sse", "DpllTriadSimdSolver, SSE 4.x (BitVec16x16_SSE)");
+#else
+    (void)registry;
+#endif
+}
+
+} // namespace test
@@ -0,0 +1,240 @@
+
+#ifndef GUDOKU_BENCHMARK_SOLVER_REGISTRY_H
+#define GUDOKU_BENCHMARK_SOLVER_REGISTRY_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>          // For ::operator new(), ::operator delete()
+#include <string>
+#include <vector>
+
+//
+// The solver engines the benchmark can run, by name.
+//
+// Every engine registers a name, a one-line description and a factory. The factory takes
+// the solution mode (1: return the solution, 0: only count) and returns a BenchSolver, the
+// virtual wrapper around the engine's solve() and get_num_guesses().
+//
+// This header doesn't include any gudoku header on purpose: the ISA builds of the DPLL
+// solver (DpllSolverSSE.cpp, DpllSolverAVX2.cpp, DpllSolverAVX512.cpp) are compiled with
+// their own -m flags and their own name for the gudoku namespace, and they all share this
+// registry.
+//
+
+namespace test {
+
+class BenchSolver {
+public:
+    static const size_t kAlignment = 64;
+
+    BenchSolver() {}
+    virtual ~BenchSolver() {}
+
+    virtual size_t solve(const char * puzzle, char * solution, size_t limit) = 0;
+    virtual size_t get_num_guesses() const = 0;
+
+    // The puzzles the engine takes at once in solveBatch(), 1 for the engines of one puzzle.
+    virtual size_t batch_size() const { return 1; }
+
+    //
+    // Solve count puzzles: puzzle i at puzzles + i * puzzle_stride, solution i written to
+    // solutions + i * solution_stride, its number of solutions and guesses to
+    // num_solutions[i] and num_guesses[i]. Returns the number of puzzles solved.
+    //
+    virtual size_t solveBatch(const char * puzzles, size_t puzzle_stride,
+                              char * solutions, size_t solution_stride,
+                              size_t count, size_t limit,
+                              size_t * num_solutions, size_t * num_guesses) {
+        size_t solved = 0;
+        for (size_t i = 0; i < count; i++) {
+            num_solutions[i] = this->solve(puzzles + i * puzzle_stride, solutions + i * solution_stride, limit);
+            num_guesses[i] = this->get_num_guesses();
+            solved += (num_solutions[i] != 0);
+        }
+        return solved;
+    }
+
+    // The solvers are over-aligned (alignas(32) and up), which plain new doesn't honor
+    // before C++17. Take kAlignment more bytes from the global new and align by hand, with
+    // the pointer to give back just before the object, so new and delete stay a pair.
+    static void * operator new (size_t size) {
+        void * block = ::operator new(size + kAlignment);
+        uintptr_t aligned = ((uintptr_t)block + kAlignment) & ~(uintptr_t)(kAlignment - 1);
+        reinterpret_cast<void **>(aligned)[-1] = block;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    static void operator delete (void * ptr) {
+        if (ptr != nullptr)
+            ::operator delete(reinterpret_cast<void **>(ptr)[-1]);
+    }
+};
+
+template <typename SolverT>
+class BenchSolverImpl : public BenchSolver {
+private:
+    SolverT solver_;
+
+public:
+    BenchSolverImpl() : BenchSolver(), solver_() {}
+    virtual ~BenchSolverImpl() {}
+
+    virtual size_t solve(const char * puzzle, char * solution, size_t limit) {
+        return this->solver_.solve(puzzle, solution, limit);
+    }
+
+    virtual size_t get_num_guesses() const {
+        return this->solver_.get_num_guesses();
+    }
+};
+
+// The engines that solve a batch of puzzles at once, SolverT::kBatchSize at a time.
+template <typename SolverT>
+class BenchBatchSolverImpl : public BenchSolver {
+private:
+    SolverT solver_;
+
+public:
+    BenchBatchSolverImpl() : BenchSolver(), solver_() {}
+    virtual ~BenchBatchSolverImpl() {}
+
+    virtual size_t solve(const char * puzzle, char * solution, size_t limit) {
+        return this->solver_.solve(puzzle, solution, limit);
+    }
+
+    virtual size_t get_num_guesses() const {
+        return this->solver_.get_num_guesses();
+    }
+
+    virtual size_t batch_size() const {
+        return SolverT::kBatchSize;
+    }
+
+    virtual size_t solveBatch(const char * puzzles, size_t puzzle_stride,
+                              char * solutions, size_t solution_stride,
+                              size_t count, size_t limit,
+                              size_t * num_solutions, size_t * num_guesses) {
+        return this->solver_.solveBatch(puzzles, puzzle_stride, solutions, solution_stride,
+                                        count, limit, num_solutions, num_guesses);
+    }
+};
+
+struct SolverInfo {
+    typedef BenchSolver * (*factory_type)(int solution_mode);
+
+    const char *    name;
+    const char *    description;
+    factory_type    create;
+};
+
+class SolverRegistry {
+private:
+    std::vector<SolverInfo> solvers_;
+
+    template <template <int> class SolverT>
+    static BenchSolver * createSolver(int solution_mode) {
+        if (solution_mode == 1)
+            return new BenchSolverImpl<SolverT<1>>();
+        else
+            return new BenchSolverImpl<SolverT<0>>();
+    }
+
+    template <template <int> class SolverT>
+    static BenchSolver * createBatchSolver(int solution_mode) {
+        if (solution_mode == 1)
+            return new BenchBatchSolverImpl<SolverT<1>>();
+        else
+            return new BenchBatchSolverImpl<SolverT<0>>();
+    }
+
+public:
+    SolverRegistry() {}
+    ~SolverRegistry() {}
+
+    // SolverT<kSolutionMode> is a solver class template, like DpllTriadSimdSolver.
+    template <template <int> class SolverT>
+    void add(const char * name, const char * description) {
+        SolverInfo info;
+        info.name = name;
+        info.description = description;
+        info.create = &SolverRegistry::createSolver<SolverT>;
+        this->solvers_.push_back(info);
+    }
+
+    // SolverT<kSolutionMode> solves batches of puzzles, like BitSliceSolver.
+    template <template <int> class SolverT>
+    void addBatch(const char * name, const char * description) {
+        SolverInfo info;
+        info.name = name;
+        info.description = description;
+        info.create = &SolverRegistry::createBatchSolver<SolverT>;
+        this->solvers_.push_back(info);
+    }
+
+    const std::vector<SolverInfo> & solvers() const {
+        return this->solvers_;
+    }
+
+    const SolverInfo * find(const char * name) const {
+        for (size_t i = 0; i < this->solvers_.size(); i++) {
+            if (std::strcmp(this->solvers_[i].name, name) == 0)
+                return &this->solvers_[i];
+        }
+        return nullptr;
+    }
+
+    //
+    // Select the solvers of a comma separated list of names, in the order of the list.
+    // An empty list (or nullptr) selects all of them. Returns false on an unknown name.
+    //
+    bool select(const char * names, std::vector<const SolverInfo *> & selected,
+                std::string & unknown) const {
+        selected.clear();
+        if (names == nullptr || *names == '\0') {
+            for (size_t i = 0; i < this->solvers_.size(); i++) {
+                selected.push_back(&this->solvers_[i]);
+            }
+            return true;
+        }
+
+        const char * first = names;
+        while (*first != '\0') {
+            const char * last = first;
+            while (*last != '\0' && *last != ',') {
+                last++;
+            }
+            if (last != first) {
+                std::string name(first, last);
+                const SolverInfo * info = this->find(name.c_str());
+                if (info == nullptr) {
+                    unknown = name;
+                    return false;
+                }
+                selected.push_back(info);
+            }
+            first = (*last == ',') ? (last + 1) : last;
+        }
+        return true;
+    }
+};
+
+// The ISA builds of DpllTriadSimdSolver. Each one registers nothing if the compiler
+// can't target its instruction set.
+void register_dpll_sse(SolverRegistry & registry);
+void register_dpll_avx2(SolverRegistry & registry);
+void register_dpll_avx512(SolverRegistry & registry);
+
+} // namespace test
+
+#endif // GUDOKU_BENCHMARK_SOLVER_REGISTRY_H
@@ -0,0 +1,179 @@
+
+#if defined(_MSC_VER) && !defined(NDEBUG)
+#include <vld.h>
+#endif
+
+#if defined(_MSC_VER)
+#define __MMX__
+#define __SSE__
+#define __SSE2__
+#define __SSE3__
+#define __SSSE3__
+#define __SSE4A__
+#define __SSE4a__
+#define __SSE4_1__
+#define __SSE4_2__
+#define __POPCNT__
+#define __LZCNT__
+#define __AVX__
+#define __AVX2__
+#define __3dNOW__
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset()
+
+#include "gudoku/StopWatch.h"
+#include "gudoku/CPUWarmUp.h"
+
+#include "gudoku/AlignedArena.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+using namespace gudoku;
+
+//
+// Measures the cost of taking a search snapshot (one State, 512 bytes) with aligned vector
+// loads/stores (loadAligned()/saveAligned(), and State::copy() as used by the solver) against
+// the unaligned path (loadUnaligned()/saveUnaligned()) at various misalignments.
+//
+// The snapshots form a ring like the solver's search stack: state[d] is copied into
+// state[d + 1]. Two depths are measured: one that stays in L1 and the full search arena.
+//
+// Usage: state_copy_bench [iterations] [huge_pages = 0/1]
+//
+
+static const size_t kStateSize = sizeof(State);
+static const size_t kVectorsPerState = kStateSize / sizeof(BitVec16x16);
+
+struct CopyPolicy {
+    enum {
+        StateCopy,
+        Aligned,
+        Unaligned
+    };
+};
+
+template <int kPolicy>
+static inline void copy_state(char * dest, const char * src) {
+    if (kPolicy == CopyPolicy::StateCopy) {
+        reinterpret_cast<State *>(dest)->copy(*reinterpret_cast<const State *>(src));
+    }
+    else {
+        for (size_t i = 0; i < kVectorsPerState; i++) {
+            BitVec16x16 value;
+            if (kPolicy == CopyPolicy::Aligned) {
+                value.loadAligned(src + i * sizeof(BitVec16x16));
+                value.saveAligned(dest + i * sizeof(BitVec16x16));
+            }
+            else {
+                value.loadUnaligned(src + i * sizeof(BitVec16x16));
+                value.saveUnaligned(dest + i * sizeof(BitVec16x16));
+            }
+        }
+    }
+}
+
+template <int kPolicy>
+static double run_copy_test(char * base, size_t depth, size_t iterations, uint32_t & checksum)
+{
+    // Best of 3 runs, so the first policy measured doesn't pay for faulting the pages in.
+    double best_time = 0.0;
+    for (int round = 0; round < 3; round++) {
+        test::StopWatch sw;
+        sw.start();
+
+        for (size_t iter = 0; iter < iterations; iter++) {
+            for (size_t d = 0; d < depth; d++) {
+                copy_state<kPolicy>(base + (d + 1) * kStateSize, base + d * kStateSize);
+            }
+            // Feed the last snapshot back into the root, so nothing can be hoisted out.
+            copy_state<kPolicy>(base, base + depth * kStateSize);
+        }
+
+        sw.stop();
+        double elapsed_time = sw.getElapsedMillisec();
+        if (round == 0 || elapsed_time < best_time)
+            best_time = elapsed_time;
+    }
+    checksum += *reinterpret_cast<const uint32_t *>(base + depth * kStateSize);
+
+    double total_copies = (double)iterations * (depth + 1);
+    return (best_time * 1000000.0) / total_copies;
+}
+
+static void print_result(const char * name, size_t offset, double ns_per_copy, double baseline)
+{
+    printf("  %-24s  offset %2u  %8.2f ns/copy  %7.2f GB/s  %6.2f x\n",
+           name, (uint32_t)offset, ns_per_copy, (double)kStateSize / ns_per_copy,
+           ns_per_copy / baseline);
+}
+
+static void run_depth(AlignedArena<State> & arena, size_t depth, size_t iterations)
+{
+    // Every State of the arena is cache line aligned; one spare State of slack is kept at
+    // the end so the misaligned views stay in bounds.
+    char * base = reinterpret_cast<char *>(arena.data());
+    uint32_t checksum = 0;
+
+    printf("depth = %u (%u KB working set), iterations = %u\n\n",
+           (uint32_t)depth, (uint32_t)((depth + 1) * kStateSize / 1024), (uint32_t)iterations);
+
+    double state_copy = run_copy_test<CopyPolicy::StateCopy>(base, depth, iterations, checksum);
+    double aligned    = run_copy_test<CopyPolicy::Aligned>(base, depth, iterations, checksum);
+
+    print_result("State::copy()", 0, state_copy, aligned);
+    print_result("loadAligned/saveAligned", 0, aligned, aligned);
+
+    static const size_t offsets[] = { 0, 8, 16, 32, 48 };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        double unaligned = run_copy_test<CopyPolicy::Unaligned>(base + offsets[i], depth,
+                                                                 iterations, checksum);
+        print_result("loadUnaligned/saveUnal.", offsets[i], unaligned, aligned);
+    }
+
+    printf("\n  (checksum: %08X)\n\n", checksum);
+}
+
+int main(int argc, char * argv[])
+{
+    size_t iterations = 200000;
+    bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0);
+    if (argc > 1) {
+        iterations = (size_t)atol(argv[1]);
+        if (iterations == 0) iterations = 1;
+    }
+    if (argc > 2) {
+        use_huge_pages = (atoi(argv[2]) != 0);
+    }
+
+    static const size_t kMaxDepth = DpllTriadSimdSolver<1>::kMaxSearchDepth;
+    AlignedArena<State> arena(kMaxDepth + 3, use_huge_pages);
+
+    printf("------------------------------------------\n\n");
+    printf("gudoku: state_copy_bench\n\n");
+    printf("sizeof(State) = %u, alignof(State) = %u, arena: %u KB (%s)\n\n",
+           (uint32_t)sizeof(State), (uint32_t)alignof(State), (uint32_t)(arena.bytes() / 1024),
+           (arena.storage() == AlignedArena<State>::Storage::HugePages) ? "huge pages" :
+           (arena.storage() == AlignedArena<State>::Storage::Mapped) ? "transparent huge pages" : "heap");
+
+    test::CPU::WarmUp cpuWarmUp(1000);
+
+    // Fits in L1: a typical search depth.
+    run_depth(arena, 16, iterations);
+    // The whole search arena (L2).
+    run_depth(arena, kMaxDepth, iterations / 16 + 1);
+
+    printf("------------------------------------------\n\n");
+    return 0;
+}
@@ -0,0 +1,330 @@
+
+#if defined(_MSC_VER) && !defined(NDEBUG)
+#include <vld.h>
+#endif
+
+#if defined(_MSC_VER)
+#define __MMX__
+#define __SSE__
+#define __SSE2__
+#define __SSE3__
+#define __SSSE3__
+#define __SSE4A__
+#define __SSE4a__
+#define __SSE4_1__
+#define __SSE4_2__
+#define __POPCNT__
+#define __LZCNT__
+#define __AVX__
+#define __AVX2__
+#define __3dNOW__
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <memory.h>
+#include <assert.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset()
+#include <vector>
+
+#include "gudoku/StopWatch.h"
+
+#include "gudoku/SudokuGenerator.h"
+
+using namespace gudoku;
+
+// Parses "22-30" or "25" (the grid size clamps the upper bound).
+bool parse_clue_range(const char * text, int & min_clues, int & max_clues)
+{
+    char * end = nullptr;
+    long first = strtol(text, &end, 10);
+    if (end == text)
+        return false;
+    long last = first;
+    if (*end == '-') {
+        const char * second = end + 1;
+        last = strtol(second, &end, 10);
+        if (end == second)
+            return false;
+    }
+    if (*end != '\0' || first < 0 || last > 256 || first > last)
+        return false;
+    min_clues = (int)first;
+    max_clues = (int)last;
+    return true;
+}
+
+// Parses "random,contradiction,...".
+bool parse_kinds(const char * text, std::vector<int> & kinds)
+{
+    kinds.clear();
+    const char * p = text;
+    while (*p != '\0') {
+        const char * comma = std::strchr(p, ',');
+        size_t length = (comma != nullptr) ? (size_t)(comma - p) : std::strlen(p);
+        int kind = PuzzleKind::find(p, length);
+        if (kind < 0)
+            return false;
+        kinds.push_back(kind);
+        p += length;
+        if (*p == ',')
+            p++;
+    }
+    return !kinds.empty();
+}
+
+//
+// Write count puzzles, one per line, the kinds in turn. A leading comment line records
+// the parameters, which the benchmark and the rater skip.
+//
+template <typename Generator>
+int generate_sudoku_puzzles(const char * name, const std::vector<int> & kinds, size_t count,
+                            int min_clues, int max_clues, uint64_t seed,
+                            const char * out_file)
+{
+    static const int kCells = Generator::kCells;
+
+    FILE * fp = stdout;
+    if (out_file != nullptr) {
+        fp = fopen(out_file, "wb");
+        if (fp == nullptr) {
+            printf("Error: can not open the output file: %s\n\n", out_file);
+            return 1;
+        }
+    }
+
+    fprintf(fp, "# gudoku generator: size=%d, ", Generator::kDigits);
+    if (Generator::variant_type::kUnits != 0)
+        fprintf(fp, "variant=%s, ", Generator::variant_type::name());
+    fprintf(fp, "kind=");
+    for (size_t i = 0; i < kinds.size(); i++) {
+        fprintf(fp, "%s%s", (i == 0) ? "" : ",", PuzzleKind::name(kinds[i]));
+    }
+    if (min_clues >= 0)
+        fprintf(fp, ", clues=%d-%d", min_clues, max_clues);
+    fprintf(fp, ", count=%" PRIuPTR ", seed=%" PRIu64 "\n", count, seed);
+
+    Generator generator(seed);
+    size_t generated[PuzzleKind::Last] = { 0 };
+    size_t failed[PuzzleKind::Last] = { 0 };
+    size_t clue_total[PuzzleKind::Last] = { 0 };
+
+    char line[kCells + 16];
+
+    test::StopWatch sw;
+    sw.start();
+
+    for (size_t i = 0; i < count; i++) {
+        int kind = kinds[i % kinds.size()];
+        int kind_min = min_clues, kind_max = max_clues;
+        if (min_clues < 0)
+            PuzzleKind::defaultClues(kind, kind_min, kind_max, Generator::kDigits);
+
+        if (!generator.generate(kind, kind_min, kind_max, line)) {
+            failed[kind]++;
+            continue;
+        }
+        clue_total[kind] += (size_t)Generator::countClues(line);
+        line[kCells] = '\n';
+        fwrite(line, 1, kCells + 1, fp);
+        generated[kind]++;
+    }
+
+    sw.stop();
+    double total_time = sw.getElapsedMillisec();
+
+    if (fp != stdout)
+        fclose(fp);
+
+    FILE * summary = (fp != stdout) ? stdout : stderr;
+    fprintf(summary, "------------------------------------------\n\n");
+    fprintf(summary, "gudoku: %s\n\n", name);
+    for (int kind = 0; kind < PuzzleKind::Last; kind++) {
+        if (generated[kind] == 0 && failed[kind] == 0) continue;
+        fprintf(summary, "  %-14s: %10" PRIuPTR " puzzle(s), %5.1f clues avg",
+                PuzzleKind::name(kind), generated[kind],
+                (generated[kind] != 0) ? ((double)clue_total[kind] / generated[kind]) : 0.0);
+        if (failed[kind] != 0)
+            fprintf(summary, ", %" PRIuPTR " failed (clue range too low?)", failed[kind]);
+        fprintf(summary, "\n");
+    }
+    fprintf(summary, "\n");
+    size_t total_generated = 0;
+    for (int kind = 0; kind < PuzzleKind::Last; kind++) {
+        total_generated += generated[kind];
+    }
+    fprintf(summary, "Total elapsed time: %0.3f ms, %0.1f puzzles/sec\n\n", total_time,
+            (total_time != 0.0) ? (total_generated * 1000.0 / total_time) : 0.0);
+    fprintf(summary, "------------------------------------------\n\n");
+    return 0;
+}
+
+// Write count killer puzzles, one line each: the cage ids of the 81 cells, ':' and the sums.
+int generate_killer_puzzles(size_t count, int min_size, int max_size, uint64_t seed,
+                            const char * out_file)
+{
+    FILE * fp = stdout;
+    if (out_file != nullptr) {
+        fp = fopen(out_file, "wb");
+        if (fp == nullptr) {
+            printf("Error: can not open the output file: %s\n\n", out_file);
+            return 1;
+        }
+    }
+
+    fprintf(fp, "# gudoku generator: size=9, killer, cages=%d-%d, count=%" PRIuPTR ", seed=%" PRIu64 "\n",
+            min_size, max_size, count, seed);
+
+    KillerSudokuGenerator generator(seed);
+    size_t generated = 0, failed = 0, cage_total = 0;
+    char line[kKillerLineSize];
+
+    test::StopWatch sw;
+    sw.start();
+
+    for (size_t i = 0; i < count; i++) {
+        if (!generator.generate(min_size, max_size, line)) {
+            failed++;
+            continue;
+        }
+        cage_total += (size_t)KillerSudokuGenerator::countCages(line);
+        fprintf(fp, "%s\n", line);
+        generated++;
+    }
+
+    sw.stop();
+    double total_time = sw.getElapsedMillisec();
+
+    if (fp != stdout)
+        fclose(fp);
+
+    FILE * summary = (fp != stdout) ? stdout : stderr;
+    fprintf(summary, "------------------------------------------\n\n");
+    fprintf(summary, "gudoku: KillerSudokuGenerator\n\n");
+    fprintf(summary, "  %-14s: %10" PRIuPTR " puzzle(s), %5.1f cages avg", "killer", generated,
+            (generated != 0) ? ((double)cage_total / generated) : 0.0);
+    if (failed != 0)
+        fprintf(summary, ", %" PRIuPTR " failed (cages too large?)", failed);
+    fprintf(summary, "\n\n");
+    fprintf(summary, "Total elapsed time: %0.3f ms, %0.1f puzzles/sec\n\n", total_time,
+            (total_time != 0.0) ? (generated * 1000.0 / total_time) : 0.0);
+    fprintf(summary, "------------------------------------------\n\n");
+    return 0;
+}
+
+//
+// Usage: generator [options] [output_file]
+//
+//   --kind=k1,k2,...   random, minimal, contradiction, duplicate, multi, sparse,
+//                      generated in turn (default: random)
+//   --count=N          the number of puzzles (default: 1000)
+//   --clues=min-max    the clue range (default: by kind)
+//   --seed=S           the random seed (default: 1)
+//   --size=4|6|9|16    9x9 sudoku, 4x4 or 6x6 mini sudoku, or 16x16 hexadoku (digits 0-9,
+//                      A-F) (default: 9)
+//   --variant=x|windoku  9x9 Sudoku-X (the two diagonals) or windoku (four windows)
+//   --killer[=min-max]   9x9 killer puzzles, cages of min to max cells (default: 2-4)
+//
+int main(int argc, char * argv[])
+{
+    const char * out_file = nullptr;
+    std::vector<int> kinds(1, (int)PuzzleKind::Random);
+    size_t count = 1000;
+    int min_clues = -1, max_clues = -1;
+    uint64_t seed = 1;
+    int size = 9;
+    int variant = SudokuVariant::Vanilla;
+    bool killer = false;
+    int min_cage = 2, max_cage = 4;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--kind=", 7) == 0) {
+            if (!parse_kinds(argv[i] + 7, kinds)) {
+                printf("Error: unknown kind in: %s\n\n", argv[i] + 7);
+                return 1;
+            }
+        }
+        else if (std::strncmp(argv[i], "--count=", 8) == 0) {
+            count = (size_t)strtoull(argv[i] + 8, nullptr, 10);
+        }
+        else if (std::strncmp(argv[i], "--clues=", 8) == 0) {
+            if (!parse_clue_range(argv[i] + 8, min_clues, max_clues)) {
+                printf("Error: bad clue range: %s\n\n", argv[i] + 8);
+                return 1;
+            }
+        }
+        else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = (uint64_t)strtoull(argv[i] + 7, nullptr, 10);
+        }
+        else if (std::strncmp(argv[i], "--size=", 7) == 0) {
+            size = atoi(argv[i] + 7);
+            if (size != 4 && size != 6 && size != 9 && size != 16) {
+                printf("Error: the size must be 4, 6, 9 or 16: %s\n\n", argv[i] + 7);
+                return 1;
+            }
+        }
+        else if (std::strncmp(argv[i], "--variant=", 10) == 0) {
+            variant = SudokuVariant::find(argv[i] + 10);
+            if (variant < 0) {
+                printf("Error: the variant must be x or windoku: %s\n\n", argv[i] + 10);
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--killer") == 0) {
+            killer = true;
+        }
+        else if (std::strncmp(argv[i], "--killer=", 9) == 0) {
+            killer = true;
+            if (!parse_clue_range(argv[i] + 9, min_cage, max_cage)) {
+                printf("Error: bad cage size range: %s\n\n", argv[i] + 9);
+                return 1;
+            }
+        }
+        else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            printf("Usage: generator [--kind=k1,k2,...] [--count=N] [--clues=min-max] [--seed=S]\n"
+                   "                 [--size=4|6|9|16] [--variant=x|windoku] [--killer[=min-max]]\n"
+                   "                 [output_file]\n\n"
+                   "  kinds: random, minimal, contradiction, duplicate, multi, sparse\n\n");
+            return 1;
+        }
+        else {
+            out_file = argv[i];
+        }
+    }
+
+    if ((variant != SudokuVariant::Vanilla || killer) && size != 9) {
+        printf("Error: the variants are 9x9 only.\n\n");
+        return 1;
+    }
+
+    if (killer)
+        return generate_killer_puzzles(count, min_cage, max_cage, seed, out_file);
+
+    if (size == 16)
+        return generate_sudoku_puzzles<HexadokuGenerator>("HexadokuGenerator",
+                                                          kinds, count, min_clues, max_clues, seed, out_file);
+    else if (size == 6)
+        return generate_sudoku_puzzles<Sudoku6x6Generator>("Sudoku6x6Generator",
+                                                           kinds, count, min_clues, max_clues, seed, out_file);
+    else if (size == 4)
+        return generate_sudoku_puzzles<Sudoku4x4Generator>("Sudoku4x4Generator",
+                                                           kinds, count, min_clues, max_clues, seed, out_file);
+    else if (variant == SudokuVariant::X)
+        return generate_sudoku_puzzles<SudokuXGenerator>("SudokuXGenerator",
+                                                         kinds, count, min_clues, max_clues, seed, out_file);
+    else if (variant == SudokuVariant::Windoku)
+        return generate_sudoku_puzzles<WindokuGenerator>("WindokuGenerator",
+                                                         kinds, count, min_clues, max_clues, seed, out_file);
+    else
+        return generate_sudoku_puzzles<SudokuGenerator>("SudokuGenerator",
+                                                        kinds, count, min_clues, max_clues, seed, out_file);
+}
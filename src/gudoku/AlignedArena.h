@@ -0,0 +1,173 @@
+
+#ifndef GUDOKU_ALIGNED_ARENA_H
+#define GUDOKU_ALIGNED_ARENA_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>          // For placement new
+
+#if defined(_MSC_VER)
+#include <malloc.h>     // For _aligned_malloc(), _aligned_free()
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>   // For mmap(), madvise(), munmap()
+#endif
+
+//
+// Backing storage of the solver search snapshots.
+//
+// By default the arena is a 64 byte (cache line) aligned heap block. If GUDOKU_USE_HUGE_PAGES
+// is defined to 1 (or use_huge_pages is passed to the constructor), on Linux the block is
+// mapped from the 2 MB huge page pool (MAP_HUGETLB), and if the pool is empty it falls back
+// to an anonymous mapping with transparent huge pages requested through madvise(). The whole
+// search stack then sits under a single TLB entry.
+//
+#ifndef GUDOKU_USE_HUGE_PAGES
+#define GUDOKU_USE_HUGE_PAGES   0
+#endif
+
+namespace gudoku {
+
+template <typename T>
+class AlignedArena {
+public:
+    typedef T           value_type;
+    typedef std::size_t size_type;
+
+    static const size_type kCacheLineSize = 64;
+    static const size_type kHugePageSize = 2 * 1024 * 1024;
+
+    struct Storage {
+        enum {
+            Heap,
+            Mapped,
+            HugePages
+        };
+    };
+
+private:
+    T *         data_;
+    size_type   capacity_;
+    size_type   bytes_;
+    int         storage_;
+
+public:
+    explicit AlignedArena(size_type capacity, bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : data_(nullptr), capacity_(capacity), bytes_(0), storage_(Storage::Heap) {
+        static_assert((alignof(T) <= kCacheLineSize), "AlignedArena<T>: T is over-aligned");
+        this->allocate(use_huge_pages);
+        for (size_type i = 0; i < capacity_; i++) {
+            new (&this->data_[i]) T();
+        }
+    }
+
+    ~AlignedArena() {
+        this->destroy();
+    }
+
+    AlignedArena(const AlignedArena & src) = delete;
+    AlignedArena & operator = (const AlignedArena & rhs) = delete;
+
+    T * data() { return this->data_; }
+    const T * data() const { return this->data_; }
+
+    size_type capacity() const { return this->capacity_; }
+    size_type bytes() const { return this->bytes_; }
+    int storage() const { return this->storage_; }
+    bool huge_pages() const { return (this->storage_ != Storage::Heap); }
+
+    T & operator [] (size_type index) {
+        assert(index < this->capacity_);
+        return this->data_[index];
+    }
+
+    const T & operator [] (size_type index) const {
+        assert(index < this->capacity_);
+        return this->data_[index];
+    }
+
+private:
+    static size_type round_up(size_type size, size_type alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void allocate(bool use_huge_pages) {
+        size_type size = sizeof(T) * this->capacity_;
+#if defined(__linux__)
+        if (use_huge_pages) {
+            size_type huge_size = round_up(size, kHugePageSize);
+            void * ptr = ::mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED) {
+                this->data_ = static_cast<T *>(ptr);
+                this->bytes_ = huge_size;
+                this->storage_ = Storage::HugePages;
+                return;
+            }
+            // The huge page pool is empty (vm.nr_hugepages = 0): ask for THP instead.
+            ptr = ::mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+                ::madvise(ptr, huge_size, MADV_HUGEPAGE);
+#endif
+                this->data_ = static_cast<T *>(ptr);
+                this->bytes_ = huge_size;
+                this->storage_ = Storage::Mapped;
+                return;
+            }
+        }
+#else
+        (void)use_huge_pages;
+#endif
+        size = round_up(size, kCacheLineSize);
+#if defined(_MSC_VER)
+        void * ptr = ::_aligned_malloc(size, kCacheLineSize);
+#else
+        void * ptr = nullptr;
+        if (::posix_memalign(&ptr, kCacheLineSize, size) != 0)
+            ptr = nullptr;
+#endif
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        this->data_ = static_cast<T *>(ptr);
+        this->bytes_ = size;
+        this->storage_ = Storage::Heap;
+    }
+
+    void destroy() {
+        if (this->data_ != nullptr) {
+            for (size_type i = 0; i < this->capacity_; i++) {
+                this->data_[i].~T();
+            }
+#if defined(__linux__)
+            if (this->storage_ != Storage::Heap) {
+                ::munmap((void *)this->data_, this->bytes_);
+                this->data_ = nullptr;
+                return;
+            }
+#endif
+#if defined(_MSC_VER)
+            ::_aligned_free((void *)this->data_);
+#else
+            ::free((void *)this->data_);
+#endif
+            this->data_ = nullptr;
+        }
+    }
+};
+
+} // namespace gudoku
+
+#endif // GUDOKU_ALIGNED_ARENA_H
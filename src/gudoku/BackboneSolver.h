@@ -0,0 +1,204 @@
+
+#ifndef GUDOKU_BACKBONE_SOLVER_H
+#define GUDOKU_BACKBONE_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memcpy(), std::memset()
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// The backbone of a puzzle: the cells that have the same digit in every solution (all the
+// cells of a unique puzzle, the clues and some more of a puzzle with many solutions).
+//
+// One search over all the solutions, narrowed as it goes: the first solution is the first
+// guess of the backbone, and every later one drops the cells where it differs. A solution
+// only tells something new if it differs in a cell still in the backbone, so the backbone
+// is a blocking clause on the search, checked against the box candidates of the State at
+// every node:
+//
+//   - every backbone cell is fixed to its digit: no solution below differs, prune,
+//   - one backbone cell is open and the others fixed: it must differ, eliminate its digit,
+//   - otherwise, go on.
+//
+// The search ends when no subtree can differ from the backbone any more, and after the
+// first solution it only visits the subtrees that might.
+//
+
+using namespace gudoku;
+
+namespace {
+
+class BackboneSolver : public DpllTriadSimdSolver<0> {
+public:
+    typedef DpllTriadSimdSolver<0>  dpll_solver_t;
+    typedef BackboneSolver          this_type;
+
+private:
+    // The backbone so far, the digit of a cell or '.', and per box as cell lanes: all the
+    // bits of the backbone cells and their digits.
+    BitVec16x16     backbone_lanes_[9];
+    BitVec16x16     backbone_digits_[9];
+    alignas(32)
+    uint16_t        digits_[9][16];
+    char            backbone_[Sudoku::BoardSize];
+    char            solution_[Sudoku::BoardSize];
+
+    size_t          num_blocked_;
+
+public:
+    BackboneSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : dpll_solver_t(use_huge_pages), num_blocked_(0) {
+    }
+    ~BackboneSolver() {}
+
+    // The backbone digits eliminated by the blocking clause in the last search.
+    size_t get_num_blocked() const {
+        return this->num_blocked_;
+    }
+
+private:
+    void updateBackboneLanes() {
+        alignas(32) uint16_t lanes[9][16];
+        std::memset(&lanes[0][0], 0, sizeof(lanes));
+        std::memset(&this->digits_[0][0], 0, sizeof(this->digits_));
+        for (size_t pos = 0; pos < Sudoku::BoardSize; pos++) {
+            if (this->backbone_[pos] == '.') continue;
+            const BoxIndexing & indexing = tables.box_indexing[pos];
+            lanes[indexing.box][indexing.cell] = (uint16_t)kAll;
+            this->digits_[indexing.box][indexing.cell] = (uint16_t)(1u << (uint32_t)(this->backbone_[pos] - '1'));
+        }
+        for (size_t box = 0; box < 9; box++) {
+            this->backbone_lanes_[box].loadAligned(&lanes[box][0]);
+            this->backbone_digits_[box].loadAligned(&this->digits_[box][0]);
+        }
+    }
+
+    // A solution: drop the backbone cells where it differs.
+    void narrowBackbone(const State & state) {
+        extractSolution(state, this->solution_);
+        if (this->num_solutions_ == 1) {
+            std::memcpy(this->backbone_, this->solution_, Sudoku::BoardSize);
+        }
+        else {
+            for (size_t pos = 0; pos < Sudoku::BoardSize; pos++) {
+                if (this->backbone_[pos] != this->solution_[pos])
+                    this->backbone_[pos] = '.';
+            }
+        }
+        this->updateBackboneLanes();
+    }
+
+    //
+    // The blocking clause, some backbone cell differs. Returns false if no solution below
+    // the state can differ, or if the elimination of the last open digit is a conflict.
+    //
+    bool blockBackbone(State & state) {
+        int open_box = -1;
+        BitVec16x16 open_cells;
+        for (int box = 0; box < 9; box++) {
+            BitVec16x16 open = (state.boxes[box].cells & this->backbone_lanes_[box]) ^
+                               this->backbone_digits_[box];
+            if (open.isAllZeros()) continue;
+            if (open_box >= 0) return true;
+            open_box = box;
+            open_cells = open;
+        }
+        if (open_box < 0) return false;
+
+        alignas(32) uint16_t lanes[16];
+        open_cells.saveAligned(&lanes[0]);
+        int open_lane = -1;
+        for (int lane = 0; lane < 16; lane++) {
+            if (lanes[lane] == 0) continue;
+            if (open_lane >= 0) return true;
+            open_lane = lane;
+        }
+
+        // The only open backbone cell, unless its digit is gone already, must not take it.
+        alignas(32) uint16_t candidates[16];
+        state.boxes[open_box].cells.saveAligned(&candidates[0]);
+        uint16_t digit = this->digits_[open_box][open_lane];
+        if ((candidates[open_lane] & digit) == 0) return true;
+        for (int lane = 0; lane < 16; lane++) {
+            candidates[lane] = (uint16_t)kAll;
+        }
+        candidates[open_lane] = (uint16_t)(kAll & ~digit);
+        BitVec16x16 restriction;
+        restriction.loadAligned(&candidates[0]);
+        this->num_blocked_++;
+        return boxRestrict<kHorizontal>(state, open_box, restriction);
+    }
+
+    void search(State & state) {
+        if (this->num_solutions_ != 0 && !this->blockBackbone(state)) return;
+
+        auto band_and_value = chooseBandAndValueToBranch(state);
+        if (band_and_value.first == NONE) {
+            this->num_solutions_++;
+            this->narrowBackbone(state);
+            return;
+        }
+
+        uint32_t vertical = (band_and_value.first < 3) ? (uint32_t)kHorizontal : (uint32_t)kVertical;
+        uint32_t band_idx = tables.mod3[band_and_value.first];
+        BitVec08x16 value_configurations =
+                state.bands[vertical][band_idx].configurations & band_and_value.second;
+        // Assign the first configuration by eliminating the others
+        BitVec08x16 assignment_elims = value_configurations.clearLowBit();
+        this->num_guesses_++;
+        State & next_state = this->nextSnapshot(state);
+        next_state.copy(state);
+        next_state.bands[vertical][band_idx].eliminations |= assignment_elims;
+        if (bandEliminate(next_state, vertical, band_idx)) {
+            this->search(next_state);
+        }
+        // Now negate the first configuration
+        state.bands[vertical][band_idx].eliminations |= (value_configurations ^ assignment_elims);
+        if (bandEliminate(state, vertical, band_idx)) {
+            this->search(state);
+        }
+    }
+
+public:
+    //
+    // Find the backbone of the puzzle: backbone (81 chars) gets the digit of every cell that
+    // is the same in all the solutions and '.' elsewhere. Returns the number of backbone
+    // cells, 0 if the puzzle has no solution. get_num_solutions() is the number of solutions
+    // the search met: 0, 1 for a unique puzzle, or more (but not all of them).
+    //
+    size_t backbone(const char * puzzle, char * backbone) {
+        this->resetStatistics(SIZE_MAX);
+        this->num_blocked_ = 0;
+        std::memset(this->backbone_, '.', Sudoku::BoardSize);
+
+        State & state = this->states_[0];
+        if (this->initSudoku(puzzle, state)) {
+            this->search(state);
+        }
+
+        size_t num_cells = 0;
+        for (size_t pos = 0; pos < Sudoku::BoardSize; pos++) {
+            num_cells += (this->backbone_[pos] != '.');
+        }
+        std::memcpy(backbone, this->backbone_, Sudoku::BoardSize);
+        return num_cells;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_BACKBONE_SOLVER_H
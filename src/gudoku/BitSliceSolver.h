@@ -0,0 +1,346 @@
+
+#ifndef GUDOKU_BIT_SLICE_SOLVER_H
+#define GUDOKU_BIT_SLICE_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset()
+#include <algorithm>    // For std::min()
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitUtils.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// The singles of a batch of puzzles at once, bit-sliced.
+//
+// The batch is transposed so that bit p of cands_[cell][digit] says whether the digit is
+// still a candidate of the cell in the puzzle p: a slice (BitVec16x16) holds one candidate
+// of 256 puzzles. Every sweep runs the naked and the hidden singles of all the puzzles with
+// plain AND / OR / ANDNOT, digit by digit (the eliminations of a digit are seen by the
+// next digits of the same sweep), until no undecided puzzle changes:
+//
+//   naked single:   a cell with one candidate left removes it from its 20 peers,
+//   hidden single:  a digit with one cell left in a row, a column or a box is placed there,
+//
+// and a puzzle with an empty cell, a digit without a cell in a unit, or a digit solved
+// twice in a unit has no solution. The puzzles the singles alone solve (or reject) are
+// done without a search, and only the others go to DpllTriadSimdSolver.
+//
+// The sweeps run until the last puzzle of the batch settles, so the engine pays off on
+// batches of easy puzzles, like most of the 17-clue ones (see no_guess % in the benchmark).
+//
+
+using namespace gudoku;
+
+namespace {
+
+template <int kSolutionMode, typename SliceT = BitVec16x16>
+class BitSliceSolver : public BasicSolver {
+public:
+    typedef BasicSolver                         basic_solver;
+    typedef BitSliceSolver                      this_type;
+    typedef SliceT                              slice_type;
+    typedef DpllTriadSimdSolver<kSolutionMode>  dpll_solver_t;
+
+    static const size_t kWords = sizeof(SliceT) / sizeof(uint64_t);
+    static const size_t kBatchSize = kWords * 64;
+
+private:
+    // cands_[cell][digit]: the puzzles where the digit is a candidate of the cell.
+    SliceT          cands_[81][9];
+    // The puzzles solved by the singles, and the ones they reject (with the lanes past
+    // the end of a partial batch).
+    SliceT          solved_;
+    SliceT          failed_;
+
+    dpll_solver_t   dpll_solver_;
+    size_t          num_sliced_;
+    size_t          num_sweeps_;
+
+public:
+    BitSliceSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : basic_solver(), dpll_solver_(use_huge_pages), num_sliced_(0), num_sweeps_(0) {
+        this->solved_.setAllZeros();
+        this->failed_.setAllZeros();
+    }
+    ~BitSliceSolver() {}
+
+    // The puzzles solved or rejected by the singles alone so far, without the search.
+    size_t get_num_sliced() const {
+        return this->num_sliced_;
+    }
+
+    // The sweeps run so far, over all the batches.
+    size_t get_num_sweeps() const {
+        return this->num_sweeps_;
+    }
+
+    // Failed-literal probing in the search of the puzzles the singles leave.
+    bool get_probing() const {
+        return this->dpll_solver_.get_probing();
+    }
+    void set_probing(bool probing) {
+        this->dpll_solver_.set_probing(probing);
+    }
+
+private:
+    //
+    // Transpose count (up to kBatchSize) puzzles, puzzle p at puzzles + p * stride: a given
+    // leaves its digit alone in its cell, an empty cell keeps all the 9 digits.
+    //
+    void loadBatch(const char * puzzles, size_t stride, size_t count) {
+        assert(count <= kBatchSize);
+        // The row 9 takes the characters that are not givens.
+        alignas(64) uint64_t givens[10][kWords];
+        for (size_t cell = 0; cell < Sudoku::BoardSize; cell++) {
+            std::memset(&givens[0][0], 0, sizeof(givens));
+            for (size_t p = 0; p < count; p++) {
+                uint32_t digit = (uint32_t)(uint8_t)puzzles[p * stride + cell] - (uint32_t)'1';
+                digit = (digit < 9) ? digit : 9;
+                givens[digit][p / 64] |= uint64_t(1) << (p % 64);
+            }
+
+            SliceT given[9];
+            SliceT any_given;
+            any_given.setAllZeros();
+            for (size_t digit = 0; digit < 9; digit++) {
+                given[digit].loadAligned(&givens[digit][0]);
+                any_given |= given[digit];
+            }
+            for (size_t digit = 0; digit < 9; digit++) {
+                this->cands_[cell][digit] = given[digit] | ~any_given;
+            }
+        }
+
+        alignas(64) uint64_t unused[kWords];
+        for (size_t w = 0; w < kWords; w++) {
+            size_t first = w * 64;
+            unused[w] = (count >= first + 64) ? 0 :
+                        ((count <= first) ? ~uint64_t(0) : (~uint64_t(0) << (count - first)));
+        }
+        this->failed_.loadAligned(&unused[0]);
+        this->solved_.setAllZeros();
+    }
+
+    //
+    // One sweep of the singles over the batch. Returns the puzzles whose candidates have
+    // changed; the puzzles whose cells were all solved (without a conflict) at the start of
+    // the sweep are added to solved_, the contradictions to failed_.
+    //
+    SliceT sweep() {
+        SliceT singles[81];
+        SliceT all_singles;
+        all_singles.setAllOnes();
+        SliceT failed = this->failed_;
+        for (size_t cell = 0; cell < Sudoku::BoardSize; cell++) {
+            SliceT once, twice;
+            once.setAllZeros();
+            twice.setAllZeros();
+            for (size_t digit = 0; digit < 9; digit++) {
+                const SliceT & cands = this->cands_[cell][digit];
+                twice |= once & cands;
+                once |= cands;
+            }
+            // No candidate left
+            failed |= ~once;
+            singles[cell] = once.and_not(twice);
+            all_singles &= singles[cell];
+        }
+
+        SliceT changed;
+        changed.setAllZeros();
+        for (size_t digit = 0; digit < 9; digit++) {
+            // Units 0 - 8: the rows, 9 - 17: the columns, 18 - 26: the boxes.
+            SliceT placed[27], once[27], twice[27];
+            for (size_t unit = 0; unit < 27; unit++) {
+                placed[unit].setAllZeros();
+                once[unit].setAllZeros();
+                twice[unit].setAllZeros();
+            }
+            SliceT placed_twice;
+            placed_twice.setAllZeros();
+
+            // The cells solved to the digit, and the number of cells left to it, by unit.
+            for (size_t row = 0; row < 9; row++) {
+                for (size_t col = 0; col < 9; col++) {
+                    size_t cell = row * 9 + col;
+                    size_t units[3] = { row, 9 + col, 18 + (row / 3) * 3 + (col / 3) };
+                    const SliceT & cands = this->cands_[cell][digit];
+                    SliceT single = cands & singles[cell];
+                    for (size_t i = 0; i < 3; i++) {
+                        size_t unit = units[i];
+                        placed_twice |= placed[unit] & single;
+                        placed[unit] |= single;
+                        twice[unit] |= once[unit] & cands;
+                        once[unit] |= cands;
+                    }
+                }
+            }
+            failed |= placed_twice;
+            for (size_t unit = 0; unit < 27; unit++) {
+                // No cell left to the digit
+                failed |= ~once[unit];
+                // Only one cell left
+                once[unit] = once[unit].and_not(twice[unit]);
+            }
+
+            for (size_t row = 0; row < 9; row++) {
+                for (size_t col = 0; col < 9; col++) {
+                    size_t cell = row * 9 + col;
+                    size_t box = 18 + (row / 3) * 3 + (col / 3);
+                    SliceT & cands = this->cands_[cell][digit];
+                    SliceT single = cands & singles[cell];
+
+                    // Naked singles: a peer solved to the digit
+                    SliceT eliminated = (placed[row] | placed[9 + col] | placed[box]).and_not(single) & cands;
+                    changed |= eliminated;
+                    cands = cands.and_not(eliminated);
+
+                    // Hidden singles: the only cell left to the digit in a unit
+                    SliceT hidden = (cands & (once[row] | once[9 + col] | once[box])).and_not(singles[cell]);
+                    if (!hidden.isAllZeros()) {
+                        changed |= hidden;
+                        for (size_t other = 0; other < 9; other++) {
+                            if (other != digit) {
+                                this->cands_[cell][other] = this->cands_[cell][other].and_not(hidden);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        this->failed_ = failed;
+        this->solved_ |= all_singles.and_not(failed);
+        return changed;
+    }
+
+    void propagate() {
+        for (;;) {
+            SliceT changed = this->sweep();
+            this->num_sweeps_++;
+            SliceT settled = this->solved_ | this->failed_;
+            if (settled.isAllOnes() || changed.and_not(settled).isAllZeros())
+                break;
+        }
+    }
+
+    // Write the solutions of the solved puzzles, solution p at solutions + p * stride.
+    void extractSolutions(char * solutions, size_t stride) const {
+        alignas(64) uint64_t bits[kWords];
+        for (size_t cell = 0; cell < Sudoku::BoardSize; cell++) {
+            for (size_t digit = 0; digit < 9; digit++) {
+                SliceT solved = this->cands_[cell][digit] & this->solved_;
+                solved.saveAligned(&bits[0]);
+                for (size_t w = 0; w < kWords; w++) {
+                    uint64_t mask = bits[w];
+                    while (mask != 0) {
+                        size_t p = w * 64 + BitUtils::bsf64(mask);
+                        solutions[p * stride + cell] = (char)('1' + digit);
+                        mask = BitUtils::clearLowBit64(mask);
+                    }
+                }
+            }
+        }
+    }
+
+    // Up to kBatchSize puzzles, see solveBatch().
+    size_t solveSlice(const char * puzzles, size_t puzzle_stride,
+                      char * solutions, size_t solution_stride,
+                      size_t count, size_t limit,
+                      size_t * num_solutions, size_t * num_guesses) {
+        this->loadBatch(puzzles, puzzle_stride, count);
+        this->propagate();
+        if (kSolutionMode == 1)
+            this->extractSolutions(solutions, solution_stride);
+
+        alignas(64) uint64_t solved[kWords];
+        alignas(64) uint64_t failed[kWords];
+        this->solved_.saveAligned(&solved[0]);
+        this->failed_.saveAligned(&failed[0]);
+
+        size_t num_solved = 0;
+        for (size_t p = 0; p < count; p++) {
+            uint64_t bit = uint64_t(1) << (p % 64);
+            size_t solutions_p, guesses_p = 0;
+            if ((solved[p / 64] & bit) != 0) {
+                solutions_p = 1;
+                this->num_sliced_++;
+            }
+            else if ((failed[p / 64] & bit) != 0) {
+                solutions_p = 0;
+                this->num_sliced_++;
+            }
+            else {
+                solutions_p = this->dpll_solver_.solve(puzzles + p * puzzle_stride,
+                                                       solutions + p * solution_stride, limit);
+                guesses_p = this->dpll_solver_.get_num_guesses();
+            }
+            if (num_solutions != nullptr)
+                num_solutions[p] = solutions_p;
+            if (num_guesses != nullptr)
+                num_guesses[p] = guesses_p;
+            this->num_guesses_ += guesses_p;
+            num_solved += (solutions_p != 0);
+        }
+        return num_solved;
+    }
+
+public:
+    //
+    // Solve count puzzles, kBatchSize at a time: puzzle i at puzzles + i * puzzle_stride,
+    // solution i (kSolutionMode == 1) written to solutions + i * solution_stride.
+    // num_solutions and num_guesses are optional arrays of count elements (may be nullptr).
+    // Returns the number of puzzles that have at least one solution.
+    //
+    size_t solveBatch(const char * puzzles, size_t puzzle_stride,
+                      char * solutions, size_t solution_stride,
+                      size_t count, size_t limit,
+                      size_t * num_solutions = nullptr, size_t * num_guesses = nullptr) {
+        this->set_num_guesses(0);
+        this->set_limit_solutions(limit);
+
+        size_t num_solved = 0;
+        for (size_t first = 0; first < count; first += kBatchSize) {
+            size_t slice_count = (std::min)((size_t)kBatchSize, count - first);
+            num_solved += this->solveSlice(puzzles + first * puzzle_stride, puzzle_stride,
+                                           solutions + first * solution_stride, solution_stride,
+                                           slice_count, limit,
+                                           (num_solutions != nullptr) ? (num_solutions + first) : nullptr,
+                                           (num_guesses != nullptr) ? (num_guesses + first) : nullptr);
+        }
+        this->set_num_solutions(num_solved);
+        return num_solved;
+    }
+
+    // One puzzle is not worth a batch: straight to the triad solver.
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        size_t solutions = this->dpll_solver_.solve(puzzle, solution, limit);
+        this->num_guesses_ = this->dpll_solver_.get_num_guesses();
+        this->num_solutions_ = solutions;
+        return solutions;
+    }
+
+    void display_result(Board & board, double elapsed_time,
+                        bool print_answer = true,
+                        bool print_all_answers = true) {
+        basic_solver::display_result<SearchMode::OneSolution>(board, elapsed_time,
+                                                              print_answer, print_all_answers);
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_BIT_SLICE_SOLVER_H
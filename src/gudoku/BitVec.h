@@ -1303,6 +1303,37 @@ struct BitVec08x16 {
 #endif
     }
 
+    //
+    // The 1-based position of the lowest set bit of every 16-bit lane, for lanes whose lowest
+    // set bit is below MaxBits (the number of a solved cell). A lane of 0 gives any value.
+    //
+    template <size_t MaxBits>
+    inline BitVec08x16 lowBitNumber16() const {
+        // x ^ (x - 1): the bits up to the lowest set bit
+        BitVec08x16 lowBits(_mm_xor_si128(this->m128, _mm_sub_epi16(this->m128, _mm_set1_epi16(1))));
+        return lowBits.popcount16<16, MaxBits>();
+    }
+
+    // The 16-bit lanes of this and of high narrowed to 16 bytes, unsigned saturated.
+    inline BitVec08x16 packU16(const BitVec08x16 & high) const {
+        return _mm_packus_epi16(this->m128, high.m128);
+    }
+
+    // The bytes 0 - 7 (or 8 - 15) of this and of high interleaved to 16-bit lanes, the low
+    // byte from this: the inverse of packU16() for bytes.
+    inline BitVec08x16 unpackLowU8(const BitVec08x16 & high) const {
+        return _mm_unpacklo_epi8(this->m128, high.m128);
+    }
+
+    inline BitVec08x16 unpackHighU8(const BitVec08x16 & high) const {
+        return _mm_unpackhi_epi8(this->m128, high.m128);
+    }
+
+    // The lowest set bit of every 8-bit lane.
+    inline BitVec08x16 getLowBit8() const {
+        return _mm_and_si128(this->m128, _mm_sub_epi8(_mm_setzero_si128(), this->m128));
+    }
+
     inline BitVec08x16 clearLowBit() const {
 #if defined(__SSE4_2__)
         __m128i cmp = _mm_cmpgt_epi64(this->m128, _mm_setzero_si128());
@@ -1340,6 +1371,14 @@ struct BitVec08x16 {
         return this->whichIsEqual(zeros);
     }
 
+    inline BitVec08x16 whichIsEqual8(const BitVec08x16 & other) const {
+        return _mm_cmpeq_epi8(this->m128, other.m128);
+    }
+
+    inline BitVec08x16 whichIsZeros8() const {
+        return _mm_cmpeq_epi8(this->m128, _mm_setzero_si128());
+    }
+
     inline BitVec08x16 whichIsOnes() const {
         BitVec08x16 ones;
         ones.setAllOnes();
@@ -2400,6 +2439,11 @@ struct BitVec16x16_SSE {
         return (this->low.isSubsetOf(other.low) && this->high.isSubsetOf(other.high));
     }
 
+    // The lowest set bit of every 16-bit lane.
+    inline BitVec16x16_SSE getLowBit() const {
+        return BitVec16x16_SSE(this->low.getLowBit(), this->high.getLowBit());
+    }
+
     inline BitVec16x16_SSE whichIsEqual(const BitVec16x16_SSE & other) const {
         return BitVec16x16_SSE(this->low.whichIsEqual(other.low), this->high.whichIsEqual(other.high));
     }
@@ -3591,6 +3635,11 @@ struct BitVec16x16_AVX {
         return (_mm256_testc_si256(other.m256, this->m256) == 1);
     }
 
+    // The lowest set bit of every 16-bit lane.
+    inline BitVec16x16_AVX getLowBit() const {
+        return _mm256_and_si256(this->m256, _mm256_sign_epi16(this->m256, _mm256_set1_epi16(-1)));
+    }
+
     inline BitVec16x16_AVX whichIsEqual(const BitVec16x16_AVX & other) const {
         return _mm256_cmpeq_epi16(this->m256, other.m256);
     }
@@ -3811,6 +3860,7 @@ struct BitVec16x16_AVX {
         #define CASE_LOW(x) case x: \
             low = _mm256_castsi256_si128(this->m256); \
             low = _mm_insert_epi16(low, (int)value, x); \
+            this->m256 = _mm256_inserti128_si256(this->m256, low, 0); \
             break;
         #define CASE_HIGH(x) case x: \
             high = _mm256_extracti128_si256(this->m256, 1); \
@@ -3937,7 +3987,7 @@ struct BitVec16x16_AVX {
 #elif defined(__AVX512VPOPCNTDQ__) && defined(__AVX512VL__)
         __m256i counts_64 = _mm256_popcnt_epi64(this->m256);
         BitVec16x16_SSE counts;
-        counts_64.castTo(counts);
+        BitVec16x16_AVX(counts_64).castTo(counts);
         return (_mm_cvtsi128_si64(counts.low.m128) + _mm_cvtsi128_si64(counts.high.m128) +
                 _mm_cvtsi128_si64(_mm_unpackhi_epi64(counts.low.m128, counts.low.m128)) +
                 _mm_cvtsi128_si64(_mm_unpackhi_epi64(counts.high.m128, counts.high.m128)));
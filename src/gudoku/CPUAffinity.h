@@ -0,0 +1,67 @@
+
+#ifndef JSTD_TEST_CPU_AFFINITY_H
+#define JSTD_TEST_CPU_AFFINITY_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>      // For sched_setaffinity(), sched_getcpu()
+#endif // _WIN32
+
+namespace test {
+namespace CPU {
+
+//
+// Pin the calling thread to one logical CPU, so a benchmark doesn't migrate between cores
+// (and their caches, and their clocks) in the middle of a run. Returns false if the CPU
+// doesn't exist, or the platform can't pin threads.
+//
+static
+bool pin_thread(int cpu)
+{
+    if (cpu < 0)
+        return false;
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    if (cpu >= (int)(sizeof(DWORD_PTR) * 8))
+        return false;
+    DWORD_PTR mask = (DWORD_PTR)1 << cpu;
+    return (::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0);
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return (::sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0);
+#else
+    return false;
+#endif
+}
+
+// The CPU the calling thread runs on, or -1 if unknown.
+static
+int current_cpu()
+{
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    return (int)::GetCurrentProcessorNumber();
+#elif defined(__linux__)
+    return ::sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+} // namespace CPU
+} // namespace test
+
+#endif // JSTD_TEST_CPU_AFFINITY_H
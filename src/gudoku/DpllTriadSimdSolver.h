@@ -19,15 +19,21 @@
 #include <vector>
 #include <bitset>
 #include <array>        // For std::array<T, Size>
+#include <atomic>
+#include <algorithm>    // For std::min()
 
 #define USE_ALIGN_AS    0
 
 #include "gudoku/BasicSolver.h"
 #include "gudoku/Sudoku.h"
+#include "gudoku/SudokuVariant.h"
 #include "gudoku/BitUtils.h"
 #include "gudoku/BitSet.h"
 #include "gudoku/BitArray.h"
 #include "gudoku/BitVec.h"
+#include "gudoku/StaticData.h"
+#include "gudoku/AlignedArena.h"
+#include "gudoku/gudoku.h"      // For GUDOKU_CONFIG_PROBING
 
 #ifndef ALIGN_AS
 #if USE_ALIGN_AS
@@ -115,7 +121,7 @@ union IntVec64 {
 //
 //  Each cell also has a minimum. So there are three sets of clauses represented here.
 //
-struct ALIGN_AS(32) Box {
+struct alignas(32) Box {
     BitVec16x16 cells;
 
     Box() noexcept : cells(BitVec16x16::full16(kAll)) {}
@@ -160,7 +166,7 @@ struct ALIGN_AS(32) Box {
 // is higher, and the benefit is lower (the benefit for Bands chiefly arises from the
 // way we do puzzle initialization).
 //
-struct ALIGN_AS(32) Band {
+struct alignas(32) Band {
     BitVec08x16 configurations;
     BitVec08x16 eliminations;
 
@@ -179,9 +185,20 @@ struct ALIGN_AS(32) Band {
     }
 };
 
-struct ALIGN_AS(32) State {
+//
+// State layout (64 byte aligned, 8 cache lines):
+//
+//   offset   0: bands[2][3]  6 x 32 bytes  (configurations, eliminations)
+//   offset 192: boxes[9]     9 x 32 bytes
+//   offset 480: padding     32 bytes
+//
+// Every Band and Box is one 32 byte aligned vector pair, so no vector access ever
+// splits a cache line, and each snapshot in the search arena starts on its own line.
+//
+struct alignas(64) State {
     Band bands[2][3];
     Box  boxes[9];
+    char reserved[32];
 
     State() noexcept {}
     State(const State & src) noexcept {
@@ -244,18 +261,15 @@ struct ALIGN_AS(32) State {
     }
 
     inline void copy(const State & other) {
-        this->bands[0][0].configurations = other.bands[0][0].configurations;
-        this->bands[0][0].eliminations = other.bands[0][0].eliminations;
-        this->bands[0][1].configurations = other.bands[0][1].configurations;;
-        this->bands[0][1].eliminations = other.bands[0][1].eliminations;;
-        this->bands[0][2].configurations = other.bands[0][2].configurations;;
-        this->bands[0][2].eliminations = other.bands[0][2].eliminations;;
-        this->bands[1][0].configurations = other.bands[1][0].configurations;;
-        this->bands[1][0].eliminations = other.bands[1][0].eliminations;;
-        this->bands[1][1].configurations = other.bands[1][1].configurations;;
-        this->bands[1][1].eliminations = other.bands[1][1].eliminations;;
-        this->bands[1][2].configurations = other.bands[1][2].configurations;;
-        this->bands[1][2].eliminations = other.bands[1][2].eliminations;;
+        // Each Band is a 32 byte aligned (configurations, eliminations) pair, so it's
+        // copied with one aligned 256 bit load/store instead of two 128 bit ones.
+        const char * src = (const char *)&other.bands[0][0];
+        char * dest = (char *)&this->bands[0][0];
+        for (size_t i = 0; i < 6; i++) {
+            BitVec16x16 band;
+            band.loadAligned((const void *)(src + i * sizeof(Band)));
+            band.saveAligned((void *)(dest + i * sizeof(Band)));
+        }
 
         this->copy_boxes(other);
     }
@@ -285,45 +299,13 @@ struct ALIGN_AS(32) State {
     }
 };
 
-#pragma pack(push, 1)
+static_assert((alignof(State) == 64), "State must be cache line aligned");
+static_assert((sizeof(State) == 512), "State must be padded to whole cache lines");
+static_assert((sizeof(Band) == 32) && (sizeof(Box) == 32), "Band and Box must be 32 bytes");
+static_assert((offsetof(State, boxes) == 192), "State::boxes must be 32 byte aligned");
 
-struct ALIGN_AS(32) BoxIndexing {
-    static const size_t BoxCellsX = Sudoku::BoxCellsX;      // 3
-    static const size_t BoxCellsY = Sudoku::BoxCellsY;      // 3
-    static const size_t BoxCountX = Sudoku::BoxCountX;      // 3
-    static const size_t BoxCountY = Sudoku::BoxCountY;      // 3
-    static const size_t MinNumber = Sudoku::MinNumber;      // 1
-    static const size_t MaxNumber = Sudoku::MaxNumber;      // 9
-
-    static const size_t Rows = Sudoku::Rows;
-    static const size_t Cols = Sudoku::Cols;
-    static const size_t Boxes = Sudoku::Boxes;
-    static const size_t BoxSize = Sudoku::BoxSize;
-    static const size_t Numbers = Sudoku::Numbers;
-
-    static const size_t BoardSize = Sudoku::BoardSize;
-    static const size_t TotalSize = Sudoku::TotalSize;
-
-    uint8_t box_x;
-    uint8_t box_y;
-    uint8_t box;
-    uint8_t cell_x;
-    uint8_t cell_y;
-    uint8_t cell;
-    uint8_t reserve1;
-    uint8_t reserve2;
-
-    BoxIndexing() noexcept {}
-
-    explicit BoxIndexing(uint32_t pos) noexcept
-        : box_x((uint8_t)((pos % Cols) / BoxCountX)), box_y((uint8_t)(pos / (Cols * BoxCellsY))),
-          box((uint8_t)(box_y * BoxCountX + box_x)),
-          cell_x((uint8_t)(pos % BoxCellsX)), cell_y((uint8_t)((pos / Cols) % BoxCellsY)),
-          cell((uint8_t)(cell_y * (BoxCellsX + 1) + cell_x)),
-          reserve1((uint8_t)0), reserve2((uint8_t)0) {}
-};
-
-#pragma pack(pop)
+// A box is 3 rows of 4 lanes in State.
+typedef BasicBoxIndexing<Sudoku, Sudoku::BoxCellsX + 1> BoxIndexing;
 
 //
 // We depend on low-level shuffle operations that address packed 8-bit integers, but we're
@@ -334,10 +316,55 @@ struct ALIGN_AS(32) BoxIndexing {
 static const uint16_t shuf00 = 0x0100, shuf01 = 0x0302, shuf02 = 0x0504, shuf03 = 0x0706;
 static const uint16_t shuf04 = 0x0908, shuf05 = 0X0B0A, shuf06 = 0X0D0C, shuf07 = 0X0F0E;
 
-struct ALIGN_AS(32) Tables {
+//   config       0       1       2       3       4       5
+//    elem      0 1 2   0 1 2   0 1 2   0 1 2   0 1 2   0 1 2
+//            +-------+-------+-------+-------+-------+-------+
+//   peer0    | X . . | . X . | . . X | . . X | X . . | . X . |
+//   peer1    | . X . | . . X | X . . | . X . | . . X | X . . |
+//   peer2    | . . X | X . . | . X . | X . . | . X . | . . X |
+//            +-------+-------+-------+-------+-------+-------+
+//
+// Tables for constructing band elimination messages from BitVec08x16 containing
+// positive or negative triad views of a box stored positions 4, 5, and 6.
+// each table has three shuffle control vectors, one for each of the band's box
+// peers. there are three tables, each corresponding to a rotation of elements
+// in the peer. look first at the shift0 table to see the correspondence with
+// the configuration diagram reproduced above.
+//
+static constexpr uint16_t kTriadsShiftToConfigElims[3][4][8] = {
+    // shift 0
+    {
+        { shuf04, shuf05, shuf06, shuf06, shuf04, shuf05, 0xFFFF, 0xFFFF },
+        { shuf05, shuf06, shuf04, shuf05, shuf06, shuf04, 0xFFFF, 0xFFFF },
+        { shuf06, shuf04, shuf05, shuf04, shuf05, shuf06, 0xFFFF, 0xFFFF },
+        {      0,      0,      0,      0,      0,      0,      0,      0 }
+    },
+    // shift 1
+    {
+        { shuf05, shuf06, shuf04, shuf04, shuf05, shuf06, 0xFFFF, 0xFFFF },
+        { shuf06, shuf04, shuf05, shuf06, shuf04, shuf05, 0xFFFF, 0xFFFF },
+        { shuf04, shuf05, shuf06, shuf05, shuf06, shuf04, 0xFFFF, 0xFFFF },
+        {      0,      0,      0,      0,      0,      0,      0,      0 }
+    },
+    // shift 2
+    {
+        { shuf06, shuf04, shuf05, shuf05, shuf06, shuf04, 0xFFFF, 0xFFFF },
+        { shuf04, shuf05, shuf06, shuf04, shuf05, shuf06, 0xFFFF, 0xFFFF },
+        { shuf05, shuf06, shuf04, shuf06, shuf04, shuf05, 0xFFFF, 0xFFFF },
+        {      0,      0,      0,      0,      0,      0,      0,      0 }
+    }
+};
+
+//
+// All the tables below are constant-initialized (see StaticData.h): the values that used
+// to be filled in by the constructor at static-init time are now computed by constexpr
+// functions of the flat table index, so the whole object is built by the compiler and
+// placed in read-only, cache line aligned storage.
+//
+struct alignas(64) Tables {
     // @formatter:off
     // Used when assigning a candidate during initialization
-    BitVec16x16 cell_assignment_eliminations[9][16];
+    ConstBitVec<BitVec16x16> cell_assignment_eliminations[9][16];
 
     //   config       0       1       2       3       4       5
     //    elem      0 1 2   0 1 2   0 1 2   0 1 2   0 1 2   0 1 2
@@ -350,72 +377,23 @@ struct ALIGN_AS(32) Tables {
     // A set of masks for eliminating band configurations inconsistent with the placement
     // of a digit in an element (minirow or minicol) of a box peer.
     //
-    const BitVec08x16 peer_x_elem_to_config_mask[3][4] = {
-        {
-            {    0,   kAll,   kAll,   kAll,      0,   kAll,    0,    0 },
-            { kAll,      0,   kAll,   kAll,   kAll,      0,    0,    0 },
-            { kAll,   kAll,      0,      0,   kAll,   kAll,    0,    0 },
-            {    0,      0,      0,      0,      0,      0,    0,    0 }
-        },                                                             
-        {                                                              
-            { kAll,   kAll,      0,   kAll,   kAll,      0,    0,    0 },
-            {    0,   kAll,   kAll,      0,   kAll,   kAll,    0,    0 },
-            { kAll,      0,   kAll,   kAll,      0,   kAll,    0,    0 },
-            {    0,      0,      0,      0,      0,      0,    0,    0 }
-        },                                                             
-        {                                                              
-            { kAll,      0,   kAll,      0,   kAll,   kAll,    0,    0 },
-            { kAll,   kAll,      0,   kAll,      0,   kAll,    0,    0 },
-            {    0,   kAll,   kAll,   kAll,   kAll,      0,    0,    0 },
-            {    0,      0,      0,      0,      0,      0,    0,    0 }
-        }
-    };
+    ConstBitVec<BitVec08x16> peer_x_elem_to_config_mask[3][4];
 
-    // tables for constructing band elimination messages from BitVec08x16 containing
-    // positive or negative triad views of a box stored positions 4, 5, and 6.
-    // each table has three shuffle control vectors, one for each of the band's box
-    // peers. there are three tables, each corresponding to a rotation of elements
-    // in the peer. look first at the shift0 table to see the correspondence with
-    // the configuration diagram reproduced above.
-    //
-    const BitVec08x16 triads_shift0_to_config_elims[4] = {
-        { shuf04, shuf05, shuf06, shuf06, shuf04, shuf05, 0xFFFF, 0xFFFF },
-        { shuf05, shuf06, shuf04, shuf05, shuf06, shuf04, 0xFFFF, 0xFFFF },
-        { shuf06, shuf04, shuf05, shuf04, shuf05, shuf06, 0xFFFF, 0xFFFF },
-        {      0,      0,      0,      0,      0,      0,      0,      0 }
-    };
-    const BitVec08x16 triads_shift1_to_config_elims[4] = {
-        { shuf05, shuf06, shuf04, shuf04, shuf05, shuf06, 0xFFFF, 0xFFFF },
-        { shuf06, shuf04, shuf05, shuf06, shuf04, shuf05, 0xFFFF, 0xFFFF },
-        { shuf04, shuf05, shuf06, shuf05, shuf06, shuf04, 0xFFFF, 0xFFFF },
-        {      0,      0,      0,      0,      0,      0,      0,      0 }
-    };
-    const BitVec08x16 triads_shift2_to_config_elims[4] = {
-        { shuf06, shuf04, shuf05, shuf05, shuf06, shuf04, 0xFFFF, 0xFFFF },
-        { shuf04, shuf05, shuf06, shuf04, shuf05, shuf06, 0xFFFF, 0xFFFF },
-        { shuf05, shuf06, shuf04, shuf06, shuf04, shuf05, 0xFFFF, 0xFFFF },
-        {      0,      0,      0,      0,      0,      0,      0,      0 }
-    };
+    // The rows of kTriadsShiftToConfigElims above.
+    ConstBitVec<BitVec08x16> triads_shift0_to_config_elims[4];
+    ConstBitVec<BitVec08x16> triads_shift1_to_config_elims[4];
+    ConstBitVec<BitVec08x16> triads_shift2_to_config_elims[4];
 
     // BitVec16x16 shuffle control vectors constructed from the 9 pairings of 3x3 vectors in
     // the tables above (because this makes access more efficient in AssertionsToEliminations).
-    BitVec16x16 triads_shift0_to_config_elims16[9] {};
-    BitVec16x16 triads_shift1_to_config_elims16[9] {};
-    BitVec16x16 triads_shift2_to_config_elims16[9] {};
+    ConstBitVec<BitVec16x16> triads_shift0_to_config_elims16[9];
+    ConstBitVec<BitVec16x16> triads_shift1_to_config_elims16[9];
+    ConstBitVec<BitVec16x16> triads_shift2_to_config_elims16[9];
 
     // two BitVec16x16 shuffle control vectors whose results are or'ed together to convert
     // a vector of configurations (reproduced across 128 bit lanes) into a 3x3 matrix of
     // positive triads (refer again to the configuration diagram above).
-    const BitVec16x16 shuffle_configs_to_triads[2] = {
-        {
-            BitVec08x16 { shuf00, shuf01, shuf02, 0xFFFF, shuf02, shuf00, shuf01, 0xFFFF },
-            BitVec08x16 { shuf01, shuf02, shuf00, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF }
-        },
-        {
-            BitVec08x16 { shuf04, shuf05, shuf03, 0xFFFF, shuf05, shuf03, shuf04, 0xFFFF },
-            BitVec08x16 { shuf03, shuf04, shuf05, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF }
-        }
-    };
+    ConstBitVec<BitVec16x16> shuffle_configs_to_triads[2];
 
     // two pairs of two BitVec16x16 shuffle control vectors whose results are or'ed together to
     // convert vectors of positive triads in positions 0, 1, and 2 (reproduced across 128 bit
@@ -423,176 +401,344 @@ struct ALIGN_AS(32) Tables {
     // negative triads are eliminated when band positive triads have been eliminated in the
     // other two shifted positions. the shuffled input has 0xFFFF in position 3 to allow a
     // no-op for triads with opposite orientation.
-    const BitVec16x16 pos_triads_to_candidates[2][2] = {
-        // horizontal
-        {
+    ConstBitVec<BitVec16x16> pos_triads_to_candidates[2][2];
+
+    ConstBitVec<BitVec16x16> cell3x3_mask;
+
+    // row rotation shuffle controls vectors for just the 3x3 submatrix of a BitVec16x16
+    ConstBitVec<BitVec16x16> row_rotate_3x3_1;
+    ConstBitVec<BitVec16x16> row_rotate_3x3_2;
+
+    ConstBitVec<BitVec08x16> one_value_mask[10];
+
+    uint16_t    digit_to_bitmask[128];
+    char        bitmask_to_digit[512];
+
+    int         box_base_tbl[16];
+    int         box_peers[2][3][3];
+    int         div3[9];
+    int         mod3[9];
+
+    BoxIndexing box_indexing[81];
+
+    // pshufb controls gathering the 27 digits of a band in row-major order from the packed
+    // digits (one byte per lane) of its 3 boxes: bytes 0 - 15 and bytes 11 - 26 of the band.
+    ConstBitVec<BitVec08x16> band_rows_shuffle[2][3];
+
+    // The inverse of band_rows_shuffle: pshufb controls gathering the characters of a box
+    // to the lanes of a box from bytes 0 - 15 and bytes 11 - 26 of a band of the puzzle.
+    ConstBitVec<BitVec08x16> band_boxes_shuffle[2][3];
+
+    // pshufb tables of the low and high bytes of the bitmask of a clue character, looked up
+    // by its low 4 bits: '1' - '9' to 1 << 0 - 1 << 8, and '0', ':' - '?' (or a 0) to 0.
+    // The characters outside '0' - '?' are cleared before the lookup.
+    ConstBitVec<BitVec08x16> clue_bitmask_bytes[2];
+    // @formatter:on
+
+    //
+    // For the cell i (0, 1, 2, | 4, 5, 6, | 8, 9, 10) of a box and a value, the lane j of the
+    // elimination mask. Only needed for cells, not triads.
+    //
+    static constexpr uint16_t cellAssignmentElimination(size_t value, size_t i, size_t j) {
+        return (((i % 4) == 3) || (i >= 12) || (j >= 15)) ? 0 :
+                // asserted cell: clear all bits but the one asserted
+               (j == i) ? (uint16_t)(kAll ^ (1u << value)) :
+                // conflict cell: clear the asserted bit
+               ((j / 4 < 3) && (j % 4 < 3)) ? (uint16_t)(1u << value) :
+                // clear 2 negative triads
+               ((j / 4 == i / 4) || (j % 4 == i % 4)) ? (uint16_t)(1u << value) : 0;
+    }
+
+    // box_idx = x * BoxCountY + y: the low half comes from x, the high half from y.
+    static constexpr uint16_t triadsToConfigElims16(size_t shift, size_t box_idx, size_t lane) {
+        return (lane < 8) ? kTriadsShiftToConfigElims[shift][box_idx / 3][lane]
+                          : kTriadsShiftToConfigElims[shift][box_idx % 3][lane - 8];
+    }
+
+    //
+    // The source byte of the byte k of the band part (0: the digits 0 - 15 of the band, 1:
+    // the digits 11 - 26) from the box of the band, or 0x80 (a zero) if it is in another box.
+    //
+    static constexpr uint16_t bandRowsByte(size_t part, size_t box, size_t k) {
+        return ((((part * 11 + k) % 9) / 3) == box) ?
+               (uint16_t)(((part * 11 + k) / 9) * 4 + (part * 11 + k) % 3) : (uint16_t)0x80;
+    }
+
+    static constexpr uint16_t bandRowsShuffle(size_t part, size_t box, size_t lane) {
+        return (uint16_t)(bandRowsByte(part, box, lane * 2) | (bandRowsByte(part, box, lane * 2 + 1) << 8));
+    }
+
+    template <size_t... CellElims, size_t... TriadElims, size_t... TriadElims16, size_t... Positions,
+              size_t... BandRows, size_t... DigitLanes>
+    static constexpr Tables make(IndexSequence<CellElims...>, IndexSequence<TriadElims...>,
+                                 IndexSequence<TriadElims16...>, IndexSequence<Positions...>,
+                                 IndexSequence<BandRows...>, IndexSequence<DigitLanes...>) {
+        return Tables {
+            // cell_assignment_eliminations[9][16]
+            { cellAssignmentElimination(CellElims / 256, (CellElims / 16) % 16, CellElims % 16)... },
+
+            // peer_x_elem_to_config_mask[3][4]
             {
-                BitVec08x16 { shuf00, shuf00, shuf00, shuf01, shuf01, shuf01, shuf01, shuf02 },
-                BitVec08x16 { shuf02, shuf02, shuf02, shuf00, shuf03, shuf03, shuf03, shuf03 }
+                {
+                    {    0,   kAll,   kAll,   kAll,      0,   kAll,    0,    0 },
+                    { kAll,      0,   kAll,   kAll,   kAll,      0,    0,    0 },
+                    { kAll,   kAll,      0,      0,   kAll,   kAll,    0,    0 },
+                    {    0,      0,      0,      0,      0,      0,    0,    0 }
+                },
+                {
+                    { kAll,   kAll,      0,   kAll,   kAll,      0,    0,    0 },
+                    {    0,   kAll,   kAll,      0,   kAll,   kAll,    0,    0 },
+                    { kAll,      0,   kAll,   kAll,      0,   kAll,    0,    0 },
+                    {    0,      0,      0,      0,      0,      0,    0,    0 }
+                },
+                {
+                    { kAll,      0,   kAll,      0,   kAll,   kAll,    0,    0 },
+                    { kAll,   kAll,      0,   kAll,      0,   kAll,    0,    0 },
+                    {    0,   kAll,   kAll,   kAll,   kAll,      0,    0,    0 },
+                    {    0,      0,      0,      0,      0,      0,    0,    0 }
+                }
             },
+
+            // triads_shift{0,1,2}_to_config_elims[4]
+            { kTriadsShiftToConfigElims[0][TriadElims / 8][TriadElims % 8]... },
+            { kTriadsShiftToConfigElims[1][TriadElims / 8][TriadElims % 8]... },
+            { kTriadsShiftToConfigElims[2][TriadElims / 8][TriadElims % 8]... },
+
+            // triads_shift{0,1,2}_to_config_elims16[9]
+            { triadsToConfigElims16(0, TriadElims16 / 16, TriadElims16 % 16)... },
+            { triadsToConfigElims16(1, TriadElims16 / 16, TriadElims16 % 16)... },
+            { triadsToConfigElims16(2, TriadElims16 / 16, TriadElims16 % 16)... },
+
+            // shuffle_configs_to_triads[2]
             {
-                BitVec08x16 { shuf00, shuf00, shuf00, shuf02, shuf01, shuf01, shuf01, shuf00 },
-                BitVec08x16 { shuf02, shuf02, shuf02, shuf01, shuf03, shuf03, shuf03, shuf03 }
-            }
-        },
-        // vertical
-        {
-            {
-                BitVec08x16 { shuf00, shuf01, shuf02, shuf03, shuf00, shuf01, shuf02, shuf03 },
-                BitVec08x16 { shuf00, shuf01, shuf02, shuf03, shuf01, shuf02, shuf00, shuf03 }
+                {
+                    shuf00, shuf01, shuf02, 0xFFFF, shuf02, shuf00, shuf01, 0xFFFF,
+                    shuf01, shuf02, shuf00, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF
+                },
+                {
+                    shuf04, shuf05, shuf03, 0xFFFF, shuf05, shuf03, shuf04, 0xFFFF,
+                    shuf03, shuf04, shuf05, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF
+                }
             },
+
+            // pos_triads_to_candidates[2][2]
             {
-                BitVec08x16 { shuf00, shuf01, shuf02, shuf03, shuf00, shuf01, shuf02, shuf03 },
-                BitVec08x16 { shuf00, shuf01, shuf02, shuf03, shuf02, shuf00, shuf01, shuf03 }
-            }
-        }
-    };
+                // horizontal
+                {
+                    {
+                        shuf00, shuf00, shuf00, shuf01, shuf01, shuf01, shuf01, shuf02,
+                        shuf02, shuf02, shuf02, shuf00, shuf03, shuf03, shuf03, shuf03
+                    },
+                    {
+                        shuf00, shuf00, shuf00, shuf02, shuf01, shuf01, shuf01, shuf00,
+                        shuf02, shuf02, shuf02, shuf01, shuf03, shuf03, shuf03, shuf03
+                    }
+                },
+                // vertical
+                {
+                    {
+                        shuf00, shuf01, shuf02, shuf03, shuf00, shuf01, shuf02, shuf03,
+                        shuf00, shuf01, shuf02, shuf03, shuf01, shuf02, shuf00, shuf03
+                    },
+                    {
+                        shuf00, shuf01, shuf02, shuf03, shuf00, shuf01, shuf02, shuf03,
+                        shuf00, shuf01, shuf02, shuf03, shuf02, shuf00, shuf01, shuf03
+                    }
+                }
+            },
 
-    const BitVec16x16 cell3x3_mask = BitVec16x16(
-        kAll, kAll, kAll,    0,
-        kAll, kAll, kAll,    0,
-        kAll, kAll, kAll,    0,
-            0,   0,    0,    0
-    );
+            // cell3x3_mask
+            {
+                kAll, kAll, kAll,    0,
+                kAll, kAll, kAll,    0,
+                kAll, kAll, kAll,    0,
+                   0,    0,    0,    0
+            },
 
-    // row rotation shuffle controls vectors for just the 3x3 submatrix of a BitVec16x16
-    const BitVec16x16 row_rotate_3x3_1 = BitVec16x16(
-        shuf01, shuf02, shuf00, shuf03, shuf05, shuf06, shuf04, shuf07,
-        shuf01, shuf02, shuf00, shuf03, shuf04, shuf05, shuf06, shuf07
-    );
-
-    const BitVec16x16 row_rotate_3x3_2 = BitVec16x16(
-        shuf02, shuf00, shuf01, shuf03, shuf06, shuf04, shuf05, shuf07,
-        shuf02, shuf00, shuf01, shuf03, shuf04, shuf05, shuf06, shuf07
-    );
-
-    const BitVec08x16 one_value_mask[10] = {
-        BitVec08x16::full16(1u << 0u), BitVec08x16::full16(1u << 1u), BitVec08x16::full16(1u << 2u),
-        BitVec08x16::full16(1u << 3u), BitVec08x16::full16(1u << 4u), BitVec08x16::full16(1u << 5u),
-        BitVec08x16::full16(1u << 6u), BitVec08x16::full16(1u << 7u), BitVec08x16::full16(1u << 8u),
-        BitVec08x16::full16(1u << 9u)
-    };
+            // row_rotate_3x3_1
+            {
+                shuf01, shuf02, shuf00, shuf03, shuf05, shuf06, shuf04, shuf07,
+                shuf01, shuf02, shuf00, shuf03, shuf04, shuf05, shuf06, shuf07
+            },
+            // row_rotate_3x3_2
+            {
+                shuf02, shuf00, shuf01, shuf03, shuf06, shuf04, shuf05, shuf07,
+                shuf02, shuf00, shuf01, shuf03, shuf04, shuf05, shuf06, shuf07
+            },
 
-#if 0
-    const BitVec08x16 digit_bitmask_tbl[10] = {
-        BitVec08x16::full16(0), BitVec08x16::full16(1), BitVec08x16::full16(2),
-        BitVec08x16::full16(4), BitVec08x16::full16(8), BitVec08x16::full16(16),
-        BitVec08x16::full16(32), BitVec08x16::full16(64), BitVec08x16::full16(128),
-        BitVec08x16::full16(256)
-    };
-#endif
+            // one_value_mask[10]
+            {
+                { 1u << 0u, 1u << 0u, 1u << 0u, 1u << 0u, 1u << 0u, 1u << 0u, 1u << 0u, 1u << 0u },
+                { 1u << 1u, 1u << 1u, 1u << 1u, 1u << 1u, 1u << 1u, 1u << 1u, 1u << 1u, 1u << 1u },
+                { 1u << 2u, 1u << 2u, 1u << 2u, 1u << 2u, 1u << 2u, 1u << 2u, 1u << 2u, 1u << 2u },
+                { 1u << 3u, 1u << 3u, 1u << 3u, 1u << 3u, 1u << 3u, 1u << 3u, 1u << 3u, 1u << 3u },
+                { 1u << 4u, 1u << 4u, 1u << 4u, 1u << 4u, 1u << 4u, 1u << 4u, 1u << 4u, 1u << 4u },
+                { 1u << 5u, 1u << 5u, 1u << 5u, 1u << 5u, 1u << 5u, 1u << 5u, 1u << 5u, 1u << 5u },
+                { 1u << 6u, 1u << 6u, 1u << 6u, 1u << 6u, 1u << 6u, 1u << 6u, 1u << 6u, 1u << 6u },
+                { 1u << 7u, 1u << 7u, 1u << 7u, 1u << 7u, 1u << 7u, 1u << 7u, 1u << 7u, 1u << 7u },
+                { 1u << 8u, 1u << 8u, 1u << 8u, 1u << 8u, 1u << 8u, 1u << 8u, 1u << 8u, 1u << 8u },
+                { 1u << 9u, 1u << 9u, 1u << 9u, 1u << 9u, 1u << 9u, 1u << 9u, 1u << 9u, 1u << 9u }
+            },
 
-    const uint16_t digit_to_bitmask[128] = {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 00
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 10
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 20
-        0, 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 0, 0, 0, 0, 0,     // 30
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 40
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 50
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 60
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 70
-    };
+            // digit_to_bitmask[128]
+            {
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 00
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 10
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 20
+                0, 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 0, 0, 0, 0, 0,     // 30
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 40
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 50
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 60
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // 70
+            },
 
-    const char bitmask_to_digit[512] = {
-        '0', '1', '2',  0 , '3',  0 ,  0 ,  0 , '4',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 000
-        '5',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 010
-        '6',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 020
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 030
-        '7',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 040
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 050
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 060
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 070
-
-        '8',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 080
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 090
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0A0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0B0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0C0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0D0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0E0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0F0
-
-        '9',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 100
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 110
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 120
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 130
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 140
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 150
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 160
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 170
-
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 180
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 190
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1A0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1B0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1C0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1D0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1E0
-         0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1F0
-    };
+            // bitmask_to_digit[512]
+            {
+                '0', '1', '2',  0 , '3',  0 ,  0 ,  0 , '4',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 000
+                '5',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 010
+                '6',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 020
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 030
+                '7',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 040
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 050
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 060
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 070
+
+                '8',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 080
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 090
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0A0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0B0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0C0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0D0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0E0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 0F0
+
+                '9',  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 100
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 110
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 120
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 130
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 140
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 150
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 160
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 170
+
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 180
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 190
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1A0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1B0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1C0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1D0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1E0
+                 0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,  0 ,     // 1F0
+            },
 
-    const int box_base_tbl[16] = {
-        0, 3, 6, 27, 30, 33, 54, 57, 60, 0, 0, 0, 0, 0, 0, 0
-    };
+            // box_base_tbl[16]
+            {
+                0, 3, 6, 27, 30, 33, 54, 57, 60, 0, 0, 0, 0, 0, 0, 0
+            },
 
-    const int box_peers[2][3][3] = {
-        {
-            { 0, 1, 2 }, { 3, 4, 5 }, { 6, 7, 8 }
-        },
-        {
-            { 0, 3, 6 }, { 1, 4, 7 }, { 2, 5, 8 }
-        }
-    };
-    const int div3[9] = { 0, 0, 0, 1, 1, 1, 2, 2, 2 };
-    const int mod3[9] = { 0, 1, 2, 0, 1, 2, 0, 1, 2 };
+            // box_peers[2][3][3]
+            {
+                {
+                    { 0, 1, 2 }, { 3, 4, 5 }, { 6, 7, 8 }
+                },
+                {
+                    { 0, 3, 6 }, { 1, 4, 7 }, { 2, 5, 8 }
+                }
+            },
+            // div3[9]
+            { 0, 0, 0, 1, 1, 1, 2, 2, 2 },
+            // mod3[9]
+            { 0, 1, 2, 0, 1, 2, 0, 1, 2 },
 
-    BoxIndexing box_indexing[81];
+            // box_indexing[81]
+            { BoxIndexing((uint32_t)Positions)... },
 
-    Tables() noexcept {
-        // 0, 1, 2, | 4, 5, 6, | 8, 9, 10
-        for (int i = 0; i < 12; i++) {
-            if ((i % 4) == 3) continue;
-            // only need for cells, not triads
-            for (uint32_t value = 0; value < 9; value++) {
-                BitVec16x16 & mask = cell_assignment_eliminations[value][i];
-                for (int j = 0; j < 15; j++) {
-                    if (j == i) {
-                        // asserted cell: clear all bits but the one asserted
-                        mask.insert(j, kAll ^ (1u << value));
-                    }
-                    else if (j / 4 < 3 && j % 4 < 3) {
-                        // conflict cell: clear the asserted bit
-                        mask.insert(j, 1u << value);
-                    }
-                    else if (j / 4 == i / 4 || j % 4 == i % 4) {
-                        // clear 2 negative triads
-                        mask.insert(j, 1u << value);
-                    }
-                }
-            }
-        }
+            // band_rows_shuffle[2][3]
+            { bandRowsShuffle(BandRows / 24, (BandRows / 8) % 3, BandRows % 8)... },
 
-        for (int x = 0; x < (int)Sudoku::BoxCountX; x++) {
-            for (int y = 0; y < (int)Sudoku::BoxCountY; y++) {
-                int box_idx = x * (int)Sudoku::BoxCountY + y;
-                triads_shift0_to_config_elims16[box_idx] =
-                        BitVec16x16{triads_shift0_to_config_elims[x], triads_shift0_to_config_elims[y]};
-                triads_shift1_to_config_elims16[box_idx] =
-                        BitVec16x16{triads_shift1_to_config_elims[x], triads_shift1_to_config_elims[y]};
-                triads_shift2_to_config_elims16[box_idx] =
-                        BitVec16x16{triads_shift2_to_config_elims[x], triads_shift2_to_config_elims[y]};
-            }
-        }
+            // band_boxes_shuffle[2][3]
+            { bandBoxesShuffle(BandRows / 24, (BandRows / 8) % 3, BandRows % 8)... },
 
-        for (uint32_t pos = 0; pos < 81; pos++) {
-            box_indexing[pos] = BoxIndexing(pos);
-        }
+            // clue_bitmask_bytes[2]
+            { digitBitmaskBytes(DigitLanes / 8, DigitLanes % 8)... }
+        };
     }
 };
 
-const Tables tables {};
+static constexpr Tables tables = Tables::make(MakeIndexSequence<9 * 16 * 16>::type(),
+                                              MakeIndexSequence<4 * 8>::type(),
+                                              MakeIndexSequence<9 * 16>::type(),
+                                              MakeIndexSequence<81>::type(),
+                                              MakeIndexSequence<2 * 3 * 8>::type(),
+                                              MakeIndexSequence<2 * 8>::type());
 
-template <int kSolutionMode>
+static_assert((sizeof(Tables) % 64) == 0, "Tables must be padded to whole cache lines");
+static_assert(sizeof(BoxIndexing) == 8, "BoxIndexing must be packed to 8 bytes");
+
+//
+// The extra units of a sudoku variant (see SudokuVariant.h) in the box layout of State:
+// for a unit and a box, 0xFFFF in the lanes of the cells of the unit. The vanilla sudoku
+// has no extra units, its tables hold one empty unit.
+//
+template <typename Variant>
+struct ExtraUnitTables {
+    static const size_t kUnits = (Variant::kUnits != 0) ? Variant::kUnits : 1;
+
+    // @formatter:off
+    ConstBitVec<BitVec16x16> unit_lanes[kUnits][9];
+
+    // For a box, a bit for each extra unit with cells in it.
+    uint32_t    box_units[9];
+    // For an extra unit, a bit for each box with cells of it.
+    uint32_t    unit_boxes[kUnits];
+    // @formatter:on
+
+    static constexpr uint16_t unitLane(size_t unit, size_t box, size_t lane) {
+        return (((lane % 4) != 3) && ((lane / 4) != 3) && (unit < Variant::kUnits) &&
+                Variant::inUnit(unit, box / 3 * 3 + lane / 4, box % 3 * 3 + lane % 4)) ? 0xFFFF : 0;
+    }
+
+    static constexpr bool hasUnitCells(size_t unit, size_t box, size_t lane = 0) {
+        return (lane < 16) && ((unitLane(unit, box, lane) != 0) || hasUnitCells(unit, box, lane + 1));
+    }
+
+    static constexpr uint32_t boxUnits(size_t box, size_t unit = 0) {
+        return (unit < Variant::kUnits) ?
+               ((hasUnitCells(unit, box) ? (1U << unit) : 0U) | boxUnits(box, unit + 1)) : 0U;
+    }
+
+    static constexpr uint32_t unitBoxes(size_t unit, size_t box = 0) {
+        return (box < 9) ?
+               ((hasUnitCells(unit, box) ? (1U << box) : 0U) | unitBoxes(unit, box + 1)) : 0U;
+    }
+
+    template <size_t... Lanes, size_t... Boxes, size_t... Units>
+    static constexpr ExtraUnitTables make(IndexSequence<Lanes...>, IndexSequence<Boxes...>,
+                                          IndexSequence<Units...>) {
+        return ExtraUnitTables {
+            // unit_lanes[kUnits][9]
+            { unitLane(Lanes / (9 * 16), (Lanes / 16) % 9, Lanes % 16)... },
+            // box_units[9]
+            { boxUnits(Boxes)... },
+            // unit_boxes[kUnits]
+            { unitBoxes(Units)... }
+        };
+    }
+
+    static const ExtraUnitTables & get() {
+        static constexpr ExtraUnitTables tables = make(typename MakeIndexSequence<kUnits * 9 * 16>::type(),
+                                                       typename MakeIndexSequence<9>::type(),
+                                                       typename MakeIndexSequence<kUnits>::type());
+        return tables;
+    }
+};
+
+//
+// The variant is a policy (see SudokuVariant.h): its extra units are checked by a pass
+// that boxRestrict() runs when a box changes the candidates of the unit cells in it, and
+// the vanilla sudoku, without extra units, compiles the pass away.
+//
+template <int kSolutionMode, typename Variant = VanillaSudoku>
 class ALIGN_AS(32) DpllTriadSimdSolver : public BasicSolver {
 public:
     typedef BasicSolver                 basic_solver;
@@ -643,21 +789,90 @@ public:
     static const uint32_t kBand1RowBits  = 0070;
     static const uint32_t kBand2RowBits  = 0700;
 
-private:
-#if USE_ALIGN_AS
-    State state_;
-#endif
+    //
+    // Each branch takes a snapshot one level deeper and eliminates at least one band
+    // configuration in each of its two arms, so the search depth is bounded by the
+    // number of configurations: 2 orientations x 3 bands x 9 values x 6 configurations.
+    //
+    static const size_t kMaxSearchDepth = 2 * 3 * 9 * 6;
+
+    typedef Variant                     variant_type;
+    typedef ExtraUnitTables<Variant>    extra_tables_type;
+
+    static const bool kHasExtraUnits = (Variant::kUnits != 0);
+
+protected:
     State result_state_;
+    // states_[0] is the root state, states_[depth] the snapshot taken at that depth.
+    AlignedArena<State> states_;
+    // Failed-literal probing before every branch, see probeBandAndValueToBranch().
+    bool                probing_;
+    size_t              num_failed_literals_;
+    // Randomized value and configuration order (0 is off), see set_random_seed().
+    uint64_t            random_state_;
+    // A search stops early when it makes guess_budget_ guesses or cancel_ is set, which is
+    // polled every kCancelPollGuesses guesses; guess_check_ is the next guess count to look.
+    size_t              guess_budget_;
+    size_t              guess_check_;
+    const std::atomic<bool> * cancel_;
+    bool                aborted_;
+
+    static const size_t kCancelPollGuesses = 16;
 
 public:
-#if USE_ALIGN_AS
-    DpllTriadSimdSolver() : basic_solver(), state_(), result_state_() {}
-#else
-    DpllTriadSimdSolver() : basic_solver(), result_state_() {}
-#endif
+    DpllTriadSimdSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : basic_solver(), result_state_(), states_(kMaxSearchDepth + 1, use_huge_pages),
+          probing_(false), num_failed_literals_(0), random_state_(0),
+          guess_budget_(SIZE_MAX), guess_check_(SIZE_MAX), cancel_(nullptr), aborted_(false) {}
     ~DpllTriadSimdSolver() {}
 
-private:
+    bool use_huge_pages() const {
+        return this->states_.huge_pages();
+    }
+
+    bool get_probing() const {
+        return this->probing_;
+    }
+    void set_probing(bool probing) {
+        this->probing_ = probing;
+    }
+
+    // The band configurations the probing of the last solve() has proven impossible.
+    size_t get_num_failed_literals() const {
+        return this->num_failed_literals_;
+    }
+
+    //
+    // A nonzero seed breaks the ties between the values of the band to branch on and picks
+    // the configuration tried first at random, 0 is the plain deterministic order.
+    //
+    void set_random_seed(uint64_t seed) {
+        this->random_state_ = seed;
+    }
+
+    //
+    // The search stops early once it has made this many guesses (SIZE_MAX: never), or once
+    // the cancel flag (may be nullptr) is set by another thread. Then aborted() is true and
+    // the solution count is a lower bound, unless it reached the limit.
+    //
+    void set_guess_budget(size_t guess_budget) {
+        this->guess_budget_ = guess_budget;
+    }
+    void set_cancel_flag(const std::atomic<bool> * cancel) {
+        this->cancel_ = cancel;
+    }
+    bool aborted() const {
+        return this->aborted_;
+    }
+
+protected:
+    JSTD_FORCED_INLINE
+    State & nextSnapshot(State & state) {
+        assert(&state >= this->states_.data());
+        assert(&state < (this->states_.data() + kMaxSearchDepth));
+        return *(&state + 1);
+    }
+
     // Restrict the cell, minirow, and minicol clauses of the box to contain only the given
     // cell and triad candidates.
     template <int from_vertical>
@@ -669,6 +884,7 @@ private:
 
         int box_x = tables.mod3[box_idx];
         int box_y = tables.div3[box_idx];
+        BitVec16x16 old_cells = box.cells;
 
         Band & h_band = state.bands[0][box_y];
         Band & v_band = state.bands[1][box_x];
@@ -693,16 +909,104 @@ private:
                                      h_band.eliminations, v_band.eliminations);
 
         } while (eliminating.hasIntersects(box.cells));
+        BitVec16x16 changed = old_cells.and_not(box.cells);
 
         // Send elimination messages to horizontal and vertical peers. Prefer to send the first
         // of these messages to the peer whose orientation is opposite that of the inbound peer.
+        bool valid;
         if (from_vertical) {
-            return (bandEliminate<kHorizontal>(state, box_y, box_x) &&
-                    bandEliminate<kVertical>  (state, box_x, box_y));
+            valid = (bandEliminate<kHorizontal>(state, box_y, box_x) &&
+                     bandEliminate<kVertical>  (state, box_x, box_y));
         } else {
-            return (bandEliminate<kVertical>  (state, box_x, box_y) &&
-                    bandEliminate<kHorizontal>(state, box_y, box_x));
+            valid = (bandEliminate<kVertical>  (state, box_x, box_y) &&
+                     bandEliminate<kHorizontal>(state, box_y, box_x));
+        }
+
+        // And to the extra units of the variant whose cells in this box have changed.
+        if (kHasExtraUnits && valid) {
+            const extra_tables_type & extra = extra_tables_type::get();
+            uint32_t units = extra.box_units[box_idx];
+            while (units != 0) {
+                uint32_t unit = BitUtils::bsf32(units);
+                if (changed.hasIntersects(extra.unit_lanes[unit][box_idx])) {
+                    if (!unitEliminate(state, unit)) return false;
+                }
+                units = BitUtils::clearLowBit32(units);
+            }
+        }
+        return valid;
+    }
+
+    //
+    // The singles of an extra unit of the variant: a digit solved in a cell of the unit is
+    // eliminated from its other cells, and a digit left with one cell of the unit is placed
+    // there. Returns false if a digit is solved twice in the unit, or has no cell left.
+    //
+    static bool unitEliminate(State & state, uint32_t unit) {
+        const extra_tables_type & extra = extra_tables_type::get();
+
+        // Count the digits lane by lane over the boxes (each lane of each box is a distinct
+        // cell), then over the lanes.
+        BitVec16x16 once, twice, solved_once, solved_twice;
+        once.setAllZeros();
+        twice.setAllZeros();
+        solved_once.setAllZeros();
+        solved_twice.setAllZeros();
+
+        uint32_t boxes = extra.unit_boxes[unit];
+        while (boxes != 0) {
+            uint32_t box_idx = BitUtils::bsf32(boxes);
+            BitVec16x16 cells = state.boxes[box_idx].cells & extra.unit_lanes[unit][box_idx];
+            BitVec16x16 solved = cells & cells.whichIsEqual(cells.getLowBit());
+            unitAccumulate(once, twice, cells);
+            unitAccumulate(solved_once, solved_twice, solved);
+            boxes = BitUtils::clearLowBit32(boxes);
+        }
+        unitReduceLanes(once, twice);
+        unitReduceLanes(solved_once, solved_twice);
+
+        if (!solved_twice.isAllZeros()) return false;
+        if (!BitVec16x16::full16(kAll).isSubsetOf(once)) return false;
+
+        BitVec16x16 hidden = once.and_not(twice).and_not(solved_once);
+
+        boxes = extra.unit_boxes[unit];
+        while (boxes != 0) {
+            uint32_t box_idx = BitUtils::bsf32(boxes);
+            BitVec16x16 lanes = extra.unit_lanes[unit][box_idx];
+            BitVec16x16 cells = state.boxes[box_idx].cells;
+            BitVec16x16 unsolved = lanes.and_not(cells.whichIsEqual(cells.getLowBit()));
+            BitVec16x16 placed = cells & hidden & lanes;
+            BitVec16x16 candidates = (placed | placed.whichIsZeros()).and_not(solved_once & unsolved);
+            if (!boxRestrict<kHorizontal>(state, (int)box_idx, candidates)) return false;
+            boxes = BitUtils::clearLowBit32(boxes);
         }
+        return true;
+    }
+
+    static
+    JSTD_FORCED_INLINE
+    void unitAccumulate(BitVec16x16 & once, BitVec16x16 & twice, const BitVec16x16 & cells) {
+        twice |= once & cells;
+        once |= cells;
+    }
+
+    static
+    JSTD_FORCED_INLINE
+    void unitCombine(BitVec16x16 & once, BitVec16x16 & twice,
+                     const BitVec16x16 & once2, const BitVec16x16 & twice2) {
+        twice = twice | twice2 | (once & once2);
+        once = once | once2;
+    }
+
+    // Reduce the (once, twice) counts of the 16 lanes, the result is in all of them.
+    static
+    JSTD_FORCED_INLINE
+    void unitReduceLanes(BitVec16x16 & once, BitVec16x16 & twice) {
+        unitCombine(once, twice, once.rotateRows(), twice.rotateRows());
+        unitCombine(once, twice, once.rotateRows2(), twice.rotateRows2());
+        unitCombine(once, twice, once.rotateCols(), twice.rotateCols());
+        unitCombine(once, twice, once.rotateCols2(), twice.rotateCols2());
     }
 
     // input BitVec16x16 contains zeros where nothing is asserted, a single candidate for regular cells
@@ -865,10 +1169,26 @@ private:
 
     static const uint32_t NONE = UINT32_MAX;
 
+    //
+    // The lowest of the values, or with a nonzero rotate the first one at or after the
+    // value rotate, cyclically (the tie-breaking of the randomized search).
+    //
+    static
+    JSTD_FORCED_INLINE
+    BitVec08x16 lowValue(const BitVec08x16 & values, uint32_t rotate) {
+        if (likely(rotate == 0)) return values.getLowBit();
+        alignas(16) uint16_t lanes[8];
+        values.saveAligned(&lanes[0]);
+        uint32_t mask = lanes[0];
+        uint32_t rotated = ((mask >> rotate) | (mask << (Numbers - rotate))) & kAllNumberBits;
+        uint32_t value = (BitUtils::bsf32(rotated) + rotate) % Numbers;
+        return tables.one_value_mask[value];
+    }
+
     static
     JSTD_FORCED_INLINE
     std::pair<uint32_t, BitVec08x16>
-    chooseBandAndValueToBranch(const State & state) {
+    chooseBandAndValueToBranch(const State & state, uint32_t rotate = 0) {
         uint32_t best_band = NONE, best_band_count = NONE;
         uint32_t best_value = NONE, best_value_count = NONE;
 
@@ -923,33 +1243,172 @@ private:
 
             BitVec08x16 only_two = two.and_not(three);
             if (!likely(only_two.isAllZeros())) {
-                return { best_band, only_two.getLowBit() };
+                return { best_band, lowValue(only_two, rotate) };
             } else {
                 BitVec08x16 only_three = three.and_not(four);
                 if (likely(!only_three.isAllZeros())) {
-                    return { best_band, only_three.getLowBit() };
+                    return { best_band, lowValue(only_three, rotate) };
                 } else {
-                    return { best_band, four.getLowBit() };
+                    return { best_band, lowValue(four, rotate) };
                 }
             }
         }
         return { best_band, BitVec08x16::full16(0) };
     }
 
+    static
+    JSTD_FORCED_INLINE
+    bool bandEliminate(State & state, uint32_t vertical, uint32_t band_idx) {
+        if (vertical == kHorizontal)
+            return bandEliminate<kHorizontal>(state, (int)band_idx);
+        else
+            return bandEliminate<kVertical>(state, (int)band_idx);
+    }
+
+    static JSTD_FORCED_INLINE
+    uint32_t totalConfigurations(const State & state) {
+        return (uint32_t)(state.bands[0][0].configurations.popcount() +
+                          state.bands[0][1].configurations.popcount() +
+                          state.bands[0][2].configurations.popcount() +
+                          state.bands[1][0].configurations.popcount() +
+                          state.bands[1][1].configurations.popcount() +
+                          state.bands[1][2].configurations.popcount());
+    }
+
+    static const uint32_t CONFLICT = UINT32_MAX - 1;
+    static const size_t kMaxProbeValues = 3;
+
+    //
+    // Failed-literal probing. The band chooseBandAndValueToBranch() picks and up to
+    // kMaxProbeValues of its values with the fewest configurations are tried one
+    // configuration at a time on the next snapshot (the scratch the branch overwrites
+    // anyway). A configuration whose bandEliminate() fails is eliminated from the state
+    // right away and the choice starts over; otherwise the value whose configurations
+    // leave the fewest band configurations in total is the branch. Returns CONFLICT if
+    // the eliminations leave the state without a solution.
+    //
+    std::pair<uint32_t, BitVec08x16>
+    probeBandAndValueToBranch(State & state) {
+        State & scratch = this->nextSnapshot(state);
+        for (;;) {
+            auto band_and_value = chooseBandAndValueToBranch(state);
+            if (band_and_value.first == NONE) return band_and_value;
+
+            uint32_t vertical = (band_and_value.first < 3) ? (uint32_t)kHorizontal : (uint32_t)kVertical;
+            uint32_t band_idx = tables.mod3[band_and_value.first];
+            Band & band = state.bands[vertical][band_idx];
+
+            // The values of the band by number of configurations, the chosen one first.
+            alignas(16) uint16_t configurations[8];
+            alignas(16) uint16_t value_mask[8];
+            band.configurations.saveAligned(&configurations[0]);
+            band_and_value.second.saveAligned(&value_mask[0]);
+            uint32_t chosen_value = BitUtils::bsf32((uint32_t)value_mask[0]);
+            uint32_t counts[Numbers];
+            for (uint32_t value = 0; value < Numbers; value++) {
+                uint32_t count = 0;
+                for (uint32_t i = 0; i < 6; i++) {
+                    count += (configurations[i] >> value) & 1u;
+                }
+                counts[value] = count;
+            }
+            uint32_t values[kMaxProbeValues];
+            size_t num_values = 0;
+            values[num_values++] = chosen_value;
+            for (uint32_t value = 0; value < Numbers && num_values < kMaxProbeValues; value++) {
+                if (value != chosen_value && counts[value] >= 2 && counts[value] <= counts[chosen_value])
+                    values[num_values++] = value;
+            }
+
+            bool failed_literal = false;
+            uint32_t best_value = chosen_value, best_score = UINT32_MAX;
+            for (size_t n = 0; n < num_values && !failed_literal; n++) {
+                BitVec08x16 value_configurations = band.configurations & tables.one_value_mask[values[n]];
+                BitVec08x16 remaining = value_configurations;
+                uint32_t score = 0;
+                while (!remaining.isAllZeros()) {
+                    BitVec08x16 rest = remaining.clearLowBit();
+                    BitVec08x16 configuration = remaining ^ rest;
+                    remaining = rest;
+
+                    scratch.copy(state);
+                    scratch.bands[vertical][band_idx].eliminations |= (value_configurations ^ configuration);
+                    if (bandEliminate(scratch, vertical, band_idx)) {
+                        score += totalConfigurations(scratch);
+                    } else {
+                        // No solution with this configuration: eliminate it for good.
+                        this->num_failed_literals_++;
+                        band.eliminations |= configuration;
+                        if (!bandEliminate(state, vertical, band_idx))
+                            return { (uint32_t)CONFLICT, BitVec08x16::full16(0) };
+                        failed_literal = true;
+                        break;
+                    }
+                }
+                if (!failed_literal && score < best_score) {
+                    best_score = score;
+                    best_value = values[n];
+                }
+            }
+
+            if (!failed_literal)
+                return { band_and_value.first, tables.one_value_mask[best_value].get() };
+        }
+    }
+
+    // xorshift64, random_state_ is never 0 while it's on.
+    JSTD_FORCED_INLINE
+    uint64_t nextRandom() {
+        uint64_t x = this->random_state_;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        this->random_state_ = x;
+        return x;
+    }
+
+    JSTD_FORCED_INLINE
+    uint32_t valueRotation() {
+        return likely(this->random_state_ == 0) ? 0 : (uint32_t)(this->nextRandom() % Numbers);
+    }
+
+    // Whether the search goes on, at every guess_check_ guesses.
+    JSTD_NO_INLINE
+    bool continueSearch() {
+        if (this->num_guesses_ >= this->guess_budget_ ||
+            (this->cancel_ != nullptr && this->cancel_->load(std::memory_order_relaxed))) {
+            this->aborted_ = true;
+            return false;
+        }
+        this->guess_check_ = (this->cancel_ != nullptr) ?
+            (std::min)(this->guess_budget_, this->num_guesses_ + kCancelPollGuesses) : this->guess_budget_;
+        return true;
+    }
+
     template <int vertical>
     JSTD_FORCED_INLINE
     void branchOnBandAndValue(int band_idx, const BitVec08x16 & value_mask, State & state) {
+        if (unlikely(this->num_guesses_ >= this->guess_check_) && !this->continueSearch()) return;
+
         Band & band = state.bands[vertical][band_idx];
         // We enter with two or more possible configurations for this value
         BitVec08x16 value_configurations = band.configurations & value_mask;
+        BitVec08x16 assignment_elims = value_configurations.clearLowBit();
+        if (unlikely(this->random_state_ != 0)) {
+            // Any of the configurations first, not just the lowest one.
+            uint32_t skip = (uint32_t)(this->nextRandom() % (uint64_t)value_configurations.popcount());
+            BitVec08x16 rest = value_configurations;
+            for (uint32_t i = 0; i < skip; i++) rest = rest.clearLowBit();
+            assignment_elims = value_configurations ^ (rest ^ rest.clearLowBit());
+        }
         // Assign the first configuration by eliminating the others
         this->num_guesses_++;
-        State next_state = state;
-        BitVec08x16 assignment_elims = value_configurations.clearLowBit();
+        State & next_state = this->nextSnapshot(state);
+        next_state.copy(state);
         next_state.bands[vertical][band_idx].eliminations |= assignment_elims;
         if (bandEliminate<vertical>(next_state, band_idx)) {
             countSolutionsConsistentWithPartialAssignment(next_state);
-            if (this->num_solutions_ == this->limit_solutions_) return;
+            if (this->num_solutions_ == this->limit_solutions_ || unlikely(this->aborted_)) return;
         }
         // Now negate the first configuration
         BitVec08x16 negation_elims = value_configurations ^ assignment_elims;
@@ -965,13 +1424,14 @@ private:
     // changed in a way that makes subsequent calls return different results.
     //
     void countSolutionsConsistentWithPartialAssignment(State & state) {
-        auto band_and_value = chooseBandAndValueToBranch(state);
+        auto band_and_value = likely(!this->probing_) ? chooseBandAndValueToBranch(state, this->valueRotation())
+                                                      : probeBandAndValueToBranch(state);
         if (band_and_value.first == NONE) {
             this->num_solutions_++;
             if (kSolutionMode == 1 && this->num_solutions_ == this->limit_solutions_) {
                 this->result_state_.copy_boxes(state);
             }
-        } else {
+        } else if (band_and_value.first != CONFLICT) {
             if (band_and_value.first < 3) {
                 branchOnBandAndValue<kHorizontal>(
                         tables.mod3[band_and_value.first], band_and_value.second, state);
@@ -982,10 +1442,12 @@ private:
         }
     }
 
-    size_t safeCountSolutionsConsistentWithPartialAssignment(State state, size_t limit) {
+    size_t safeCountSolutionsConsistentWithPartialAssignment(const State & state, size_t limit) {
         this->num_solutions_ = 0;
         this->limit_solutions_ = limit;
-        countSolutionsConsistentWithPartialAssignment(state);
+        State & root = this->states_[0];
+        root.copy(state);
+        countSolutionsConsistentWithPartialAssignment(root);
         return this->num_solutions_;
     }
 
@@ -1021,12 +1483,54 @@ private:
                 state.bands[1][indexing.box_x].eliminations);
     }
 
+    //
+    // All the clues at once: the 27 characters of a band are loaded with two overlapping
+    // 16 byte loads (bytes 0 - 15 and 11 - 26), gathered to the lanes of each box of the
+    // band and looked up as the low and high bytes of their bitmasks, then every box turns
+    // its clues into box and band eliminations as the search does for asserted literals.
+    //
+    // Unlike initClue(), a digit given twice in a box keeps its bit in both cells, but the
+    // band eliminations of the two cells reject the puzzle anyway.
+    //
+    static
+    JSTD_FORCED_INLINE
+    void initClues(const char * puzzle, State & state) {
+        const BitVec08x16 bitmask_low  = tables.clue_bitmask_bytes[0];
+        const BitVec08x16 bitmask_high = tables.clue_bitmask_bytes[1];
+        const BitVec08x16 high_bits_mask = BitVec08x16::full16(0xF0F0);
+        const BitVec08x16 digit_high_bits = BitVec08x16::full16(0x3030);
+        for (int band = 0; band < 3; band++) {
+            BitVec08x16 head, tail;
+            head.loadUnaligned(puzzle + band * 27);
+            tail.loadUnaligned(puzzle + band * 27 + 11);
+            for (int i = 0; i < 3; i++) {
+                BitVec08x16 chars = head.shuffle(tables.band_boxes_shuffle[0][i]) |
+                                    tail.shuffle(tables.band_boxes_shuffle[1][i]);
+                // Only the low 4 bits are looked up: 'A', 'x', '!' ... are empties, not digits.
+                chars &= (chars & high_bits_mask).whichIsEqual8(digit_high_bits);
+                BitVec08x16 low = bitmask_low.shuffle(chars);
+                BitVec08x16 high = bitmask_high.shuffle(chars);
+                BitVec16x16 clues(low.unpackLowU8(high), low.unpackHighU8(high));
+                if (clues.isAllZeros()) continue;
+
+                BitVec16x16 box_eliminations;
+                box_eliminations.setAllZeros();
+                assertionsToEliminations(clues, i, band, box_eliminations,
+                                         state.bands[0][band].eliminations,
+                                         state.bands[1][i].eliminations);
+                Box & box = state.boxes[band * 3 + i];
+                box.cells = box.cells.and_not(box_eliminations);
+            }
+        }
+    }
+
     static
     JSTD_FORCED_INLINE
     bool initSudoku(const char * puzzle, State & state) {
-#if USE_ALIGN_AS
         state.init();
-#endif
+#if 1
+        initClues(puzzle, state);
+#else
         uint64_t nonDotMask64 = whichIsNotDots64<false>(puzzle);
         while (nonDotMask64 != 0) {
             uint32_t pos = BitUtils::bsf64(nonDotMask64);
@@ -1044,15 +1548,24 @@ private:
         if (puzzle[80] != '.') {
             initClue(puzzle, state, 80);
         }
+#endif
 
         //
         // Thanks to the merging of band updates the puzzle is almost always fully initialized
         // after the first of these calls. most will be no-ops, but we've still got to do them
         // since this cannot be guaranteed.
         //
-        return (bandEliminate<kHorizontal>(state, 0, 1) && bandEliminate<kVertical>(state, 0, 1) &&
-                bandEliminate<kHorizontal>(state, 1, 2) && bandEliminate<kVertical>(state, 1, 2) &&
-                bandEliminate<kHorizontal>(state, 2, 0) && bandEliminate<kVertical>(state, 2, 0));
+        bool valid = (bandEliminate<kHorizontal>(state, 0, 1) && bandEliminate<kVertical>(state, 0, 1) &&
+                      bandEliminate<kHorizontal>(state, 1, 2) && bandEliminate<kVertical>(state, 1, 2) &&
+                      bandEliminate<kHorizontal>(state, 2, 0) && bandEliminate<kVertical>(state, 2, 0));
+
+        // The clues were set without boxRestrict(), so every extra unit is checked once here.
+        if (kHasExtraUnits && valid) {
+            for (uint32_t unit = 0; unit < (uint32_t)Variant::kUnits; unit++) {
+                if (!unitEliminate(state, unit)) return false;
+            }
+        }
+        return valid;
     }
 
     static
@@ -1075,6 +1588,35 @@ private:
     }
 
 #if 1
+    //
+    // All the lanes of a box at once: the numbers of the solved cells, packed to bytes and
+    // made ASCII, then the 3 boxes of a band shuffled to row-major order and written with
+    // two overlapping 16 byte stores (bytes 0 - 15 and 11 - 26 of the band), so nothing is
+    // written past the 81 bytes of the solution.
+    //
+    static
+    JSTD_FORCED_INLINE
+    void extractSolution(const State & state, char * solution) {
+        const BitVec08x16 ascii_zeros = BitVec08x16::full16(0x3030);
+        for (int band = 0; band < 3; band++) {
+            BitVec08x16 digits[3];
+            for (int i = 0; i < 3; i++) {
+                const BitVec16x16 & cells = state.boxes[band * 3 + i].cells;
+                BitVec08x16 low = cells.getLow().lowBitNumber16<Numbers>();
+                BitVec08x16 high = cells.getHigh().lowBitNumber16<Numbers>();
+                digits[i] = low.packU16(high) | ascii_zeros;
+            }
+            BitVec08x16 head = digits[0].shuffle(tables.band_rows_shuffle[0][0]) |
+                               digits[1].shuffle(tables.band_rows_shuffle[0][1]) |
+                               digits[2].shuffle(tables.band_rows_shuffle[0][2]);
+            BitVec08x16 tail = digits[0].shuffle(tables.band_rows_shuffle[1][0]) |
+                               digits[1].shuffle(tables.band_rows_shuffle[1][1]) |
+                               digits[2].shuffle(tables.band_rows_shuffle[1][2]);
+            head.saveUnaligned(solution + band * 27);
+            tail.saveUnaligned(solution + band * 27 + 11);
+        }
+    }
+#elif 0
     static
     JSTD_FORCED_INLINE
     void extractSolution(const State & state, char * solution) {
@@ -1113,17 +1655,17 @@ private:
         this->set_num_guesses(0);
         this->set_num_solutions(0);
         this->set_limit_solutions(limit);
+        this->num_failed_literals_ = 0;
+        this->aborted_ = false;
+        this->guess_check_ = (this->cancel_ != nullptr) ?
+            (std::min)(this->guess_budget_, (size_t)kCancelPollGuesses) : this->guess_budget_;
     }
 
 public:
     size_t solve(const char * puzzle, char * solution, size_t limit) {
         this->resetStatistics(limit);
 
-#if USE_ALIGN_AS
-        State & state = this->state_;
-#else
-        State state;
-#endif
+        State & state = this->states_[0];
         bool success = this->initSudoku(puzzle, state);
         if (success) {
             countSolutionsConsistentWithPartialAssignment(state);
@@ -1140,10 +1682,21 @@ public:
 };
 
 #if (GUDOKU_NO_MAIN != 0)
-DpllTriadSimdSolver<0> solver_none{};
-DpllTriadSimdSolver<1> solver_last{};
+// One pair of solvers per thread, so the C API can be called from many threads.
+thread_local DpllTriadSimdSolver<0> solver_none{};
+thread_local DpllTriadSimdSolver<1> solver_last{};
 #endif
 
+// The variants as templates of the solution mode alone, as the solver registry takes them.
+template <int kSolutionMode>
+using DpllVanillaSolver = DpllTriadSimdSolver<kSolutionMode, VanillaSudoku>;
+
+template <int kSolutionMode>
+using DpllSudokuXSolver = DpllTriadSimdSolver<kSolutionMode, SudokuX>;
+
+template <int kSolutionMode>
+using DpllWindokuSolver = DpllTriadSimdSolver<kSolutionMode, Windoku>;
+
 } // namespace
 
 #if (GUDOKU_NO_MAIN != 0)
@@ -1154,13 +1707,16 @@ extern "C"
 size_t gudoku_solver(const char * sudoku, char * solution, uint32_t configuration,
                      size_t limit, size_t * num_guesses)
 {
-    bool return_last = (limit == 1 || configuration > 0);
+    bool probing = ((configuration & GUDOKU_CONFIG_PROBING) != 0);
+    bool return_last = (limit == 1 || (configuration & ~GUDOKU_CONFIG_PROBING) != 0);
     size_t solutions;
     if (return_last) {
+        solver_last.set_probing(probing);
         solutions = solver_last.solve(sudoku, solution, limit);
         *num_guesses = solver_last.get_num_guesses();
     }
     else {
+        solver_none.set_probing(probing);
         solutions = solver_none.solve(sudoku, solution, limit);
         *num_guesses = solver_none.get_num_guesses();
     }
@@ -0,0 +1,518 @@
+
+#ifndef GUDOKU_HEXADOKU_SIMD_SOLVER_H
+#define GUDOKU_HEXADOKU_SIMD_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset()
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/BitUtils.h"
+#include "gudoku/AlignedArena.h"
+
+//
+// A SIMD solver for 16x16 sudoku (hexadoku): 4x4 boxes, 16 digits.
+//
+// The candidates of a cell are a 16-bit mask, so a row of the grid is exactly one
+// BitVec16x16 (lane = column, bit = digit), and the grid is 16 of them. The four boxes
+// of a band are the four 64-bit groups of lanes of its 4 rows, the same grouping the
+// rotateRows() / rotateCols() lane rotations of BitVec16x16 work on:
+//
+//   rows:      16 lanes of one vector,    reduced by rotateRows(), rotateRows2(),
+//                                                    rotateCols(), rotateCols2()
+//   columns:   one lane of the 16 vectors, reduced lane by lane
+//   boxes:     one 64-bit group of 4 vectors, reduced lane by lane, then by
+//                                                    rotateRows(), rotateRows2()
+//
+// Every unit is reduced to the digits seen at least once and at least twice, in all of
+// its lanes at once. A propagation pass then does, for all 48 units:
+//
+//   naked singles:   the solved cells (one candidate) are removed from their peers, a
+//                    digit solved twice in a unit is a contradiction;
+//   hidden singles:  a digit with only one place in a unit is placed, a digit with no
+//                    place is a contradiction;
+//
+// until nothing changes, then the box-line interactions (pointing and claiming) of the 4
+// mini-rows and 4 mini-columns of every box, and again until neither changes anything.
+// The search guesses on a bivalue cell if there is one, else on the cell with the fewest
+// candidates.
+//
+// Puzzles are 256 characters, the digits are '0' - '9' and 'A' - 'F' (or 'a' - 'f'),
+// anything else is an empty cell. The solution is written with '0' - '9', 'A' - 'F'.
+//
+
+namespace gudoku {
+
+struct HexBoard {
+    static const size_t kRows = 16;
+    static const size_t kCols = 16;
+    static const size_t kBoardSize = kRows * kCols;
+
+    char cells[kBoardSize];
+
+    void clear() {
+        std::memset(&this->cells[0], 0, sizeof(this->cells));
+    }
+
+    // The digit (0 - 15) of a puzzle character, or -1 for an empty cell.
+    static int digitOf(char ch) {
+        if (ch >= '0' && ch <= '9')
+            return (ch - '0');
+        else if (ch >= 'A' && ch <= 'F')
+            return (ch - 'A' + 10);
+        else if (ch >= 'a' && ch <= 'f')
+            return (ch - 'a' + 10);
+        else
+            return -1;
+    }
+
+    static char charOf(int digit) {
+        return "0123456789ABCDEF"[digit & 0x0F];
+    }
+};
+
+} // namespace gudoku
+
+using namespace gudoku;
+
+namespace {
+
+template <typename VectorT>
+struct alignas(64) HexState {
+    VectorT rows[16];
+
+    void copy(const HexState & src) {
+        for (size_t row = 0; row < 16; row++) {
+            this->rows[row] = src.rows[row];
+        }
+    }
+};
+
+template <int kSolutionMode, typename VectorT = BitVec16x16>
+class HexadokuSimdSolver : public BasicSolver {
+public:
+    typedef BasicSolver         basic_solver;
+    typedef HexadokuSimdSolver  this_type;
+    typedef HexState<VectorT>   state_type;
+
+    static const size_t kRows = 16;
+    static const size_t kBoardSize = HexBoard::kBoardSize;
+
+    // Every level of the search solves one more cell.
+    static const size_t kMaxSearchDepth = kBoardSize;
+
+private:
+    // states_[0] is the root state, states_[depth] the snapshot taken at that depth.
+    AlignedArena<state_type> states_;
+    char * solution_;
+
+public:
+    HexadokuSimdSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : basic_solver(), states_(kMaxSearchDepth + 1, use_huge_pages), solution_(nullptr) {}
+    ~HexadokuSimdSolver() {}
+
+private:
+    JSTD_FORCED_INLINE
+    state_type & nextSnapshot(state_type & state) {
+        assert(&state >= this->states_.data());
+        assert(&state < (this->states_.data() + kMaxSearchDepth));
+        return *(&state + 1);
+    }
+
+    // Fold the lanes shifted by a rotation into the (once, twice) counts.
+    static
+    JSTD_FORCED_INLINE
+    void combine(VectorT & once, VectorT & twice, const VectorT & once2, const VectorT & twice2) {
+        twice = twice | twice2 | (once & once2);
+        once = once | once2;
+    }
+
+    // Count the digits of one more cell of the unit, lane by lane.
+    static
+    JSTD_FORCED_INLINE
+    void accumulate(VectorT & once, VectorT & twice, const VectorT & cells) {
+        twice |= once & cells;
+        once |= cells;
+    }
+
+    // Reduce the 4 lanes of every box (64-bit group), the result is in all 4 of them.
+    static
+    JSTD_FORCED_INLINE
+    void reduceBoxLanes(VectorT & once, VectorT & twice) {
+        combine(once, twice, once.rotateRows(), twice.rotateRows());
+        combine(once, twice, once.rotateRows2(), twice.rotateRows2());
+    }
+
+    // Reduce all 16 lanes, the result is in all of them.
+    static
+    JSTD_FORCED_INLINE
+    void reduceAllLanes(VectorT & once, VectorT & twice) {
+        reduceBoxLanes(once, twice);
+        combine(once, twice, once.rotateCols(), twice.rotateCols());
+        combine(once, twice, once.rotateCols2(), twice.rotateCols2());
+    }
+
+    // 0xFFFF in the lanes of a solved cell (one candidate), and of an empty one.
+    static
+    JSTD_FORCED_INLINE
+    VectorT whichIsSingle(const VectorT & cells) {
+        return cells.whichIsEqual(cells.getLowBit());
+    }
+
+    //
+    // Remove the solved digits of every unit from the unsolved cells. Returns false on a
+    // digit solved twice in a unit.
+    //
+    static bool nakedSingles(state_type & state) {
+        VectorT solved[kRows];
+        VectorT singles[kRows];
+        VectorT col_once, col_twice, duplicates;
+        col_once.setAllZeros();
+        col_twice.setAllZeros();
+        duplicates.setAllZeros();
+
+        for (size_t row = 0; row < kRows; row++) {
+            singles[row] = whichIsSingle(state.rows[row]);
+            solved[row] = state.rows[row] & singles[row];
+            accumulate(col_once, col_twice, solved[row]);
+        }
+        duplicates |= col_twice;
+
+        for (size_t band = 0; band < kRows; band += 4) {
+            VectorT box_once = solved[band], box_twice;
+            box_twice.setAllZeros();
+            for (size_t row = band + 1; row < band + 4; row++) {
+                accumulate(box_once, box_twice, solved[row]);
+            }
+            reduceBoxLanes(box_once, box_twice);
+            duplicates |= box_twice;
+
+            for (size_t row = band; row < band + 4; row++) {
+                VectorT row_once = solved[row], row_twice;
+                row_twice.setAllZeros();
+                reduceAllLanes(row_once, row_twice);
+                duplicates |= row_twice;
+
+                VectorT used = row_once | col_once | box_once;
+                state.rows[row] = state.rows[row].and_not(used.and_not(singles[row]));
+            }
+        }
+        return duplicates.isAllZeros();
+    }
+
+    //
+    // Place the digits with one place left in a unit: the cells of the lanes are set to
+    // (cells & hidden) where that isn't empty. Returns false on a unit missing a digit, or
+    // a cell with two hidden singles.
+    //
+    static
+    JSTD_FORCED_INLINE
+    bool placeHidden(VectorT & cells, const VectorT & once, const VectorT & twice) {
+        VectorT hidden = once.and_not(twice);
+        VectorT placed = cells & hidden;
+        cells = placed | (cells & placed.whichIsZeros());
+        return (once.isAllOnes() && placed.whichIsEqual(placed.getLowBit()).isAllOnes());
+    }
+
+    static bool hiddenSingles(state_type & state) {
+        bool valid = true;
+
+        // Rows
+        for (size_t row = 0; row < kRows; row++) {
+            VectorT once = state.rows[row], twice;
+            twice.setAllZeros();
+            reduceAllLanes(once, twice);
+            valid &= placeHidden(state.rows[row], once, twice);
+        }
+
+        // Columns
+        VectorT col_once = state.rows[0], col_twice;
+        col_twice.setAllZeros();
+        for (size_t row = 1; row < kRows; row++) {
+            accumulate(col_once, col_twice, state.rows[row]);
+        }
+        for (size_t row = 0; row < kRows; row++) {
+            valid &= placeHidden(state.rows[row], col_once, col_twice);
+        }
+
+        // Boxes
+        for (size_t band = 0; band < kRows; band += 4) {
+            VectorT box_once = state.rows[band], box_twice;
+            box_twice.setAllZeros();
+            for (size_t row = band + 1; row < band + 4; row++) {
+                accumulate(box_once, box_twice, state.rows[row]);
+            }
+            reduceBoxLanes(box_once, box_twice);
+            for (size_t row = band; row < band + 4; row++) {
+                valid &= placeHidden(state.rows[row], box_once, box_twice);
+            }
+        }
+        return valid;
+    }
+
+    // OR the 4 lanes of every box (64-bit group), the result is in all 4 of them.
+    static
+    JSTD_FORCED_INLINE
+    VectorT orBoxLanes(const VectorT & cells) {
+        VectorT result = cells | cells.rotateRows();
+        return (result | result.rotateRows2());
+    }
+
+    // OR all 16 lanes, the result is in all of them.
+    static
+    JSTD_FORCED_INLINE
+    VectorT orAllLanes(const VectorT & cells) {
+        VectorT result = orBoxLanes(cells);
+        result |= result.rotateCols();
+        return (result | result.rotateCols2());
+    }
+
+    //
+    // The box-line interactions, with the 4 mini-rows (mini-columns) of a box as its
+    // band (stack) configuration:
+    //
+    //   pointing:   a digit of a box confined to one mini-row is removed from the rest of
+    //               the row, and the same for the mini-columns;
+    //   claiming:   a digit of a row confined to one box is removed from the other rows of
+    //               the box, and the same for the columns.
+    //
+    // A digit confined twice (a contradiction) is removed everywhere it was confined to,
+    // which the next pass of the singles finds.
+    //
+    static void lockedCandidates(state_type & state) {
+        VectorT elim[kRows];
+
+        for (size_t band = 0; band < kRows; band += 4) {
+            VectorT minirows[4];
+            for (size_t i = 0; i < 4; i++) {
+                minirows[i] = orBoxLanes(state.rows[band + i]);
+            }
+
+            VectorT pointing[4], claiming[4];
+            VectorT all_pointing, all_claiming;
+            all_pointing.setAllZeros();
+            all_claiming.setAllZeros();
+            for (size_t i = 0; i < 4; i++) {
+                VectorT others = minirows[(i + 1) & 3] | minirows[(i + 2) & 3] | minirows[(i + 3) & 3];
+                pointing[i] = minirows[i].and_not(others);
+                all_pointing |= pointing[i];
+
+                VectorT once = minirows[i], twice;
+                twice.setAllZeros();
+                combine(once, twice, once.rotateCols(), twice.rotateCols());
+                combine(once, twice, once.rotateCols2(), twice.rotateCols2());
+                claiming[i] = minirows[i] & once.and_not(twice);
+                all_claiming |= claiming[i];
+            }
+            for (size_t i = 0; i < 4; i++) {
+                elim[band + i] = orAllLanes(pointing[i]).and_not(pointing[i]) |
+                                 all_claiming.and_not(claiming[i]);
+            }
+        }
+
+        VectorT minicols[4];
+        VectorT col_once, col_twice;
+        col_once.setAllZeros();
+        col_twice.setAllZeros();
+        for (size_t band = 0; band < 4; band++) {
+            size_t row = band * 4;
+            minicols[band] = state.rows[row] | state.rows[row + 1] |
+                             state.rows[row + 2] | state.rows[row + 3];
+            accumulate(col_once, col_twice, minicols[band]);
+        }
+
+        VectorT pointing[4], all_pointing;
+        all_pointing.setAllZeros();
+        for (size_t band = 0; band < 4; band++) {
+            VectorT once = minicols[band], twice;
+            twice.setAllZeros();
+            reduceBoxLanes(once, twice);
+            pointing[band] = minicols[band] & once.and_not(twice);
+            all_pointing |= pointing[band];
+        }
+
+        for (size_t band = 0; band < 4; band++) {
+            VectorT claiming = minicols[band] & col_once.and_not(col_twice);
+            VectorT col_elim = all_pointing.and_not(pointing[band]) |
+                               orBoxLanes(claiming).and_not(claiming);
+            for (size_t row = band * 4; row < band * 4 + 4; row++) {
+                state.rows[row] = state.rows[row].and_not(elim[row] | col_elim);
+            }
+        }
+    }
+
+    //
+    // Propagate the singles until nothing changes, then the box-line interactions, until
+    // neither changes anything. Returns false on a contradiction.
+    //
+    static bool update(state_type & state) {
+        for (;;) {
+            state_type last;
+            last.copy(state);
+
+            if (!nakedSingles(state))
+                return false;
+            if (!hiddenSingles(state))
+                return false;
+
+            VectorT changed, empties;
+            changed.setAllZeros();
+            empties.setAllZeros();
+            for (size_t row = 0; row < kRows; row++) {
+                changed |= state.rows[row] ^ last.rows[row];
+                empties |= state.rows[row].whichIsZeros();
+            }
+            if (!empties.isAllZeros())
+                return false;
+            if (changed.isAllZeros()) {
+                lockedCandidates(state);
+                changed.setAllZeros();
+                for (size_t row = 0; row < kRows; row++) {
+                    changed |= state.rows[row] ^ last.rows[row];
+                }
+                if (changed.isAllZeros())
+                    return true;
+            }
+        }
+    }
+
+    static bool isSolved(const state_type & state) {
+        VectorT singles = whichIsSingle(state.rows[0]);
+        for (size_t row = 1; row < kRows; row++) {
+            singles &= whichIsSingle(state.rows[row]);
+        }
+        return singles.isAllOnes();
+    }
+
+    //
+    // The first bivalue cell, else the unsolved cell with the fewest candidates.
+    //
+    static int chooseCell(const state_type & state) {
+        for (size_t row = 0; row < kRows; row++) {
+            const VectorT & cells = state.rows[row];
+            VectorT rest = cells.and_not(cells.getLowBit());
+            VectorT bivalue = whichIsSingle(rest).and_not(rest.whichIsZeros());
+            uint32_t lanes = cells.maskOfOnes16(bivalue);
+            if (lanes != 0) {
+                return (int)(row * 16 + BitUtils::bsf32(lanes) / 2);
+            }
+        }
+
+        int best_pos = -1;
+        uint32_t best_count = 17;
+        for (size_t row = 0; row < kRows; row++) {
+            alignas(32) uint16_t lanes[16];
+            state.rows[row].saveAligned((void *)&lanes[0]);
+            for (size_t col = 0; col < 16; col++) {
+                uint32_t count = BitUtils::popcnt32((uint32_t)lanes[col]);
+                if (count > 1 && count < best_count) {
+                    best_count = count;
+                    best_pos = (int)(row * 16 + col);
+                }
+            }
+        }
+        return best_pos;
+    }
+
+    static uint32_t getCell(const state_type & state, int pos) {
+        alignas(32) uint16_t lanes[16];
+        state.rows[pos / 16].saveAligned((void *)&lanes[0]);
+        return (uint32_t)lanes[pos % 16];
+    }
+
+    static void setCell(state_type & state, int pos, uint32_t candidates) {
+        alignas(32) uint16_t lanes[16];
+        state.rows[pos / 16].saveAligned((void *)&lanes[0]);
+        lanes[pos % 16] = (uint16_t)candidates;
+        state.rows[pos / 16].loadAligned((const void *)&lanes[0]);
+    }
+
+    void search(state_type & state) {
+        if (!update(state))
+            return;
+        if (isSolved(state)) {
+            this->num_solutions_++;
+            if (kSolutionMode == 1 && this->num_solutions_ == this->limit_solutions_) {
+                extractSolution(state, this->solution_);
+            }
+            return;
+        }
+
+        int pos = chooseCell(state);
+        assert(pos >= 0);
+        uint32_t candidates = getCell(state, pos);
+        assert(BitUtils::popcnt32(candidates) > 1);
+
+        while (candidates != 0) {
+            uint32_t digit_bit = candidates & (0u - candidates);
+            candidates ^= digit_bit;
+            if (candidates != 0) {
+                // Try the digit on a snapshot, keep the state for the other candidates.
+                this->num_guesses_++;
+                state_type & next_state = this->nextSnapshot(state);
+                next_state.copy(state);
+                setCell(next_state, pos, digit_bit);
+                search(next_state);
+                if (this->num_solutions_ == this->limit_solutions_) return;
+            } else {
+                // The last candidate: no snapshot needed.
+                setCell(state, pos, digit_bit);
+                search(state);
+            }
+        }
+    }
+
+    static void extractSolution(const state_type & state, char * solution) {
+        for (size_t row = 0; row < kRows; row++) {
+            alignas(32) uint16_t lanes[16];
+            state.rows[row].saveAligned((void *)&lanes[0]);
+            for (size_t col = 0; col < 16; col++) {
+                solution[row * 16 + col] = HexBoard::charOf((int)BitUtils::bsf32((uint32_t)lanes[col]));
+            }
+        }
+    }
+
+public:
+    // Set up the root state from the clues, the conflicts are found by the first update().
+    static void initSudoku(const char * puzzle, state_type & state) {
+        for (size_t row = 0; row < kRows; row++) {
+            alignas(32) uint16_t lanes[16];
+            for (size_t col = 0; col < 16; col++) {
+                int digit = HexBoard::digitOf(puzzle[row * 16 + col]);
+                lanes[col] = (digit >= 0) ? (uint16_t)(1u << digit) : (uint16_t)0xFFFFu;
+            }
+            state.rows[row].loadAligned((const void *)&lanes[0]);
+        }
+    }
+
+    void resetStatistics(size_t limit) {
+        this->set_num_guesses(0);
+        this->set_num_solutions(0);
+        this->set_limit_solutions(limit);
+    }
+
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        this->resetStatistics(limit);
+        this->solution_ = solution;
+
+        state_type & state = this->states_[0];
+        initSudoku(puzzle, state);
+        search(state);
+        return this->num_solutions_;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_HEXADOKU_SIMD_SOLVER_H
@@ -0,0 +1,162 @@
+
+#ifndef GUDOKU_HYBRID_SOLVER_H
+#define GUDOKU_HYBRID_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/JczBitboardSolver.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// Routes every puzzle to the engine that is faster for its class.
+//
+// The classifier is the first propagation of JczBitboardSolver, which the bitboard engine
+// needs anyway: the clue count, whether the singles alone solve (or break) the puzzle, and
+// the number of cells left unsolved after them. Per-class timings over the 17-clue, the
+// forum hardest and the generated easy sets (cycles/puzzle, gcc 12, -march=native):
+//
+//   unsolved after propagation      0     20     30     40     50    55+
+//   JczBitboardSolver            5.3k   7.5k   9.6k  12.3k  20.1k   29k - 220k
+//   DpllTriadSimdSolver          7.6k   9.1k   9.0k   9.3k  10.9k   11k -  80k
+//
+// so the puzzles with fewer than kJczMaxUnsolved open cells stay on the bitboard engine,
+// the others go to the triad solver. The clue count and the root state tell nothing more
+// once the propagation has run, but the number of guesses does: a bitboard search that
+// runs past kJczMaxGuesses is a puzzle of the hard class that looked easy, and it is
+// handed over to the triad solver.
+//
+
+using namespace gudoku;
+
+namespace {
+
+struct PuzzleClass {
+    enum {
+        Invalid,        // Conflicting clues, or the singles run into a contradiction
+        Solved,         // The singles alone solve the puzzle
+        Easy,           // Few open cells: JczBitboardSolver
+        Hard            // DpllTriadSimdSolver
+    };
+};
+
+struct PuzzleInfo {
+    uint32_t clues;
+    uint32_t unsolved;      // Unsolved cells after the first propagation
+    uint32_t category;      // PuzzleClass
+    uint32_t reserved;
+};
+
+template <int kSolutionMode>
+class HybridSolver : public BasicSolver {
+public:
+    typedef BasicSolver     basic_solver;
+    typedef HybridSolver    this_type;
+
+    typedef JczBitboardSolver<kSolutionMode>    jcz_solver_t;
+    typedef DpllTriadSimdSolver<kSolutionMode>  dpll_solver_t;
+
+    static const uint32_t kJczMaxUnsolved = 30;
+    static const size_t   kJczMaxGuesses = 8;
+
+private:
+    jcz_solver_t    jcz_solver_;
+    dpll_solver_t   dpll_solver_;
+    PuzzleInfo      info_;
+    size_t          num_fallbacks_;
+
+public:
+    HybridSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : basic_solver(), jcz_solver_(use_huge_pages), dpll_solver_(use_huge_pages),
+          num_fallbacks_(0) {
+        this->info_.clues = 0;
+        this->info_.unsolved = 0;
+        this->info_.category = PuzzleClass::Invalid;
+        this->info_.reserved = 0;
+        this->jcz_solver_.set_limit_guesses(kJczMaxGuesses);
+    }
+    ~HybridSolver() {}
+
+    // The class of the last puzzle.
+    const PuzzleInfo & get_puzzle_info() const {
+        return this->info_;
+    }
+
+    // The puzzles handed over from the bitboard engine to the triad solver so far.
+    size_t get_num_fallbacks() const {
+        return this->num_fallbacks_;
+    }
+
+    //
+    // Classify the puzzle, and leave the propagated root state in the bitboard engine.
+    //
+    const PuzzleInfo & classify(const char * puzzle) {
+        JczState & root = this->jcz_solver_.rootState();
+        bool valid = jcz_solver_t::initSudoku(puzzle, root);
+        this->info_.clues = (uint32_t)(Sudoku::BoardSize - jcz_solver_t::countUnsolved(root));
+        if (valid && jcz_solver_t::propagate(root)) {
+            this->info_.unsolved = (uint32_t)jcz_solver_t::countUnsolved(root);
+            if (this->info_.unsolved == 0)
+                this->info_.category = PuzzleClass::Solved;
+            else if (this->info_.unsolved < kJczMaxUnsolved)
+                this->info_.category = PuzzleClass::Easy;
+            else
+                this->info_.category = PuzzleClass::Hard;
+        }
+        else {
+            this->info_.unsolved = 0;
+            this->info_.category = PuzzleClass::Invalid;
+        }
+        return this->info_;
+    }
+
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        this->set_num_guesses(0);
+        this->set_num_solutions(0);
+        this->set_limit_solutions(limit);
+
+        const PuzzleInfo & info = this->classify(puzzle);
+        if (info.category == PuzzleClass::Invalid)
+            return 0;
+
+        if (info.category != PuzzleClass::Hard) {
+            // Continue from the propagated root state.
+            size_t solutions = this->jcz_solver_.solveFromRoot(solution, limit);
+            if (!this->jcz_solver_.aborted()) {
+                this->num_guesses_ = this->jcz_solver_.get_num_guesses();
+                this->num_solutions_ = solutions;
+                return solutions;
+            }
+            // Start over on the triad solver: the guesses made so far are not lost for the
+            // statistics, but the solutions counted so far (limit > 1) are.
+            this->num_guesses_ = this->jcz_solver_.get_num_guesses();
+            this->num_fallbacks_++;
+        }
+
+        size_t solutions = this->dpll_solver_.solve(puzzle, solution, limit);
+        this->num_guesses_ += this->dpll_solver_.get_num_guesses();
+        this->num_solutions_ = solutions;
+        return solutions;
+    }
+
+    void display_result(Board & board, double elapsed_time,
+                        bool print_answer = true,
+                        bool print_all_answers = true) {
+        basic_solver::display_result<SearchMode::OneSolution>(board, elapsed_time,
+                                                              print_answer, print_all_answers);
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_HYBRID_SOLVER_H
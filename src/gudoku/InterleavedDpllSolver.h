@@ -0,0 +1,221 @@
+
+#ifndef GUDOKU_INTERLEAVED_DPLL_SOLVER_H
+#define GUDOKU_INTERLEAVED_DPLL_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/AlignedArena.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// The searches of kLanes puzzles interleaved on one core (AMAC-style).
+//
+// A single search of DpllTriadSimdSolver is a long chain of dependent vector ops: choose
+// a band and a value, copy the snapshot, eliminate, and again, with little to overlap.
+// Here the recursion of countSolutionsConsistentWithPartialAssignment() is unrolled into
+// a small state machine per lane (a depth and the negation that is still pending at each
+// depth), and the lanes take turns, one branch point each, so the out-of-order engine
+// runs the chains of kLanes independent puzzles side by side. A lane that finishes its
+// puzzle takes the next one of the batch right away.
+//
+// Every lane has its own snapshots, kMaxSearchDepth + 1 of them in one shared arena, so
+// the search of a lane is the same search as DpllTriadSimdSolver::solve() makes: the same
+// guesses, the same solution count and the same solution.
+//
+
+using namespace gudoku;
+
+namespace {
+
+template <int kSolutionMode, size_t kLanes = 4>
+class InterleavedDpllSolver : public DpllTriadSimdSolver<kSolutionMode> {
+public:
+    typedef DpllTriadSimdSolver<kSolutionMode>  dpll_solver_t;
+    typedef InterleavedDpllSolver               this_type;
+
+    static const size_t kMaxSearchDepth = dpll_solver_t::kMaxSearchDepth;
+    static const size_t kBatchSize = kLanes;
+
+private:
+    // The negation of the first configuration, still to apply at a depth.
+    struct Negation {
+        BitVec08x16 eliminations;
+        uint32_t    vertical;
+        uint32_t    band_idx;
+    };
+
+    struct Lane {
+        State *     states;         // kMaxSearchDepth + 1 snapshots
+        size_t      depth;          // the pending negations are at 0 .. depth - 1
+        size_t      puzzle;         // the index of the puzzle in the batch
+        size_t      num_solutions;
+        size_t      num_guesses;
+        bool        active;
+        Negation    pending[kMaxSearchDepth];
+    };
+
+    AlignedArena<State> lane_states_;
+    Lane                lanes_[kLanes];
+
+public:
+    InterleavedDpllSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : dpll_solver_t(use_huge_pages),
+          lane_states_(kLanes * (kMaxSearchDepth + 1), use_huge_pages) {
+        for (size_t i = 0; i < kLanes; i++) {
+            this->lanes_[i].states = this->lane_states_.data() + i * (kMaxSearchDepth + 1);
+            this->lanes_[i].active = false;
+        }
+    }
+    ~InterleavedDpllSolver() {}
+
+private:
+    //
+    // Pop the pending negations until one leaves a consistent state, as the second arm
+    // of branchOnBandAndValue() does when the first arm returns. Returns false when the
+    // search of the lane is over.
+    //
+    static
+    JSTD_FORCED_INLINE
+    bool backtrack(Lane & lane, size_t limit) {
+        if (lane.num_solutions == limit) return false;
+        while (lane.depth > 0) {
+            lane.depth--;
+            const Negation & negation = lane.pending[lane.depth];
+            State & state = lane.states[lane.depth];
+            state.bands[negation.vertical][negation.band_idx].eliminations |= negation.eliminations;
+            if (dpll_solver_t::bandEliminate(state, negation.vertical, negation.band_idx))
+                return true;
+        }
+        return false;
+    }
+
+    //
+    // One branch point of a lane: a solution, or the first arm of a branch (the snapshot
+    // one level deeper, with the negation left pending). Returns false when the search of
+    // the lane is over.
+    //
+    static
+    JSTD_FORCED_INLINE
+    bool step(Lane & lane, size_t limit, char * solution) {
+        State & state = lane.states[lane.depth];
+        auto band_and_value = dpll_solver_t::chooseBandAndValueToBranch(state);
+        if (band_and_value.first == dpll_solver_t::NONE) {
+            lane.num_solutions++;
+            if (kSolutionMode == 1 && lane.num_solutions == limit) {
+                dpll_solver_t::extractSolution(state, solution);
+            }
+            return backtrack(lane, limit);
+        }
+
+        assert(lane.depth < kMaxSearchDepth);
+        uint32_t vertical = (band_and_value.first < 3) ? (uint32_t)kHorizontal : (uint32_t)kVertical;
+        uint32_t band_idx = tables.mod3[band_and_value.first];
+        BitVec08x16 value_configurations =
+                state.bands[vertical][band_idx].configurations & band_and_value.second;
+        // Assign the first configuration by eliminating the others
+        lane.num_guesses++;
+        State & next_state = lane.states[lane.depth + 1];
+        next_state.copy(state);
+        BitVec08x16 assignment_elims = value_configurations.clearLowBit();
+        next_state.bands[vertical][band_idx].eliminations |= assignment_elims;
+
+        Negation & negation = lane.pending[lane.depth];
+        negation.eliminations = value_configurations ^ assignment_elims;
+        negation.vertical = vertical;
+        negation.band_idx = band_idx;
+        lane.depth++;
+
+        if (dpll_solver_t::bandEliminate(next_state, vertical, band_idx))
+            return true;
+        else
+            return backtrack(lane, limit);
+    }
+
+    // Start the lane on a puzzle, false if the clues alone have no solution.
+    static
+    JSTD_FORCED_INLINE
+    bool start(Lane & lane, const char * puzzle, size_t index) {
+        lane.depth = 0;
+        lane.puzzle = index;
+        lane.num_solutions = 0;
+        lane.num_guesses = 0;
+        return dpll_solver_t::initSudoku(puzzle, lane.states[0]);
+    }
+
+public:
+    //
+    // Solve count puzzles, kLanes searches at a time: puzzle i at puzzles + i * puzzle_stride,
+    // solution i (kSolutionMode == 1) written to solutions + i * solution_stride.
+    // num_solutions and num_guesses are optional arrays of count elements (may be nullptr).
+    // Returns the number of puzzles that have at least one solution.
+    //
+    size_t solveBatch(const char * puzzles, size_t puzzle_stride,
+                      char * solutions, size_t solution_stride,
+                      size_t count, size_t limit,
+                      size_t * num_solutions = nullptr, size_t * num_guesses = nullptr) {
+        this->set_num_guesses(0);
+        this->set_limit_solutions(limit);
+
+        size_t num_solved = 0;
+        size_t next = 0;
+        size_t num_active = 0;
+
+        auto finish = [&](const Lane & lane) {
+            if (num_solutions != nullptr)
+                num_solutions[lane.puzzle] = lane.num_solutions;
+            if (num_guesses != nullptr)
+                num_guesses[lane.puzzle] = lane.num_guesses;
+            this->num_guesses_ += lane.num_guesses;
+            num_solved += (lane.num_solutions != 0);
+        };
+
+        // Give the lane the next puzzle that needs a search.
+        auto refill = [&](Lane & lane) -> bool {
+            while (next < count) {
+                size_t index = next++;
+                if (start(lane, puzzles + index * puzzle_stride, index))
+                    return true;
+                finish(lane);
+            }
+            return false;
+        };
+
+        for (size_t i = 0; i < kLanes; i++) {
+            this->lanes_[i].active = refill(this->lanes_[i]);
+            num_active += (size_t)this->lanes_[i].active;
+        }
+
+        while (num_active > 0) {
+            for (size_t i = 0; i < kLanes; i++) {
+                Lane & lane = this->lanes_[i];
+                if (!lane.active) continue;
+                if (!step(lane, limit, solutions + lane.puzzle * solution_stride)) {
+                    finish(lane);
+                    if (!refill(lane)) {
+                        lane.active = false;
+                        num_active--;
+                    }
+                }
+            }
+        }
+
+        this->set_num_solutions(num_solved);
+        return num_solved;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_INTERLEAVED_DPLL_SOLVER_H
@@ -0,0 +1,577 @@
+
+#ifndef GUDOKU_JCZ_BITBOARD_SOLVER_H
+#define GUDOKU_JCZ_BITBOARD_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset()
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitUtils.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/StaticData.h"
+#include "gudoku/AlignedArena.h"
+
+//
+// A JCZSolve-style bitboard solver.
+//
+// The board is kept as one bitboard per digit: a BitVec08x16 whose three low 32-bit lanes
+// hold the 27 cells (3 rows x 9 columns) of each band, the fourth lane is always zero. A
+// placed digit keeps its cell in its own bitboard and clears it from the other eight, so
+// the bitboards are the candidates and the solution at the same time.
+//
+// Like JCZSolve, propagation looks at each band of a digit as a 3x3 matrix of minirows
+// (row x box) and keeps only the minirows that can take part in a placement of the digit
+// in the band (one minirow per row and per box). JCZSolve does it with a table lookup per
+// (digit, band) word; here the 6 placements are checked with row and box rotations of the
+// minirow matrix, for the three bands of a digit at once and without a branch:
+//
+//     allowed(i, k) = m(i, k) & ((m(i+1, k+1) & m(i+2, k+2)) | (m(i+1, k+2) & m(i+2, k+1)))
+//
+// One round of update() filters the nine bitboards that way, lets every box that holds a
+// digit in a single column claim that column in the other bands, and then collects all the
+// singles of the board (hidden singles in rows, boxes and columns, naked singles by
+// bit-sliced counting over the bitboards) and places them together.
+//
+// The engine does much less work per step than DpllTriadSimdSolver and wins on the
+// puzzles that fall to singles and a few guesses, the triad solver wins on the hard ones
+// (see HybridSolver.h).
+//
+
+using namespace gudoku;
+
+namespace {
+
+//
+// JczState layout (64 byte aligned, 3 cache lines):
+//
+//   offset   0: digits[9]  candidates (and placed cells) of each digit
+//   offset 144: unsolved   unsolved cells
+//   offset 160: padding
+//
+struct alignas(64) JczState {
+    BitVec08x16 digits[9];
+    BitVec08x16 unsolved;
+    BitVec08x16 reserved[2];
+
+    inline void copy(const JczState & other) {
+        for (size_t d = 0; d < 9; d++) {
+            this->digits[d] = other.digits[d];
+        }
+        this->unsolved = other.unsolved;
+    }
+};
+
+static_assert((alignof(JczState) == 64), "JczState must be cache line aligned");
+static_assert((sizeof(JczState) == 192), "JczState must be padded to whole cache lines");
+
+//
+// Constant-initialized tables (see StaticData.h).
+//
+struct alignas(64) JczTables {
+    // The cell itself, and its peers for its own digit: its row and box in the band and
+    // its column in the other bands.
+    ConstBitVec<BitVec08x16> cell_mask[81];
+    ConstBitVec<BitVec08x16> peer_mask[81];
+
+    static constexpr uint32_t kBoxBits = 0x07u | (0x07u << 9) | (0x07u << 18);
+
+    static constexpr uint32_t cellBand(uint32_t pos, uint32_t band) {
+        return (pos / 27 == band) ? (1u << (pos % 27)) : 0u;
+    }
+
+    static constexpr uint32_t peerBand(uint32_t pos, uint32_t band) {
+        return (pos / 27 == band) ?
+               // Row and box in its own band, but not the cell itself.
+               (((0x01FFu << (pos % 27 / 9 * 9)) | (kBoxBits << (pos % 9 / 3 * 3))) &
+                ~(1u << (pos % 27))) :
+               // Column in the other bands.
+               ((band < 3) ? (0x40201u << (pos % 9)) : 0u);
+    }
+
+    static constexpr uint16_t lane16(uint32_t band_bits, size_t lane) {
+        return (uint16_t)((lane % 2 == 0) ? (band_bits & 0xFFFFu) : (band_bits >> 16));
+    }
+
+    template <size_t... Cells>
+    static constexpr JczTables make(IndexSequence<Cells...>) {
+        return JczTables {
+            // cell_mask[81]
+            { lane16(cellBand((uint32_t)(Cells / 8), (uint32_t)(Cells % 8 / 2)), Cells % 8)... },
+            // peer_mask[81]
+            { lane16(peerBand((uint32_t)(Cells / 8), (uint32_t)(Cells % 8 / 2)), Cells % 8)... }
+        };
+    }
+};
+
+static constexpr JczTables jcz_tables = JczTables::make(MakeIndexSequence<81 * 8>::type());
+
+//
+// Band bitboard arithmetic: every 32-bit lane is a band of 3 rows x 9 columns, the cell
+// (row i, column j) at bit (i * 9 + j). A minirow (row i, box k) is represented by its
+// first cell, bit (i * 9 + k * 3).
+//
+struct BandBits {
+    static const uint32_t kAll27     = 0x07FFFFFFUL;
+    static const uint32_t kRowFirst  = 0x00040201UL;   // The first cell of each row
+    static const uint32_t kMinirows  = 0x01249249UL;   // The first cell of each minirow
+    static const uint32_t kBoxes01   = 0x00241209UL;   // Minirows of boxes 0 and 1
+    static const uint32_t kBoxes12   = 0x01209048UL;   // Minirows of boxes 1 and 2
+    static const uint32_t kBox2      = 0x01008040UL;   // Minirows of box 2
+    static const uint32_t kColumns9  = 0x000001FFUL;   // A row, or a set of columns
+    static const uint32_t kBoxFirst9 = 0x00000049UL;   // The first column of each box
+
+    static inline BitVec08x16 full(uint32_t value) {
+        return BitVec08x16::full32(value);
+    }
+
+    template <int N>
+    static inline BitVec08x16 shl(const BitVec08x16 & x) {
+        return _mm_slli_epi32(x.m128, N);
+    }
+
+    template <int N>
+    static inline BitVec08x16 shr(const BitVec08x16 & x) {
+        return _mm_srli_epi32(x.m128, N);
+    }
+
+    // Row i takes row (i + 1) % 3, or row (i + 2) % 3.
+    static inline BitVec08x16 rotateRows1(const BitVec08x16 & x) {
+        return shr<9>(x) | (shl<18>(x) & full(kAll27));
+    }
+
+    static inline BitVec08x16 rotateRows2(const BitVec08x16 & x) {
+        return shr<18>(x) | (shl<9>(x) & full(kAll27));
+    }
+
+    // Minirows only: box k takes box (k + 1) % 3, or box (k + 2) % 3.
+    static inline BitVec08x16 rotateBoxes1(const BitVec08x16 & m) {
+        return (shr<3>(m) & full(kBoxes01)) | (shl<6>(m) & full(kBox2));
+    }
+
+    static inline BitVec08x16 rotateBoxes2(const BitVec08x16 & m) {
+        return (shr<6>(m) & full(kRowFirst)) | (shl<3>(m) & full(kBoxes12));
+    }
+
+    // Band b takes band (b + 1) % 3, or band (b + 2) % 3. The fourth lane stays zero.
+    static inline BitVec08x16 rotateBands1(const BitVec08x16 & x) {
+        return _mm_shuffle_epi32(x.m128, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    static inline BitVec08x16 rotateBands2(const BitVec08x16 & x) {
+        return _mm_shuffle_epi32(x.m128, _MM_SHUFFLE(3, 1, 0, 2));
+    }
+
+    // The minirows holding at least one cell, or at least two cells.
+    static inline BitVec08x16 minirows(const BitVec08x16 & x) {
+        return (x | shr<1>(x) | shr<2>(x)) & full(kMinirows);
+    }
+
+    static inline BitVec08x16 minirowsTwoOrMore(const BitVec08x16 & x) {
+        BitVec08x16 x1 = shr<1>(x), x2 = shr<2>(x);
+        return ((x & x1) | (x & x2) | (x1 & x2)) & full(kMinirows);
+    }
+
+    // The cells of the given minirows.
+    static inline BitVec08x16 expandMinirows(const BitVec08x16 & m) {
+        return m | shl<1>(m) | shl<2>(m);
+    }
+
+    // The cells of the rows, or of the boxes, holding one of the given minirows.
+    static inline BitVec08x16 rowsOf(const BitVec08x16 & m) {
+        BitVec08x16 rows = (m | shr<3>(m) | shr<6>(m)) & full(kRowFirst);
+        return _mm_sub_epi32(shl<9>(rows).m128, rows.m128);
+    }
+
+    static inline BitVec08x16 boxesOf(const BitVec08x16 & m) {
+        return expandMinirows(m | rotateRows1(m) | rotateRows2(m));
+    }
+
+    // The set of columns holding a cell of the band, and back to cells.
+    static inline BitVec08x16 columnsOf(const BitVec08x16 & x) {
+        return (x | shr<9>(x) | shr<18>(x)) & full(kColumns9);
+    }
+
+    static inline BitVec08x16 expandColumns(const BitVec08x16 & c) {
+        return c | shl<9>(c) | shl<18>(c);
+    }
+
+    // Non-zero if some band of the bitboard is empty.
+    static inline int hasEmptyBand(const BitVec08x16 & x) {
+        __m128i is_zero = _mm_cmpeq_epi32(x.m128, _mm_setzero_si128());
+        return (_mm_movemask_ps(_mm_castsi128_ps(is_zero)) & 0x07);
+    }
+};
+
+template <int kSolutionMode>
+class JczBitboardSolver : public BasicSolver {
+public:
+    typedef BasicSolver         basic_solver;
+    typedef JczBitboardSolver   this_type;
+
+    static const uint32_t kBitSet27 = 0x07FFFFFFUL;
+
+    // Every level of the search places one more cell.
+    static const size_t kMaxSearchDepth = 81;
+
+private:
+    // states_[0] is the root state, states_[depth] the snapshot taken at that depth.
+    AlignedArena<JczState> states_;
+    char * solution_;
+    // The search gives up after this many guesses (see HybridSolver.h).
+    size_t limit_guesses_;
+    bool   aborted_;
+
+public:
+    JczBitboardSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : basic_solver(), states_(kMaxSearchDepth + 1, use_huge_pages), solution_(nullptr),
+          limit_guesses_(SIZE_MAX), aborted_(false) {}
+    ~JczBitboardSolver() {}
+
+private:
+    JSTD_FORCED_INLINE
+    JczState & nextSnapshot(JczState & state) {
+        assert(&state >= this->states_.data());
+        assert(&state < (this->states_.data() + kMaxSearchDepth));
+        return *(&state + 1);
+    }
+
+    //
+    // Place digit d in the cell pos, which must be a candidate of the cell.
+    //
+    static
+    JSTD_FORCED_INLINE
+    void assign(JczState & state, size_t d, size_t pos) {
+        const BitVec08x16 cell = jcz_tables.cell_mask[pos];
+        assert(state.digits[d].hasIntersects(cell));
+        for (size_t i = 0; i < 9; i++) {
+            state.digits[i] = state.digits[i].and_not(cell);
+        }
+        state.digits[d] = state.digits[d].and_not(jcz_tables.peer_mask[pos]) | cell;
+        state.unsolved = state.unsolved.and_not(cell);
+    }
+
+    //
+    // Place every cell of singles[d] as digit d, for all the digits at once. Returns false
+    // if two of them conflict: two digits in a cell, or a digit twice in a unit.
+    //
+    static bool placeSingles(JczState & state, const BitVec08x16 singles[9]) {
+        BitVec08x16 placed = singles[0];
+        BitVec08x16 conflicts;
+        conflicts.setAllZeros();
+        for (size_t d = 1; d < 9; d++) {
+            conflicts |= placed & singles[d];
+            placed |= singles[d];
+        }
+
+        for (size_t d = 0; d < 9; d++) {
+            const BitVec08x16 & cells = singles[d];
+            if (cells.isAllZeros()) {
+                state.digits[d] = state.digits[d].and_not(placed);
+                continue;
+            }
+            BitVec08x16 minirows = BandBits::minirows(cells);
+            BitVec08x16 columns = BandBits::columnsOf(cells);
+            BitVec08x16 columns1 = BandBits::rotateBands1(columns);
+            // Twice in a minirow, a row, a box, or a column (across two bands).
+            conflicts |= BandBits::minirowsTwoOrMore(cells) |
+                         (minirows & (BandBits::rotateBoxes1(minirows) | BandBits::rotateBoxes2(minirows))) |
+                         (minirows & (BandBits::rotateRows1(minirows) | BandBits::rotateRows2(minirows))) |
+                         (columns & columns1);
+            BitVec08x16 peers = BandBits::rowsOf(minirows) | BandBits::boxesOf(minirows) |
+                                BandBits::expandColumns(columns1 | BandBits::rotateBands2(columns));
+            state.digits[d] = state.digits[d].and_not(placed | peers) | cells;
+        }
+        state.unsolved = state.unsolved.and_not(placed);
+        return conflicts.isAllZeros();
+    }
+
+    //
+    // Propagate until nothing changes. Returns false on a contradiction.
+    //
+    static bool update(JczState & state) {
+        while (state.unsolved.isNotAllZeros()) {
+            BitVec08x16 singles[9];
+            BitVec08x16 changed, one, two;
+            changed.setAllZeros();
+            one.setAllZeros();
+            two.setAllZeros();
+            int empty_bands = 0;
+
+            for (size_t d = 0; d < 9; d++) {
+                const BitVec08x16 digit = state.digits[d];
+
+                // Keep the minirows that can take part in a placement of the digit.
+                BitVec08x16 minirows = BandBits::minirows(digit);
+                BitVec08x16 rows1 = BandBits::rotateRows1(minirows);
+                BitVec08x16 rows2 = BandBits::rotateRows2(minirows);
+                BitVec08x16 allowed = minirows &
+                    ((BandBits::rotateBoxes1(rows1) & BandBits::rotateBoxes2(rows2)) |
+                     (BandBits::rotateBoxes2(rows1) & BandBits::rotateBoxes1(rows2)));
+                BitVec08x16 cells = digit & BandBits::expandMinirows(allowed);
+
+                // A box with the digit in a single column claims it in the other bands.
+                BitVec08x16 columns = BandBits::columnsOf(cells);
+                BitVec08x16 multi_columns = BandBits::minirowsTwoOrMore(columns) &
+                                            BandBits::full(BandBits::kBoxFirst9);
+                BitVec08x16 claimed = columns.and_not(BandBits::expandMinirows(multi_columns));
+                cells = cells.and_not(BandBits::expandColumns(BandBits::rotateBands1(claimed) |
+                                                              BandBits::rotateBands2(claimed)));
+
+                changed |= cells ^ digit;
+                empty_bands |= BandBits::hasEmptyBand(cells);
+                state.digits[d] = cells;
+
+                // Hidden singles in the rows and the boxes: the only minirow of its row or
+                // box, with a single cell.
+                minirows = BandBits::minirows(cells);
+                BitVec08x16 row_only = minirows.and_not(BandBits::rotateBoxes1(minirows) |
+                                                        BandBits::rotateBoxes2(minirows));
+                BitVec08x16 box_only = minirows.and_not(BandBits::rotateRows1(minirows) |
+                                                        BandBits::rotateRows2(minirows));
+                BitVec08x16 single_minirows = (row_only | box_only).and_not(
+                                              BandBits::minirowsTwoOrMore(cells));
+                BitVec08x16 hidden = cells & BandBits::expandMinirows(single_minirows);
+
+                // Hidden singles in the columns: count the rows of every column over the
+                // three bands.
+                BitVec08x16 row0 = cells & BandBits::full(BandBits::kColumns9);
+                BitVec08x16 row1 = BandBits::shr<9>(cells) & BandBits::full(BandBits::kColumns9);
+                BitVec08x16 row2 = BandBits::shr<18>(cells);
+                BitVec08x16 band_one = row0 | row1 | row2;
+                BitVec08x16 band_two = (row0 & row1) | (row0 & row2) | (row1 & row2);
+                BitVec08x16 one1 = BandBits::rotateBands1(band_one);
+                BitVec08x16 one2 = BandBits::rotateBands2(band_one);
+                BitVec08x16 column_two = band_two | BandBits::rotateBands1(band_two) |
+                                         BandBits::rotateBands2(band_two) |
+                                         (band_one & one1) | (band_one & one2) | (one1 & one2);
+                BitVec08x16 column_one = band_one | one1 | one2;
+                hidden |= cells & BandBits::expandColumns(column_one.and_not(column_two));
+
+                singles[d] = hidden;
+
+                // Bit-sliced count of the candidates of every cell.
+                two |= one & cells;
+                one |= cells;
+            }
+
+            if (empty_bands != 0)
+                return false;
+            // An unsolved cell without a candidate.
+            if (state.unsolved.and_not(one).isNotAllZeros())
+                return false;
+
+            // Naked singles.
+            BitVec08x16 naked = state.unsolved.and_not(two);
+            BitVec08x16 any_singles = naked;
+            for (size_t d = 0; d < 9; d++) {
+                singles[d] = (singles[d] | (state.digits[d] & naked)) & state.unsolved;
+                any_singles |= singles[d];
+            }
+
+            if (any_singles.isNotAllZeros()) {
+                if (!placeSingles(state, singles))
+                    return false;
+            }
+            else if (changed.isAllZeros()) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    static inline int firstCell(const BitVec08x16 & mask) {
+        uint64_t low = mask.extractU64<0>();
+        if (low != 0) {
+            uint32_t bit = BitUtils::bsf64(low);
+            return (bit < 32) ? (int)bit : (int)(27 + bit - 32);
+        }
+        uint64_t high = mask.extractU64<1>();
+        return (high != 0) ? (int)(54 + BitUtils::bsf64(high)) : -1;
+    }
+
+    //
+    // Choose the cell to branch on: the first bivalue cell, or else the first unsolved
+    // cell.
+    //
+    static int chooseCell(const JczState & state) {
+        BitVec08x16 one = state.digits[0], two, three;
+        two.setAllZeros();
+        three.setAllZeros();
+        for (size_t d = 1; d < 9; d++) {
+            three |= two & state.digits[d];
+            two |= one & state.digits[d];
+            one |= state.digits[d];
+        }
+        BitVec08x16 pairs = state.unsolved & two.and_not(three);
+        if (pairs.isNotAllZeros())
+            return firstCell(pairs);
+        else
+            return firstCell(state.unsolved);
+    }
+
+    void search(JczState & state) {
+        if (!update(state))
+            return;
+        if (state.unsolved.isAllZeros()) {
+            this->num_solutions_++;
+            if (kSolutionMode == 1 && this->num_solutions_ == this->limit_solutions_) {
+                extractSolution(state, this->solution_);
+            }
+            return;
+        }
+
+        int pos = chooseCell(state);
+        assert(pos >= 0);
+        const BitVec08x16 cell = jcz_tables.cell_mask[pos];
+        uint32_t candidates = 0;
+        for (uint32_t d = 0; d < 9; d++) {
+            candidates |= state.digits[d].hasIntersects(cell) ? (1u << d) : 0u;
+        }
+
+        while (candidates != 0) {
+            uint32_t d = BitUtils::bsf32(candidates);
+            candidates = BitUtils::clearLowBit32(candidates);
+            if (candidates != 0) {
+                // Try d on a snapshot, keep the state for the other candidates.
+                this->num_guesses_++;
+                if (this->num_guesses_ > this->limit_guesses_) {
+                    this->aborted_ = true;
+                    return;
+                }
+                JczState & next_state = this->nextSnapshot(state);
+                next_state.copy(state);
+                assign(next_state, d, pos);
+                search(next_state);
+                if (this->num_solutions_ == this->limit_solutions_ || this->aborted_) return;
+            } else {
+                // The last candidate: no snapshot needed.
+                assign(state, d, pos);
+                search(state);
+            }
+        }
+    }
+
+    static void extractSolution(const JczState & state, char * solution) {
+        for (size_t d = 0; d < 9; d++) {
+            alignas(16) uint32_t bands[4];
+            state.digits[d].saveAligned((void *)&bands[0]);
+            for (uint32_t band = 0; band < 3; band++) {
+                uint32_t bits = bands[band];
+                while (bits != 0) {
+                    uint32_t bit = BitUtils::bsf32(bits);
+                    solution[band * 27 + bit] = (char)('1' + d);
+                    bits = BitUtils::clearLowBit32(bits);
+                }
+            }
+        }
+    }
+
+public:
+    //
+    // Set up the root state from the clues. Returns false if two clues conflict.
+    //
+    static bool initSudoku(const char * puzzle, JczState & state) {
+        const BitVec08x16 all_cells(kBitSet27, kBitSet27, kBitSet27, 0u);
+        for (size_t d = 0; d < 9; d++) {
+            state.digits[d] = all_cells;
+        }
+        state.unsolved = all_cells;
+
+        alignas(16) uint32_t clues[9][4];
+        std::memset((void *)&clues[0][0], 0, sizeof(clues));
+        for (uint32_t band = 0; band < 3; band++) {
+            for (uint32_t bit = 0; bit < 27; bit++) {
+                uint32_t digit = (uint32_t)(uint8_t)puzzle[band * 27 + bit] - (uint32_t)'1';
+                if (digit < 9) {
+                    clues[digit][band] |= 1u << bit;
+                }
+            }
+        }
+
+        BitVec08x16 singles[9];
+        for (size_t d = 0; d < 9; d++) {
+            singles[d].loadAligned((const void *)&clues[d][0]);
+        }
+        return placeSingles(state, singles);
+    }
+
+    //
+    // The root state of the search, for a caller that drives initSudoku() and propagate()
+    // itself before solveFromRoot() (see HybridSolver.h).
+    //
+    JczState & rootState() {
+        return this->states_[0];
+    }
+
+    static bool propagate(JczState & state) {
+        return update(state);
+    }
+
+    static size_t countUnsolved(const JczState & state) {
+        return (size_t)state.unsolved.popcount();
+    }
+
+    size_t get_limit_guesses() const {
+        return this->limit_guesses_;
+    }
+
+    void set_limit_guesses(size_t limit_guesses) {
+        this->limit_guesses_ = limit_guesses;
+    }
+
+    // The last search ran into the guess limit, its result is incomplete.
+    bool aborted() const {
+        return this->aborted_;
+    }
+
+    void resetStatistics(size_t limit) {
+        this->set_num_guesses(0);
+        this->set_num_solutions(0);
+        this->set_limit_solutions(limit);
+        this->aborted_ = false;
+    }
+
+    //
+    // Search from the root state, which has been set up by initSudoku() (and possibly
+    // propagated already).
+    //
+    size_t solveFromRoot(char * solution, size_t limit) {
+        this->resetStatistics(limit);
+        this->solution_ = solution;
+        search(this->states_[0]);
+        return this->num_solutions_;
+    }
+
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        this->resetStatistics(limit);
+        this->solution_ = solution;
+
+        JczState & state = this->states_[0];
+        if (initSudoku(puzzle, state)) {
+            search(state);
+        }
+        return this->num_solutions_;
+    }
+
+    void display_result(Board & board, double elapsed_time,
+                        bool print_answer = true,
+                        bool print_all_answers = true) {
+        basic_solver::display_result<SearchMode::OneSolution>(board, elapsed_time,
+                                                              print_answer, print_all_answers);
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_JCZ_BITBOARD_SOLVER_H
@@ -0,0 +1,396 @@
+
+#ifndef GUDOKU_KILLER_SUDOKU_SOLVER_H
+#define GUDOKU_KILLER_SUDOKU_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitUtils.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/StaticData.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// Killer sudoku on the Box/Band state of DpllTriadSimdSolver.
+//
+// A killer puzzle is a line of the 81 cage ids of the cells ('a' - 'z', 'A' - 'Z'), a ':'
+// and the cage sums in id order, comma separated, e.g.
+//
+//   aabbcddeeafgghcdi...:3,15,22,4,...
+//
+// The digits of a cage are distinct and add up to its sum. For a cage of n cells with the
+// sum s, the digit sets it can hold come from the (n, s) tables below; the sets a cage can
+// still hold in a state are the ones that contain its solved digits and meet every one of
+// its cells. Their union restricts the cells of the cage, their intersection (the digits
+// the cage must hold) gives the hidden singles. The pass over the cages runs to a fixpoint
+// at every node of the search, between the band eliminations of DpllTriadSimdSolver, and
+// its eliminations go through boxRestrict() and so through the bands again.
+//
+
+using namespace gudoku;
+
+namespace {
+
+static const size_t kMaxCages = 52;
+// The rows, columns and boxes, each of which can add one implied cage.
+static const size_t kHouses = 27;
+static const size_t kMaxCageSize = 9;
+static const size_t kMaxCageSum = 45;
+// The most digit sets of one (n, s): 4 cells with the sum 20, or 5 with the sum 25.
+static const size_t kMaxCageCombos = 12;
+
+// The buffer of a killer puzzle line.
+static const size_t kKillerLineSize = 256;
+typedef BasicBoard<kKillerLineSize> KillerBoard;
+
+struct alignas(64) CageTables {
+    // @formatter:off
+    // For a cage of n cells with the sum s, the digit sets (9-bit masks) it can hold.
+    uint16_t    combos[kMaxCageSize + 1][kMaxCageSum + 1][kMaxCageCombos];
+    uint8_t     num_combos[kMaxCageSize + 1][kMaxCageSum + 1];
+    // @formatter:on
+
+    static constexpr uint32_t maskSize(uint32_t mask) {
+        return ((mask == 0) ? 0 : ((mask & 1U) + maskSize(mask >> 1U)));
+    }
+
+    static constexpr uint32_t maskSum(uint32_t mask, uint32_t digit = 1) {
+        return ((mask == 0) ? 0 : (((mask & 1U) ? digit : 0) + maskSum(mask >> 1U, digit + 1)));
+    }
+
+    static constexpr bool isCombo(size_t n, size_t s, uint32_t mask) {
+        return ((maskSize(mask) == n) && (maskSum(mask) == s));
+    }
+
+    // The number of digit sets of (n, s) among the masks [first, last), split in halves
+    // to keep the constexpr recursion shallow.
+    static constexpr uint32_t countCombos(size_t n, size_t s, uint32_t first = 0, uint32_t last = 512) {
+        return ((last - first == 1) ? (isCombo(n, s, first) ? 1 : 0) :
+                (countCombos(n, s, first, (first + last) / 2) + countCombos(n, s, (first + last) / 2, last)));
+    }
+
+    // The index-th digit set of (n, s) among the masks [first, last).
+    static constexpr uint32_t nthCombo(size_t n, size_t s, uint32_t index, uint32_t first = 0, uint32_t last = 512) {
+        return ((last - first == 1) ? first :
+                ((index < countCombos(n, s, first, (first + last) / 2)) ?
+                 nthCombo(n, s, index, first, (first + last) / 2) :
+                 nthCombo(n, s, index - countCombos(n, s, first, (first + last) / 2), (first + last) / 2, last)));
+    }
+
+    static constexpr uint16_t combo(size_t n, size_t s, size_t index) {
+        return ((index < countCombos(n, s)) ? (uint16_t)nthCombo(n, s, (uint32_t)index) : 0);
+    }
+
+    template <size_t... Combos, size_t... Keys>
+    static constexpr CageTables make(IndexSequence<Combos...>, IndexSequence<Keys...>) {
+        return CageTables {
+            // combos[kMaxCageSize + 1][kMaxCageSum + 1][kMaxCageCombos]
+            { combo(Combos / ((kMaxCageSum + 1) * kMaxCageCombos),
+                    (Combos / kMaxCageCombos) % (kMaxCageSum + 1), Combos % kMaxCageCombos)... },
+            // num_combos[kMaxCageSize + 1][kMaxCageSum + 1]
+            { (uint8_t)countCombos(Keys / (kMaxCageSum + 1), Keys % (kMaxCageSum + 1))... }
+        };
+    }
+};
+
+static constexpr CageTables cage_tables =
+    CageTables::make(MakeIndexSequence<(kMaxCageSize + 1) * (kMaxCageSum + 1) * kMaxCageCombos>::type(),
+                     MakeIndexSequence<(kMaxCageSize + 1) * (kMaxCageSum + 1)>::type());
+
+static_assert(CageTables::countCombos(4, 20) == kMaxCageCombos, "kMaxCageCombos is the count of (4, 20)");
+
+struct Cage {
+    uint8_t size;
+    uint8_t sum;
+    uint8_t boxes[kMaxCageSize];
+    uint8_t lanes[kMaxCageSize];
+};
+
+template <int kSolutionMode>
+class KillerSudokuSolver : public DpllTriadSimdSolver<kSolutionMode> {
+public:
+    typedef DpllTriadSimdSolver<kSolutionMode>  dpll_solver;
+    typedef KillerSudokuSolver                  this_type;
+
+private:
+    Cage    cages_[kMaxCages + kHouses];
+    size_t  num_cages_;
+
+public:
+    KillerSudokuSolver() : dpll_solver(), num_cages_(0) {}
+    ~KillerSudokuSolver() {}
+
+private:
+    static int cageIndex(char id) {
+        if (id >= 'a' && id <= 'z')
+            return (id - 'a');
+        else if (id >= 'A' && id <= 'Z')
+            return (id - 'A' + 26);
+        else
+            return -1;
+    }
+
+    // Read the cages of a puzzle line, false if it is malformed.
+    bool parseCages(const char * puzzle) {
+        uint8_t cell_cages[Sudoku::BoardSize];
+        this->num_cages_ = 0;
+        for (size_t pos = 0; pos < Sudoku::BoardSize; pos++) {
+            int index = cageIndex(puzzle[pos]);
+            if (index < 0)
+                return false;
+            cell_cages[pos] = (uint8_t)index;
+            while (this->num_cages_ <= (size_t)index) {
+                this->cages_[this->num_cages_++].size = 0;
+            }
+            Cage & cage = this->cages_[index];
+            if (cage.size >= kMaxCageSize)
+                return false;
+            const BoxIndexing & indexing = tables.box_indexing[pos];
+            cage.boxes[cage.size] = indexing.box;
+            cage.lanes[cage.size] = indexing.cell;
+            cage.size++;
+        }
+
+        const char * sums = puzzle + Sudoku::BoardSize;
+        if (*sums != ':')
+            return false;
+        for (size_t index = 0; index < this->num_cages_; index++) {
+            sums++;
+            uint32_t sum = 0;
+            const char * first = sums;
+            while (*sums >= '0' && *sums <= '9') {
+                sum = sum * 10 + (uint32_t)(*sums - '0');
+                sums++;
+            }
+            Cage & cage = this->cages_[index];
+            if (sums == first || cage.size == 0 || sum > kMaxCageSum)
+                return false;
+            cage.sum = (uint8_t)sum;
+            if (*sums != ',' && index + 1 < this->num_cages_)
+                return false;
+        }
+
+        for (size_t house = 0; house < kHouses; house++) {
+            this->addHouseCage(house, cell_cages);
+        }
+        return true;
+    }
+
+    static size_t houseCell(size_t house, size_t i) {
+        return ((house < 9) ? (house * 9 + i) :
+                (house < 18) ? (i * 9 + house - 9) :
+                (((house - 18) / 3 * 3 + i / 3) * 9 + (house - 18) % 3 * 3 + i % 3));
+    }
+
+    //
+    // The rule of 45: the cells of a row, column or box outside the cages that lie inside
+    // it hold distinct digits adding up to 45 minus the sums of those cages, an implied cage.
+    //
+    void addHouseCage(size_t house, const uint8_t cell_cages[Sudoku::BoardSize]) {
+        uint8_t cells_in_house[kMaxCages] = { 0 };
+        for (size_t i = 0; i < 9; i++) {
+            cells_in_house[cell_cages[houseCell(house, i)]]++;
+        }
+        Cage & implied = this->cages_[this->num_cages_];
+        implied.size = 0;
+        uint32_t sum = 45;
+        for (size_t i = 0; i < 9; i++) {
+            size_t pos = houseCell(house, i);
+            const Cage & cage = this->cages_[cell_cages[pos]];
+            if (cells_in_house[cell_cages[pos]] == cage.size) {
+                sum -= cage.sum;
+                cells_in_house[cell_cages[pos]] = 0;
+            } else if (cells_in_house[cell_cages[pos]] != 0) {
+                const BoxIndexing & indexing = tables.box_indexing[pos];
+                implied.boxes[implied.size] = indexing.box;
+                implied.lanes[implied.size] = indexing.cell;
+                implied.size++;
+            }
+        }
+        if (implied.size != 0 && implied.size < 9 && sum <= kMaxCageSum) {
+            implied.sum = (uint8_t)sum;
+            this->num_cages_++;
+        }
+    }
+
+    static bool isSingle(uint32_t digits) {
+        return ((digits & (digits - 1)) == 0);
+    }
+
+    //
+    // One pass over the cages, on a copy of the box cells. A cell belongs to one cage, so
+    // the copy is what each cage has seen: the cages whose cells are the same as in the
+    // copy of the previous pass (if any) are skipped. Returns false on a contradiction,
+    // changed tells whether a candidate was eliminated.
+    //
+    bool cagesEliminate(State & state, uint16_t cells[9][16], const uint16_t previous[9][16],
+                        bool & changed) {
+        alignas(32) uint16_t candidates[9][16];
+        const BitVec16x16 all_ones = BitVec16x16::full16(0xFFFF);
+        for (size_t box = 0; box < 9; box++) {
+            state.boxes[box].cells.saveAligned(&cells[box][0]);
+            all_ones.saveAligned(&candidates[box][0]);
+        }
+
+        uint32_t touched_boxes = 0;
+        for (size_t index = 0; index < this->num_cages_; index++) {
+            const Cage & cage = this->cages_[index];
+            uint32_t cage_cells[kMaxCageSize];
+            uint32_t all_digits = 0, solved = 0;
+            bool dirty = (previous == nullptr);
+            for (size_t i = 0; i < cage.size; i++) {
+                uint32_t digits = cells[cage.boxes[i]][cage.lanes[i]];
+                dirty |= (previous != nullptr && digits != previous[cage.boxes[i]][cage.lanes[i]]);
+                cage_cells[i] = digits;
+                all_digits |= digits;
+                if (isSingle(digits)) {
+                    if ((solved & digits) != 0) return false;
+                    solved |= digits;
+                }
+            }
+            if (!dirty)
+                continue;
+
+            // The digit sets the cage can still hold.
+            uint32_t possible = 0, required = kAll;
+            const uint16_t * combos = &cage_tables.combos[cage.size][cage.sum][0];
+            size_t num_combos = cage_tables.num_combos[cage.size][cage.sum];
+            for (size_t j = 0; j < num_combos; j++) {
+                uint32_t combo = combos[j];
+                if ((combo & solved) != solved || (combo & all_digits) != combo)
+                    continue;
+                size_t i = 0;
+                while (i < cage.size && (cage_cells[i] & combo) != 0) {
+                    i++;
+                }
+                if (i == cage.size) {
+                    possible |= combo;
+                    required &= combo;
+                }
+            }
+            if (possible == 0) return false;
+
+            // The required digits left with one cell of the cage.
+            uint32_t once = 0, twice = 0;
+            for (size_t i = 0; i < cage.size; i++) {
+                twice |= once & cage_cells[i];
+                once |= cage_cells[i];
+            }
+            uint32_t hidden = required & once & ~twice & ~solved;
+
+            for (size_t i = 0; i < cage.size; i++) {
+                uint32_t digits = cage_cells[i];
+                uint32_t remain = digits & possible;
+                if (!isSingle(digits)) {
+                    remain &= ~solved;
+                    uint32_t placed = remain & hidden;
+                    if (placed != 0) {
+                        if (!isSingle(placed)) return false;
+                        remain = placed;
+                    }
+                }
+                if (remain == 0) return false;
+                if (remain != digits) {
+                    candidates[cage.boxes[i]][cage.lanes[i]] &= (uint16_t)remain;
+                    touched_boxes |= 1U << cage.boxes[i];
+                }
+            }
+        }
+
+        changed = (touched_boxes != 0);
+        while (touched_boxes != 0) {
+            uint32_t box = BitUtils::bsf32(touched_boxes);
+            BitVec16x16 box_candidates;
+            box_candidates.loadAligned(&candidates[box][0]);
+            if (!dpll_solver::template boxRestrict<kHorizontal>(state, (int)box, box_candidates))
+                return false;
+            touched_boxes = BitUtils::clearLowBit32(touched_boxes);
+        }
+        return true;
+    }
+
+    bool cagesPropagate(State & state) {
+        alignas(32) uint16_t cells[2][9][16];
+        bool changed;
+        if (!this->cagesEliminate(state, cells[0], nullptr, changed))
+            return false;
+        size_t current = 0;
+        while (changed) {
+            current ^= 1;
+            if (!this->cagesEliminate(state, cells[current], cells[current ^ 1], changed))
+                return false;
+        }
+        return true;
+    }
+
+    template <int vertical>
+    JSTD_FORCED_INLINE
+    void branchOnBandAndValue(int band_idx, const BitVec08x16 & value_mask, State & state) {
+        Band & band = state.bands[vertical][band_idx];
+        BitVec08x16 value_configurations = band.configurations & value_mask;
+        this->num_guesses_++;
+        State & next_state = this->nextSnapshot(state);
+        next_state.copy(state);
+        BitVec08x16 assignment_elims = value_configurations.clearLowBit();
+        next_state.bands[vertical][band_idx].eliminations |= assignment_elims;
+        if (dpll_solver::template bandEliminate<vertical>(next_state, band_idx)) {
+            this->countSolutions(next_state);
+            if (this->num_solutions_ == this->limit_solutions_) return;
+        }
+        BitVec08x16 negation_elims = value_configurations ^ assignment_elims;
+        state.bands[vertical][band_idx].eliminations |= negation_elims;
+        if (dpll_solver::template bandEliminate<vertical>(state, band_idx)) {
+            this->countSolutions(state);
+        }
+    }
+
+    // countSolutionsConsistentWithPartialAssignment() of DpllTriadSimdSolver, with the
+    // cages propagated first at every node.
+    void countSolutions(State & state) {
+        if (!this->cagesPropagate(state))
+            return;
+        auto band_and_value = dpll_solver::chooseBandAndValueToBranch(state);
+        if (band_and_value.first == dpll_solver::NONE) {
+            this->num_solutions_++;
+            if (kSolutionMode == 1 && this->num_solutions_ == this->limit_solutions_) {
+                this->result_state_.copy_boxes(state);
+            }
+        } else {
+            if (band_and_value.first < 3) {
+                this->template branchOnBandAndValue<kHorizontal>(
+                        tables.mod3[band_and_value.first], band_and_value.second, state);
+            } else {
+                this->template branchOnBandAndValue<kVertical>(
+                        tables.mod3[band_and_value.first], band_and_value.second, state);
+            }
+        }
+    }
+
+public:
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        this->resetStatistics(limit);
+        if (!this->parseCages(puzzle))
+            return 0;
+
+        State & state = this->states_[0];
+        state.init();
+        this->countSolutions(state);
+        if (kSolutionMode == 1 && this->num_solutions_ != 0)
+            dpll_solver::extractSolution(this->result_state_, solution);
+        return this->num_solutions_;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_KILLER_SUDOKU_SOLVER_H
@@ -0,0 +1,504 @@
+
+#ifndef GUDOKU_MINI_SUDOKU_SOLVER_H
+#define GUDOKU_MINI_SUDOKU_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset()
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/BitUtils.h"
+#include "gudoku/StaticData.h"
+#include "gudoku/AlignedArena.h"
+
+//
+// SIMD solvers for the small grids, Sudoku4x4 (2 x 2 boxes) and Sudoku6x6 (3 wide x 2
+// tall boxes), specialized at compile time from the BasicSudoku geometry.
+//
+// A cell is one byte of candidates (bit = digit), a row is kRowLanes bytes (the columns
+// rounded up to a power of 2, the padding lanes stay zero), and every BitVec08x16 holds
+// whole bands:
+//
+//   4 x 4:   4 rows of 4 lanes:  the whole grid is 1 register
+//   6 x 6:   2 rows of 8 lanes:  3 registers, one band (2 boxes) each
+//
+// The peers of a cell are byte shuffles (pshufb) of its register, from tables built with
+// BasicBoxIndexing: Cols - 1 rotations along the row, BoxSize - 1 rotations around the
+// box, and the rows of the register rotated for the column, which is then combined with
+// the other registers lane by lane. The propagation is the one of HexadokuSimdSolver,
+// naked singles and hidden singles until nothing changes, then a guess on a bivalue cell
+// (else the cell with the fewest candidates).
+//
+// Puzzles are Rows * Cols characters, the digits are '1' - '4' (or '1' - '6'), anything
+// else is an empty cell. Needs SSSE3 (pshufb).
+//
+
+using namespace gudoku;
+
+namespace {
+
+template <typename SudokuT>
+struct MiniGeometry {
+    static const size_t kRows = SudokuT::Rows;
+    static const size_t kCols = SudokuT::Cols;
+    static const size_t kBoxCellsX = SudokuT::BoxCellsX;
+    static const size_t kBoxCellsY = SudokuT::BoxCellsY;
+    static const size_t kBoxSize = SudokuT::BoxSize;
+    static const size_t kNumbers = SudokuT::Numbers;
+
+    static const size_t kRowLanes = (kCols <= 4) ? 4 : 8;
+    static const size_t kRowsPerVector = 16 / kRowLanes;
+    static const size_t kVectors = kRows / kRowsPerVector;
+
+    static const uint32_t kAllNumbers = (1u << kNumbers) - 1;
+
+    static_assert((kCols <= 8), "A row must fit in 8 lanes");
+    static_assert((kRowsPerVector % kBoxCellsY) == 0, "A register must hold whole bands");
+    static_assert((kRows % kRowsPerVector) == 0, "The rows must fill the registers");
+};
+
+//
+// Constant-initialized shuffle controls (see StaticData.h), 0x80 zeroes a padding lane.
+//
+template <typename SudokuT>
+struct alignas(16) MiniTables {
+    typedef MiniGeometry<SudokuT>       geometry;
+    typedef BasicBoxIndexing<SudokuT>   box_indexing;
+
+    static const size_t kCols = geometry::kCols;
+    static const size_t kBoxCellsX = geometry::kBoxCellsX;
+    static const size_t kBoxSize = geometry::kBoxSize;
+    static const size_t kRowLanes = geometry::kRowLanes;
+    static const size_t kRowsPerVector = geometry::kRowsPerVector;
+
+    ConstBitVec<BitVec08x16> row_peers[kCols - 1];
+    ConstBitVec<BitVec08x16> box_peers[kBoxSize - 1];
+    ConstBitVec<BitVec08x16> col_peers[kRowsPerVector - 1];
+    ConstBitVec<BitVec08x16> cell_lanes;    // 0xFF in the lanes of a cell
+    ConstBitVec<BitVec08x16> all_numbers;   // All the digits in the lanes of a cell
+
+    static constexpr bool isCell(size_t lane) {
+        return ((lane % kRowLanes) < kCols);
+    }
+
+    // The position of a lane's cell, as if its register held the first rows.
+    static constexpr uint32_t posOf(size_t lane) {
+        return (uint32_t)(lane / kRowLanes * kCols + lane % kRowLanes);
+    }
+
+    static constexpr uint8_t rowPeer(size_t k, size_t lane) {
+        return isCell(lane) ? (uint8_t)(lane / kRowLanes * kRowLanes + (lane % kRowLanes + k) % kCols)
+                            : (uint8_t)0x80;
+    }
+
+    static constexpr uint8_t colPeer(size_t k, size_t lane) {
+        return isCell(lane) ? (uint8_t)((lane / kRowLanes + k) % kRowsPerVector * kRowLanes + lane % kRowLanes)
+                            : (uint8_t)0x80;
+    }
+
+    // The lane of the cell-th cell of the box of a lane's cell.
+    static constexpr uint8_t boxLane(size_t lane, const box_indexing & indexing, size_t cell) {
+        return (uint8_t)((lane / kRowLanes - indexing.cell_y + cell / kBoxCellsX) * kRowLanes +
+                         indexing.box_x * kBoxCellsX + cell % kBoxCellsX);
+    }
+
+    static constexpr uint8_t boxPeer(size_t k, size_t lane) {
+        return isCell(lane) ? boxLane(lane, box_indexing(posOf(lane)),
+                                      (box_indexing(posOf(lane)).cell + k) % kBoxSize)
+                            : (uint8_t)0x80;
+    }
+
+    static constexpr uint8_t cellLane(size_t lane, uint8_t value) {
+        return isCell(lane) ? value : (uint8_t)0;
+    }
+
+    static constexpr uint16_t lane16(uint8_t low, uint8_t high) {
+        return (uint16_t)(low | ((uint16_t)high << 8));
+    }
+
+    template <size_t... Rows, size_t... Boxes, size_t... Cols, size_t... Lanes>
+    static constexpr MiniTables make(IndexSequence<Rows...>, IndexSequence<Boxes...>,
+                                     IndexSequence<Cols...>, IndexSequence<Lanes...>) {
+        return MiniTables {
+            // row_peers[kCols - 1]
+            { lane16(rowPeer(Rows / 8 + 1, Rows % 8 * 2), rowPeer(Rows / 8 + 1, Rows % 8 * 2 + 1))... },
+            // box_peers[kBoxSize - 1]
+            { lane16(boxPeer(Boxes / 8 + 1, Boxes % 8 * 2), boxPeer(Boxes / 8 + 1, Boxes % 8 * 2 + 1))... },
+            // col_peers[kRowsPerVector - 1]
+            { lane16(colPeer(Cols / 8 + 1, Cols % 8 * 2), colPeer(Cols / 8 + 1, Cols % 8 * 2 + 1))... },
+            // cell_lanes
+            { lane16(cellLane(Lanes * 2, 0xFF), cellLane(Lanes * 2 + 1, 0xFF))... },
+            // all_numbers
+            { lane16(cellLane(Lanes * 2, (uint8_t)geometry::kAllNumbers),
+                     cellLane(Lanes * 2 + 1, (uint8_t)geometry::kAllNumbers))... }
+        };
+    }
+
+    static const MiniTables & get() {
+        static constexpr MiniTables tables = make(typename MakeIndexSequence<(kCols - 1) * 8>::type(),
+                                                  typename MakeIndexSequence<(kBoxSize - 1) * 8>::type(),
+                                                  typename MakeIndexSequence<(kRowsPerVector - 1) * 8>::type(),
+                                                  typename MakeIndexSequence<8>::type());
+        return tables;
+    }
+};
+
+template <typename SudokuT>
+struct alignas(16) MiniState {
+    static const size_t kVectors = MiniGeometry<SudokuT>::kVectors;
+
+    BitVec08x16 vectors[kVectors];
+
+    void copy(const MiniState & src) {
+        for (size_t i = 0; i < kVectors; i++) {
+            this->vectors[i] = src.vectors[i];
+        }
+    }
+};
+
+template <int kSolutionMode, typename SudokuT>
+class MiniSudokuSolver : public BasicSolver {
+public:
+    typedef BasicSolver             basic_solver;
+    typedef MiniSudokuSolver        this_type;
+    typedef MiniGeometry<SudokuT>   geometry;
+    typedef MiniTables<SudokuT>     tables_type;
+    typedef MiniState<SudokuT>      state_type;
+    typedef BitVec08x16             vector_type;
+
+    static const size_t kRows = geometry::kRows;
+    static const size_t kCols = geometry::kCols;
+    static const size_t kBoxSize = geometry::kBoxSize;
+    static const size_t kNumbers = geometry::kNumbers;
+    static const size_t kRowLanes = geometry::kRowLanes;
+    static const size_t kRowsPerVector = geometry::kRowsPerVector;
+    static const size_t kVectors = geometry::kVectors;
+    static const size_t kLanes = kVectors * 16;
+    static const size_t kBoardSize = SudokuT::BoardSize;
+
+    // Every level of the search solves one more cell.
+    static const size_t kMaxSearchDepth = kBoardSize;
+
+private:
+    // states_[0] is the root state, states_[depth] the snapshot taken at that depth.
+    AlignedArena<state_type> states_;
+    char * solution_;
+
+public:
+    MiniSudokuSolver(bool use_huge_pages = (GUDOKU_USE_HUGE_PAGES != 0))
+        : basic_solver(), states_(kMaxSearchDepth + 1, use_huge_pages), solution_(nullptr) {}
+    ~MiniSudokuSolver() {}
+
+private:
+    JSTD_FORCED_INLINE
+    state_type & nextSnapshot(state_type & state) {
+        assert(&state >= this->states_.data());
+        assert(&state < (this->states_.data() + kMaxSearchDepth));
+        return *(&state + 1);
+    }
+
+    // Fold the lanes of a shuffle into the (once, twice) counts.
+    static
+    JSTD_FORCED_INLINE
+    void combine(vector_type & once, vector_type & twice,
+                 const vector_type & once2, const vector_type & twice2) {
+        twice = twice | twice2 | (once & once2);
+        once = once | once2;
+    }
+
+    // Count the digits of one more cell of the unit, lane by lane.
+    static
+    JSTD_FORCED_INLINE
+    void accumulate(vector_type & once, vector_type & twice, const vector_type & cells) {
+        twice |= once & cells;
+        once |= cells;
+    }
+
+    static
+    JSTD_FORCED_INLINE
+    void reduceRows(const vector_type & cells, vector_type & once, vector_type & twice) {
+        const tables_type & tables = tables_type::get();
+        once = cells;
+        twice.setAllZeros();
+        for (size_t k = 0; k < kCols - 1; k++) {
+            accumulate(once, twice, cells.shuffle(tables.row_peers[k]));
+        }
+    }
+
+    static
+    JSTD_FORCED_INLINE
+    void reduceBoxes(const vector_type & cells, vector_type & once, vector_type & twice) {
+        const tables_type & tables = tables_type::get();
+        once = cells;
+        twice.setAllZeros();
+        for (size_t k = 0; k < kBoxSize - 1; k++) {
+            accumulate(once, twice, cells.shuffle(tables.box_peers[k]));
+        }
+    }
+
+    // The columns: the registers lane by lane, then the rows of a register.
+    static
+    JSTD_FORCED_INLINE
+    void reduceCols(const vector_type cells[kVectors], vector_type & once, vector_type & twice) {
+        const tables_type & tables = tables_type::get();
+        vector_type lane_once = cells[0], lane_twice;
+        lane_twice.setAllZeros();
+        for (size_t i = 1; i < kVectors; i++) {
+            accumulate(lane_once, lane_twice, cells[i]);
+        }
+        once = lane_once;
+        twice = lane_twice;
+        for (size_t k = 0; k < kRowsPerVector - 1; k++) {
+            combine(once, twice, lane_once.shuffle(tables.col_peers[k]),
+                                 lane_twice.shuffle(tables.col_peers[k]));
+        }
+    }
+
+    // 0xFF in the lanes of a solved cell (one candidate), of an empty one and the padding.
+    static
+    JSTD_FORCED_INLINE
+    vector_type whichIsSingle(const vector_type & cells) {
+        return cells.whichIsEqual8(cells.getLowBit8());
+    }
+
+    //
+    // Remove the solved digits of every unit from the unsolved cells. Returns false on a
+    // digit solved twice in a unit.
+    //
+    static bool nakedSingles(state_type & state) {
+        vector_type singles[kVectors];
+        vector_type solved[kVectors];
+        for (size_t i = 0; i < kVectors; i++) {
+            singles[i] = whichIsSingle(state.vectors[i]);
+            solved[i] = state.vectors[i] & singles[i];
+        }
+
+        vector_type col_once, col_twice;
+        reduceCols(solved, col_once, col_twice);
+        vector_type duplicates = col_twice;
+
+        for (size_t i = 0; i < kVectors; i++) {
+            vector_type row_once, row_twice, box_once, box_twice;
+            reduceRows(solved[i], row_once, row_twice);
+            reduceBoxes(solved[i], box_once, box_twice);
+            duplicates |= row_twice | box_twice;
+
+            vector_type used = row_once | col_once | box_once;
+            state.vectors[i] = state.vectors[i].and_not(used.and_not(singles[i]));
+        }
+        return duplicates.isAllZeros();
+    }
+
+    //
+    // Place the digits with one place left in a unit: the cells of the lanes are set to
+    // (cells & hidden) where that isn't empty. Returns false on a unit missing a digit, or
+    // a cell with two hidden singles.
+    //
+    static
+    JSTD_FORCED_INLINE
+    bool placeHidden(vector_type & cells, const vector_type & once, const vector_type & twice) {
+        const tables_type & tables = tables_type::get();
+        vector_type hidden = once.and_not(twice);
+        vector_type placed = cells & hidden;
+        cells = placed | (cells & placed.whichIsZeros8());
+        return (once.isEqual(tables.all_numbers) &&
+                placed.whichIsEqual8(placed.getLowBit8()).isAllOnes());
+    }
+
+    static bool hiddenSingles(state_type & state) {
+        bool valid = true;
+
+        // Rows and boxes
+        for (size_t i = 0; i < kVectors; i++) {
+            vector_type once, twice;
+            reduceRows(state.vectors[i], once, twice);
+            valid &= placeHidden(state.vectors[i], once, twice);
+            reduceBoxes(state.vectors[i], once, twice);
+            valid &= placeHidden(state.vectors[i], once, twice);
+        }
+
+        // Columns
+        vector_type col_once, col_twice;
+        reduceCols(state.vectors, col_once, col_twice);
+        for (size_t i = 0; i < kVectors; i++) {
+            valid &= placeHidden(state.vectors[i], col_once, col_twice);
+        }
+        return valid;
+    }
+
+    //
+    // Propagate the singles until nothing changes. Returns false on a contradiction.
+    //
+    static bool update(state_type & state) {
+        const tables_type & tables = tables_type::get();
+        for (;;) {
+            state_type last;
+            last.copy(state);
+
+            if (!nakedSingles(state))
+                return false;
+            if (!hiddenSingles(state))
+                return false;
+
+            vector_type changed, empties;
+            changed.setAllZeros();
+            empties.setAllZeros();
+            for (size_t i = 0; i < kVectors; i++) {
+                changed |= state.vectors[i] ^ last.vectors[i];
+                empties |= state.vectors[i].whichIsZeros8();
+            }
+            if (!(empties & tables.cell_lanes).isAllZeros())
+                return false;
+            if (changed.isAllZeros())
+                return true;
+        }
+    }
+
+    static bool isSolved(const state_type & state) {
+        vector_type singles = whichIsSingle(state.vectors[0]);
+        for (size_t i = 1; i < kVectors; i++) {
+            singles &= whichIsSingle(state.vectors[i]);
+        }
+        return singles.isAllOnes();
+    }
+
+    //
+    // The first bivalue cell, else the unsolved cell with the fewest candidates, as a
+    // lane of the state.
+    //
+    static int chooseCell(const state_type & state) {
+        alignas(16) uint8_t lanes[kLanes];
+        for (size_t i = 0; i < kVectors; i++) {
+            state.vectors[i].saveAligned((void *)&lanes[i * 16]);
+        }
+
+        int best_lane = -1;
+        uint32_t best_count = kNumbers + 1;
+        for (size_t lane = 0; lane < kLanes; lane++) {
+            uint32_t count = BitUtils::popcnt32((uint32_t)lanes[lane]);
+            if (count > 1 && count < best_count) {
+                best_count = count;
+                best_lane = (int)lane;
+                if (count == 2)
+                    break;
+            }
+        }
+        return best_lane;
+    }
+
+    static uint32_t getCell(const state_type & state, int lane) {
+        alignas(16) uint8_t lanes[16];
+        state.vectors[lane / 16].saveAligned((void *)&lanes[0]);
+        return (uint32_t)lanes[lane % 16];
+    }
+
+    static void setCell(state_type & state, int lane, uint32_t candidates) {
+        alignas(16) uint8_t lanes[16];
+        state.vectors[lane / 16].saveAligned((void *)&lanes[0]);
+        lanes[lane % 16] = (uint8_t)candidates;
+        state.vectors[lane / 16].loadAligned((const void *)&lanes[0]);
+    }
+
+    void search(state_type & state) {
+        if (!update(state))
+            return;
+        if (isSolved(state)) {
+            this->num_solutions_++;
+            if (kSolutionMode == 1 && this->num_solutions_ == this->limit_solutions_) {
+                extractSolution(state, this->solution_);
+            }
+            return;
+        }
+
+        int lane = chooseCell(state);
+        assert(lane >= 0);
+        uint32_t candidates = getCell(state, lane);
+        assert(BitUtils::popcnt32(candidates) > 1);
+
+        while (candidates != 0) {
+            uint32_t digit_bit = candidates & (0u - candidates);
+            candidates ^= digit_bit;
+            if (candidates != 0) {
+                // Try the digit on a snapshot, keep the state for the other candidates.
+                this->num_guesses_++;
+                state_type & next_state = this->nextSnapshot(state);
+                next_state.copy(state);
+                setCell(next_state, lane, digit_bit);
+                search(next_state);
+                if (this->num_solutions_ == this->limit_solutions_) return;
+            } else {
+                // The last candidate: no snapshot needed.
+                setCell(state, lane, digit_bit);
+                search(state);
+            }
+        }
+    }
+
+    static void extractSolution(const state_type & state, char * solution) {
+        alignas(16) uint8_t lanes[kLanes];
+        for (size_t i = 0; i < kVectors; i++) {
+            state.vectors[i].saveAligned((void *)&lanes[i * 16]);
+        }
+        for (size_t row = 0; row < kRows; row++) {
+            for (size_t col = 0; col < kCols; col++) {
+                uint32_t cell = (uint32_t)lanes[row * kRowLanes + col];
+                solution[row * kCols + col] = (char)('1' + BitUtils::bsf32(cell));
+            }
+        }
+    }
+
+public:
+    // Set up the root state from the clues, the conflicts are found by the first update().
+    static void initSudoku(const char * puzzle, state_type & state) {
+        alignas(16) uint8_t lanes[kLanes];
+        std::memset(&lanes[0], 0, sizeof(lanes));
+        for (size_t row = 0; row < kRows; row++) {
+            for (size_t col = 0; col < kCols; col++) {
+                char ch = puzzle[row * kCols + col];
+                lanes[row * kRowLanes + col] = (ch >= '1' && ch < (char)('1' + kNumbers)) ?
+                                               (uint8_t)(1u << (ch - '1')) :
+                                               (uint8_t)geometry::kAllNumbers;
+            }
+        }
+        for (size_t i = 0; i < kVectors; i++) {
+            state.vectors[i].loadAligned((const void *)&lanes[i * 16]);
+        }
+    }
+
+    void resetStatistics(size_t limit) {
+        this->set_num_guesses(0);
+        this->set_num_solutions(0);
+        this->set_limit_solutions(limit);
+    }
+
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        this->resetStatistics(limit);
+        this->solution_ = solution;
+
+        state_type & state = this->states_[0];
+        initSudoku(puzzle, state);
+        search(state);
+        return this->num_solutions_;
+    }
+};
+
+template <int kSolutionMode>
+using Mini4x4Solver = MiniSudokuSolver<kSolutionMode, Sudoku4x4>;
+
+template <int kSolutionMode>
+using Mini6x6Solver = MiniSudokuSolver<kSolutionMode, Sudoku6x6>;
+
+} // namespace
+
+#endif // GUDOKU_MINI_SUDOKU_SOLVER_H
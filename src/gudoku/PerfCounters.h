@@ -0,0 +1,220 @@
+
+#ifndef JSTD_TEST_PERF_COUNTERS_H
+#define JSTD_TEST_PERF_COUNTERS_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <unistd.h>             // For syscall(), read(), close()
+#include <sys/ioctl.h>          // For ioctl()
+#include <sys/syscall.h>        // For __NR_perf_event_open
+#include <linux/perf_event.h>   // For struct perf_event_attr
+#if defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>              // For __get_cpuid()
+#endif
+#endif // __linux__
+
+//
+// Hardware performance counters around a block of code, through perf_event_open(2).
+//
+//   test::PerfCounters counters;
+//   if (counters.open()) {
+//       counters.start();
+//       ... // the solve loop
+//       counters.stop();
+//       counters.value(test::PerfCounters::Cycles);
+//   }
+//
+// Every event is opened on its own (not as a group), user space only, on the calling
+// thread. If the PMU has fewer counters than events, the kernel multiplexes them and the
+// values are scaled by time_enabled / time_running.
+//
+// An event the kernel refuses (no PMU in a VM, perf_event_paranoid > 2, an unknown raw
+// event...) is reported as unavailable, the others still count. On other platforms than
+// Linux nothing is available.
+//
+
+namespace test {
+
+class PerfCounters {
+public:
+    enum Event {
+        Cycles,
+        Instructions,
+        Branches,
+        BranchMisses,
+        L1DMisses,          // L1D read misses
+        Uops,               // Issued (Intel) or retired (AMD) uops, a raw event
+        MaxEvent
+    };
+
+private:
+    int         fds_[MaxEvent];
+    uint64_t    values_[MaxEvent];
+    bool        scaled_[MaxEvent];
+
+public:
+    PerfCounters() {
+        for (int i = 0; i < MaxEvent; i++) {
+            this->fds_[i] = -1;
+            this->values_[i] = 0;
+            this->scaled_[i] = false;
+        }
+    }
+
+    ~PerfCounters() {
+        this->close();
+    }
+
+    PerfCounters(const PerfCounters & src) = delete;
+    PerfCounters & operator = (const PerfCounters & rhs) = delete;
+
+    static const char * name(int event) {
+        static const char * names[MaxEvent] = {
+            "cycles", "instructions", "branches", "branch-misses", "L1D-read-misses", "uops"
+        };
+        return ((event >= 0 && event < MaxEvent) ? names[event] : "unknown");
+    }
+
+    bool available(int event) const {
+        return (this->fds_[event] >= 0);
+    }
+
+    // True if at least one event could be opened.
+    bool any_available() const {
+        for (int i = 0; i < MaxEvent; i++) {
+            if (this->fds_[i] >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    // The value of the last start() / stop(), 0 if the event is unavailable.
+    uint64_t value(int event) const {
+        return this->values_[event];
+    }
+
+    // The kernel had to multiplex the event, the value is an estimate.
+    bool scaled(int event) const {
+        return this->scaled_[event];
+    }
+
+#if defined(__linux__)
+
+    bool open() {
+        this->close();
+        this->fds_[Cycles]       = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        this->fds_[Instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        this->fds_[Branches]     = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+        this->fds_[BranchMisses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        this->fds_[L1DMisses]    = open_event(PERF_TYPE_HW_CACHE,
+                                              PERF_COUNT_HW_CACHE_L1D |
+                                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        uint64_t uops_event = raw_uops_event();
+        if (uops_event != 0)
+            this->fds_[Uops] = open_event(PERF_TYPE_RAW, uops_event);
+        return this->any_available();
+    }
+
+    void close() {
+        for (int i = 0; i < MaxEvent; i++) {
+            if (this->fds_[i] >= 0) {
+                ::close(this->fds_[i]);
+                this->fds_[i] = -1;
+            }
+        }
+    }
+
+    void start() {
+        for (int i = 0; i < MaxEvent; i++) {
+            if (this->fds_[i] >= 0) {
+                ::ioctl(this->fds_[i], PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(this->fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void stop() {
+        for (int i = 0; i < MaxEvent; i++) {
+            if (this->fds_[i] >= 0) {
+                ::ioctl(this->fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (int i = 0; i < MaxEvent; i++) {
+            this->values_[i] = 0;
+            this->scaled_[i] = false;
+            if (this->fds_[i] >= 0) {
+                // PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+                uint64_t data[3] = { 0, 0, 0 };
+                if (::read(this->fds_[i], data, sizeof(data)) == (ssize_t)sizeof(data)) {
+                    if (data[2] != 0 && data[2] < data[1]) {
+                        this->values_[i] = (uint64_t)((double)data[0] * data[1] / data[2]);
+                        this->scaled_[i] = true;
+                    }
+                    else {
+                        this->values_[i] = data[0];
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static int open_event(uint32_t type, uint64_t config) {
+        struct perf_event_attr attr;
+        ::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // pid = 0, cpu = -1: this thread, on any CPU.
+        long fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        return (int)fd;
+    }
+
+    //
+    // There is no generic uops event, so use the raw one of the CPU vendor:
+    // UOPS_ISSUED.ANY (event 0x0E, umask 0x01) on Intel, and "retired uops"
+    // (PMCx0C1) on AMD.
+    //
+    static uint64_t raw_uops_event() {
+#if defined(__i386__) || defined(__x86_64__)
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) != 0) {
+            char vendor[13];
+            ::memcpy(&vendor[0], &ebx, 4);
+            ::memcpy(&vendor[4], &edx, 4);
+            ::memcpy(&vendor[8], &ecx, 4);
+            vendor[12] = '\0';
+            if (::strcmp(vendor, "GenuineIntel") == 0)
+                return 0x010E;
+            if (::strcmp(vendor, "AuthenticAMD") == 0 || ::strcmp(vendor, "HygonGenuine") == 0)
+                return 0x00C1;
+        }
+#endif
+        return 0;
+    }
+
+#else // !__linux__
+
+    bool open() { return false; }
+    void close() {}
+    void start() {}
+    void stop() {}
+
+#endif // __linux__
+};
+
+} // namespace test
+
+#endif // JSTD_TEST_PERF_COUNTERS_H
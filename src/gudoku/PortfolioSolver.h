@@ -0,0 +1,251 @@
+
+#ifndef GUDOKU_PORTFOLIO_SOLVER_H
+#define GUDOKU_PORTFOLIO_SOLVER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memcpy()
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// A portfolio of DpllTriadSimdSolver configurations racing on one puzzle.
+//
+// Some puzzles take 100x the median number of guesses because the first branches are
+// unlucky. The plain search runs alone first, with a budget of kSoloGuesses guesses (about
+// the 90th percentile of the hardest puzzles), so most puzzles never touch another thread.
+// Past the budget, kWorkers configurations run concurrently, the plain search on the
+// calling thread and the others on helper threads that wait for work between puzzles:
+//
+//   worker 0:  the plain deterministic search,
+//   worker 1:  random tie-breaking and configuration order, Luby restarts of 16 guesses,
+//   worker 2:  the same with another seed and Luby restarts of 64 guesses,
+//   worker 3:  failed-literal probing, random order and Luby restarts of 16 guesses.
+//
+// The first worker to finish wins and sets the cancel flag, which the others poll every
+// few guesses. Restarts only make sense for the first solution (limit == 1); counting more
+// solutions needs the whole search tree, so then the workers only differ in their order.
+//
+
+using namespace gudoku;
+
+namespace {
+
+template <int kSolutionMode>
+class PortfolioSolver : public BasicSolver {
+public:
+    typedef BasicSolver                         basic_solver;
+    typedef PortfolioSolver                     this_type;
+    typedef DpllTriadSimdSolver<kSolutionMode>  dpll_solver_t;
+
+    static const size_t kWorkers = 4;
+    static const size_t kSoloGuesses = 64;
+
+private:
+    struct Result {
+        size_t  num_solutions;
+        size_t  num_guesses;
+        char    solution[Sudoku::BoardSize];
+    };
+
+    dpll_solver_t           solvers_[kWorkers];
+    Result                  results_[kWorkers];
+    std::thread             helpers_[kWorkers - 1];
+
+    std::mutex              mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    size_t                  generation_;
+    size_t                  running_;
+    bool                    stop_;
+
+    // The puzzle of the current race.
+    const char *            puzzle_;
+    size_t                  limit_;
+
+    std::atomic<bool>       cancel_;
+    std::atomic<int>        winner_;
+
+    size_t                  num_races_;
+    size_t                  num_wins_[kWorkers];
+
+    static size_t restartUnit(size_t worker) {
+        static const size_t kRestartUnits[kWorkers] = { 0, 16, 64, 16 };
+        return kRestartUnits[worker];
+    }
+
+public:
+    PortfolioSolver()
+        : basic_solver(), generation_(0), running_(0), stop_(false),
+          puzzle_(nullptr), limit_(1), cancel_(false), winner_(-1), num_races_(0) {
+        for (size_t i = 0; i < kWorkers; i++) {
+            this->num_wins_[i] = 0;
+        }
+        this->solvers_[1].set_random_seed(0x9E3779B97F4A7C15ULL);
+        this->solvers_[2].set_random_seed(0xD1B54A32D192ED03ULL);
+        this->solvers_[3].set_random_seed(0x8CB92BA72F3D8DD7ULL);
+        this->solvers_[3].set_probing(true);
+        for (size_t i = 1; i < kWorkers; i++) {
+            this->helpers_[i - 1] = std::thread(&this_type::helperLoop, this, i);
+        }
+    }
+
+    ~PortfolioSolver() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->stop_ = true;
+        }
+        this->start_cv_.notify_all();
+        for (size_t i = 0; i < kWorkers - 1; i++) {
+            if (this->helpers_[i].joinable())
+                this->helpers_[i].join();
+        }
+    }
+
+    // The puzzles that went past the solo budget, and the races each worker has won.
+    size_t get_num_races() const {
+        return this->num_races_;
+    }
+    size_t get_num_wins(size_t worker) const {
+        return this->num_wins_[worker];
+    }
+
+private:
+    // 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ... for run = 0, 1, 2, ...
+    static size_t luby(size_t run) {
+        size_t size = 1, power = 0;
+        while (size < run + 1) {
+            power++;
+            size = 2 * size + 1;
+        }
+        while (size - 1 != run) {
+            size = (size - 1) >> 1;
+            power--;
+            run = run % size;
+        }
+        return (size_t(1) << power);
+    }
+
+    void runWorker(size_t worker) {
+        dpll_solver_t & solver = this->solvers_[worker];
+        Result & result = this->results_[worker];
+        bool restarts = (restartUnit(worker) != 0 && this->limit_ == 1);
+
+        size_t num_solutions = 0, num_guesses = 0;
+        bool finished = false;
+        solver.set_cancel_flag(&this->cancel_);
+        for (size_t run = 0; ; run++) {
+            solver.set_guess_budget(restarts ? (luby(run) * restartUnit(worker)) : SIZE_MAX);
+            num_solutions = solver.solve(this->puzzle_, result.solution, this->limit_);
+            num_guesses += solver.get_num_guesses();
+            if (!solver.aborted() || num_solutions == this->limit_) {
+                finished = true;
+                break;
+            }
+            if (!restarts || this->cancel_.load(std::memory_order_relaxed))
+                break;
+        }
+
+        if (finished) {
+            int expected = -1;
+            if (this->winner_.compare_exchange_strong(expected, (int)worker)) {
+                result.num_solutions = num_solutions;
+                result.num_guesses = num_guesses;
+                this->cancel_.store(true);
+            }
+        }
+    }
+
+    void helperLoop(size_t worker) {
+        size_t generation = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(this->mutex_);
+                this->start_cv_.wait(lock, [&]() {
+                    return (this->stop_ || this->generation_ != generation);
+                });
+                if (this->stop_) return;
+                generation = this->generation_;
+            }
+            this->runWorker(worker);
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                if (--this->running_ == 0)
+                    this->done_cv_.notify_one();
+            }
+        }
+    }
+
+public:
+    size_t solve(const char * puzzle, char * solution, size_t limit) {
+        this->set_limit_solutions(limit);
+
+        // Most puzzles: the plain search alone, within the budget.
+        dpll_solver_t & solo = this->solvers_[0];
+        solo.set_cancel_flag(nullptr);
+        solo.set_guess_budget(kSoloGuesses);
+        size_t num_solutions = solo.solve(puzzle, solution, limit);
+        size_t solo_guesses = solo.get_num_guesses();
+        if (!solo.aborted() || num_solutions == limit) {
+            this->num_solutions_ = num_solutions;
+            this->num_guesses_ = solo_guesses;
+            return num_solutions;
+        }
+
+        // The race.
+        this->cancel_.store(false);
+        this->winner_.store(-1);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->puzzle_ = puzzle;
+            this->limit_ = limit;
+            this->running_ = kWorkers - 1;
+            this->generation_++;
+        }
+        this->start_cv_.notify_all();
+
+        this->runWorker(0);
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->done_cv_.wait(lock, [&]() { return (this->running_ == 0); });
+        }
+
+        // The plain search only stops when another worker has won.
+        int winner = this->winner_.load();
+        assert(winner >= 0);
+        const Result & result = this->results_[winner];
+        if (kSolutionMode == 1)
+            std::memcpy(solution, result.solution, Sudoku::BoardSize);
+        this->num_races_++;
+        this->num_wins_[winner]++;
+        this->num_solutions_ = result.num_solutions;
+        this->num_guesses_ = solo_guesses + result.num_guesses;
+        return result.num_solutions;
+    }
+
+    void display_result(Board & board, double elapsed_time,
+                        bool print_answer = true,
+                        bool print_all_answers = true) {
+        basic_solver::display_result<SearchMode::OneSolution>(board, elapsed_time,
+                                                              print_answer, print_all_answers);
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_PORTFOLIO_SOLVER_H
@@ -0,0 +1,527 @@
+
+#ifndef GUDOKU_SOLUTION_COUNTER_H
+#define GUDOKU_SOLUTION_COUNTER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memcpy()
+#include <vector>
+#include <algorithm>    // For std::sort(), std::unique(), std::lower_bound()
+
+#include "gudoku/BitUtils.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+
+//
+// Exact solution counts of grids with few clues, from the band configurations of the State.
+//
+// A solution is one configuration per value in each of the 6 bands: the rows of the value
+// in the 3 boxes of its horizontal band, and its columns in the 3 boxes of its vertical band.
+// The 9 configurations of a band (a band pattern) must put 3 values in each row of each box,
+// which leaves 94080 patterns of an empty band. In a box, the pattern of the horizontal band
+// splits the 9 values into 3 rows and the pattern of the vertical band into 3 columns, and
+// the box is filled exactly when every row meets every column in one value. So
+//
+//     count = sum over the patterns x0, x1, x2 of the horizontal bands of
+//             F0(x0|0, x1|0, x2|0) * F1(x0|1, x1|1, x2|1) * F2(x0|2, x1|2, x2|2)
+//
+// where x|s are the rows of the pattern x in the box of stack s and Fs(p0, p1, p2) is the
+// number of patterns of the vertical band s whose columns meet the rows p0, p1, p2 in its
+// 3 boxes. The order of the rows doesn't matter to Fs, so the patterns are canonicalized to
+// their unordered partitions (with the number of patterns as a weight), and Fs is memoized
+// per band pair: one row over the partitions of the third band for every pair of partitions
+// of the first two. The clues are in the band configurations left by initSudoku(), so the
+// patterns of a band shrink about 3 times per clue and the triple sum with them.
+//
+// The counts go up to the 6.67e21 solutions of the empty grid, so they take 128 bits. A 12
+// clue grid takes about a second, where the search would enumerate 1e10 solutions or more,
+// and every clue less about 3 times longer; the values that no clue gives are swapped out
+// first (see count()), which takes the empty grid down to the 9 clues of one row.
+//
+
+using namespace gudoku;
+
+namespace {
+
+//
+// A 128 bit unsigned count.
+//
+struct UInt128 {
+    uint64_t low;
+    uint64_t high;
+
+    UInt128() noexcept : low(0), high(0) {}
+    UInt128(uint64_t value) noexcept : low(value), high(0) {}
+    UInt128(uint64_t _low, uint64_t _high) noexcept : low(_low), high(_high) {}
+
+    // The full product of two 64 bit values.
+    static UInt128 mul(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = (unsigned __int128)a * b;
+        return UInt128((uint64_t)product, (uint64_t)(product >> 64));
+#else
+        uint64_t lo_lo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+        uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFULL);
+        uint64_t lo_hi = (a & 0xFFFFFFFFULL) * (b >> 32);
+        uint64_t hi_hi = (a >> 32) * (b >> 32);
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+        return UInt128((cross << 32) | (lo_lo & 0xFFFFFFFFULL), hi_hi + (hi_lo >> 32) + (cross >> 32));
+#endif
+    }
+
+    UInt128 & operator += (const UInt128 & rhs) {
+        uint64_t low = this->low + rhs.low;
+        this->high += rhs.high + (uint64_t)(low < this->low);
+        this->low = low;
+        return *this;
+    }
+
+    // The low 128 bits of the product.
+    UInt128 operator * (uint64_t rhs) const {
+        UInt128 product = mul(this->low, rhs);
+        product.high += this->high * rhs;
+        return product;
+    }
+
+    bool operator == (const UInt128 & rhs) const {
+        return (this->low == rhs.low && this->high == rhs.high);
+    }
+    bool operator != (const UInt128 & rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+class SolutionCounter : public DpllTriadSimdSolver<0> {
+public:
+    typedef DpllTriadSimdSolver<0>  dpll_solver_t;
+    typedef SolutionCounter         this_type;
+
+private:
+    // The box peers of a band: configuration c puts a value at elem kConfigElems[c][peer] of
+    // the peer, the rows of a horizontal band and the columns of a vertical band (see Band).
+    static const uint8_t kConfigElems[6][3];
+
+    //
+    // The partitions of the 9 values by the band pattern in its 3 boxes, each partition
+    // as 3 sorted 9-bit masks (27 bits), and the number of band patterns that have them.
+    // Once the partitions of a side are numbered, parts[] holds their indexes instead.
+    //
+    struct Pattern {
+        uint32_t parts[3];
+        uint32_t weight;
+
+        bool operator < (const Pattern & rhs) const {
+            if (this->parts[0] != rhs.parts[0]) return (this->parts[0] < rhs.parts[0]);
+            if (this->parts[1] != rhs.parts[1]) return (this->parts[1] < rhs.parts[1]);
+            return (this->parts[2] < rhs.parts[2]);
+        }
+    };
+
+    // The third band, grouped by its partition in stack 0.
+    struct Entry {
+        uint32_t part1;
+        uint32_t part2;
+        uint32_t weight;
+    };
+
+    struct Group {
+        uint32_t part0;
+        uint32_t first;
+        uint32_t last;
+    };
+
+    // The patterns of the 3 bands of each side (horizontal and vertical).
+    std::vector<Pattern>    patterns_[2][3];
+
+    // The sorted partitions of the outer side at band h, stack s.
+    std::vector<uint32_t>   parts_[3][3];
+    // Per stack and band h < 2: a bitset over the patterns of the vertical band for each
+    // partition, the patterns whose partition in band h meets it.
+    std::vector<uint64_t>   meets_[3][2];
+    size_t                  words_[3];
+    // Per stack: the partitions of the third band that each vertical pattern meets.
+    std::vector<uint32_t>   meets_third_[3];
+    std::vector<uint32_t>   meets_third_first_[3];
+
+    // The memoized Fs rows, per stack and pair of partitions of the first two bands.
+    std::vector<uint32_t>   row_index_[3];
+    std::vector<uint32_t>   rows_[3];
+
+    std::vector<Entry>      entries_;
+    std::vector<Group>      groups_;
+
+    size_t                  num_rows_;
+
+public:
+    SolutionCounter() : dpll_solver_t(), num_rows_(0) {}
+    ~SolutionCounter() {}
+
+    // The band pairs of the last count, one memoized row of Fs each.
+    size_t get_num_band_pairs() const {
+        return this->num_rows_;
+    }
+
+private:
+    static uint32_t canonicalPartition(uint32_t a, uint32_t b, uint32_t c) {
+        if (a > b) std::swap(a, b);
+        if (b > c) std::swap(b, c);
+        if (a > b) std::swap(a, b);
+        return (a | (b << 9) | (c << 18));
+    }
+
+    // Whether every row of one partition meets every column of the other.
+    static bool partitionsMeet(uint32_t rows, uint32_t cols) {
+        for (uint32_t i = 0; i < 27; i += 9) {
+            for (uint32_t j = 0; j < 27; j += 9) {
+                if ((((rows >> i) & (cols >> j)) & 0x1FFu) == 0)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    struct PatternWalk {
+        const uint8_t *         candidates;
+        uint8_t                 counts[3][3];
+        uint8_t                 configs[9];
+        std::vector<Pattern> *  patterns;
+    };
+
+    static void enumeratePatterns(PatternWalk & walk, size_t value) {
+        if (value == 9) {
+            Pattern pattern;
+            for (size_t peer = 0; peer < 3; peer++) {
+                uint32_t masks[3] = { 0, 0, 0 };
+                for (size_t v = 0; v < 9; v++) {
+                    masks[kConfigElems[walk.configs[v]][peer]] |= (1u << v);
+                }
+                pattern.parts[peer] = canonicalPartition(masks[0], masks[1], masks[2]);
+            }
+            pattern.weight = 1;
+            walk.patterns->push_back(pattern);
+            return;
+        }
+        for (uint8_t config = 0; config < 6; config++) {
+            if ((walk.candidates[value] & (1u << config)) == 0) continue;
+            const uint8_t * elems = kConfigElems[config];
+            if (walk.counts[0][elems[0]] == 3 || walk.counts[1][elems[1]] == 3 ||
+                walk.counts[2][elems[2]] == 3)
+                continue;
+            walk.counts[0][elems[0]]++;
+            walk.counts[1][elems[1]]++;
+            walk.counts[2][elems[2]]++;
+            walk.configs[value] = config;
+            enumeratePatterns(walk, value + 1);
+            walk.counts[0][elems[0]]--;
+            walk.counts[1][elems[1]]--;
+            walk.counts[2][elems[2]]--;
+        }
+    }
+
+    // The canonical patterns of a band with their weights, from its configurations.
+    static void bandPatterns(const Band & band, std::vector<Pattern> & patterns) {
+        alignas(16) uint16_t lanes[8];
+        BitVec08x16 configurations = band.configurations.and_not(band.eliminations);
+        configurations.saveAligned(&lanes[0]);
+        uint8_t candidates[9];
+        for (size_t value = 0; value < 9; value++) {
+            candidates[value] = 0;
+            for (size_t config = 0; config < 6; config++) {
+                candidates[value] |= (uint8_t)(((lanes[config] >> value) & 1u) << config);
+            }
+        }
+
+        PatternWalk walk;
+        walk.candidates = candidates;
+        for (size_t peer = 0; peer < 3; peer++) {
+            walk.counts[peer][0] = walk.counts[peer][1] = walk.counts[peer][2] = 0;
+        }
+        walk.patterns = &patterns;
+        patterns.clear();
+        enumeratePatterns(walk, 0);
+
+        // Merge the patterns with the same partitions.
+        std::sort(patterns.begin(), patterns.end());
+        size_t n = 0;
+        for (size_t i = 0; i < patterns.size(); i++) {
+            if (n > 0 && !(patterns[n - 1] < patterns[i]))
+                patterns[n - 1].weight++;
+            else
+                patterns[n++] = patterns[i];
+        }
+        patterns.resize(n);
+    }
+
+    // The Fs row of the pair of partitions (part0, part1) of the first two bands.
+    const uint32_t * bandPairRow(size_t stack, uint32_t part0, uint32_t part1,
+                                 const std::vector<Pattern> & vertical) {
+        size_t num_part1 = this->parts_[1][stack].size();
+        uint32_t & index = this->row_index_[stack][part0 * num_part1 + part1];
+        if (index != UINT32_MAX)
+            return &this->rows_[stack][index];
+
+        size_t num_third = this->parts_[2][stack].size();
+        index = (uint32_t)this->rows_[stack].size();
+        this->rows_[stack].resize(index + num_third, 0);
+        uint32_t * row = &this->rows_[stack][index];
+
+        size_t words = this->words_[stack];
+        const uint64_t * meets0 = &this->meets_[stack][0][part0 * words];
+        const uint64_t * meets1 = &this->meets_[stack][1][part1 * words];
+        const std::vector<uint32_t> & meets_third = this->meets_third_[stack];
+        const std::vector<uint32_t> & meets_third_first = this->meets_third_first_[stack];
+        for (size_t i = 0; i < words; i++) {
+            uint64_t bits = meets0[i] & meets1[i];
+            while (bits != 0) {
+                size_t y = i * 64 + BitUtils::bsf64(bits);
+                uint32_t weight = vertical[y].weight;
+                for (uint32_t k = meets_third_first[y]; k < meets_third_first[y + 1]; k++) {
+                    row[meets_third[k]] += weight;
+                }
+                bits = BitUtils::clearLowBit64(bits);
+            }
+        }
+        this->num_rows_++;
+        return row;
+    }
+
+    // The solutions of the grid (81 chars, '1'-'9' for givens and '.' for empties).
+    UInt128 countPatterns(const char * grid) {
+        State & state = this->states_[0];
+        if (!this->initSudoku(grid, state))
+            return UInt128(0);
+
+        double sizes[2] = { 1.0, 1.0 };
+        for (size_t vertical = 0; vertical < 2; vertical++) {
+            for (size_t band = 0; band < 3; band++) {
+                bandPatterns(state.bands[vertical][band], this->patterns_[vertical][band]);
+                sizes[vertical] *= (double)this->patterns_[vertical][band].size();
+            }
+        }
+        if (sizes[0] == 0.0 || sizes[1] == 0.0)
+            return UInt128(0);
+
+        // The triple sum over the side with fewer pattern triples, and the band with the
+        // most patterns innermost. The other side is the vertical one below.
+        size_t outer_side = (sizes[1] < sizes[0]) ? 1 : 0;
+        std::vector<Pattern> * outer[3];
+        std::vector<Pattern> * vertical = this->patterns_[outer_side ^ 1];
+        size_t bands[3] = { 0, 1, 2 };
+        for (size_t band = 0; band < 2; band++) {
+            if (this->patterns_[outer_side][bands[band]].size() >
+                this->patterns_[outer_side][bands[2]].size())
+                std::swap(bands[band], bands[2]);
+        }
+        for (size_t h = 0; h < 3; h++) {
+            outer[h] = &this->patterns_[outer_side][bands[h]];
+        }
+
+        // Number the partitions of every band and stack of the outer side.
+        for (size_t h = 0; h < 3; h++) {
+            for (size_t s = 0; s < 3; s++) {
+                std::vector<uint32_t> & parts = this->parts_[h][s];
+                parts.clear();
+                for (const Pattern & pattern : *outer[h]) {
+                    parts.push_back(pattern.parts[s]);
+                }
+                std::sort(parts.begin(), parts.end());
+                parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+            }
+        }
+
+        for (size_t s = 0; s < 3; s++) {
+            const std::vector<Pattern> & stack = vertical[s];
+            size_t words = (stack.size() + 63) / 64;
+            this->words_[s] = words;
+            for (size_t h = 0; h < 2; h++) {
+                const std::vector<uint32_t> & parts = this->parts_[h][s];
+                std::vector<uint64_t> & meets = this->meets_[s][h];
+                meets.assign(parts.size() * words, 0);
+                for (size_t k = 0; k < parts.size(); k++) {
+                    for (size_t y = 0; y < stack.size(); y++) {
+                        if (partitionsMeet(parts[k], stack[y].parts[bands[h]]))
+                            meets[k * words + y / 64] |= (uint64_t(1) << (y % 64));
+                    }
+                }
+            }
+            const std::vector<uint32_t> & third = this->parts_[2][s];
+            std::vector<uint32_t> & meets_third = this->meets_third_[s];
+            std::vector<uint32_t> & meets_third_first = this->meets_third_first_[s];
+            meets_third.clear();
+            meets_third_first.clear();
+            for (size_t y = 0; y < stack.size(); y++) {
+                meets_third_first.push_back((uint32_t)meets_third.size());
+                for (size_t k = 0; k < third.size(); k++) {
+                    if (partitionsMeet(third[k], stack[y].parts[bands[2]]))
+                        meets_third.push_back((uint32_t)k);
+                }
+            }
+            meets_third_first.push_back((uint32_t)meets_third.size());
+
+            this->row_index_[s].assign(this->parts_[0][s].size() * this->parts_[1][s].size(), UINT32_MAX);
+            this->rows_[s].clear();
+        }
+
+        for (size_t h = 0; h < 3; h++) {
+            for (Pattern & pattern : *outer[h]) {
+                for (size_t s = 0; s < 3; s++) {
+                    const std::vector<uint32_t> & parts = this->parts_[h][s];
+                    pattern.parts[s] = (uint32_t)(std::lower_bound(parts.begin(), parts.end(),
+                                                                   pattern.parts[s]) - parts.begin());
+                }
+            }
+        }
+
+        // The third band grouped by its partition in stack 0, to skip the groups with Fs = 0.
+        std::vector<Pattern> & third = *outer[2];
+        std::sort(third.begin(), third.end());
+        this->entries_.clear();
+        this->groups_.clear();
+        for (const Pattern & pattern : third) {
+            if (this->groups_.empty() || this->groups_.back().part0 != pattern.parts[0]) {
+                Group group = { pattern.parts[0], (uint32_t)this->entries_.size(), 0 };
+                this->groups_.push_back(group);
+            }
+            Entry entry = { pattern.parts[1], pattern.parts[2], pattern.weight };
+            this->entries_.push_back(entry);
+            this->groups_.back().last = (uint32_t)this->entries_.size();
+        }
+
+        //
+        // Every term of the sums counts solutions, so all the partial sums stay below the
+        // total. A group sum counts the patterns of the third band and of two vertical bands,
+        // below 94080^3 < 2^50.
+        //
+        UInt128 total;
+        for (const Pattern & x0 : *outer[0]) {
+            for (const Pattern & x1 : *outer[1]) {
+                const uint32_t * row0 = this->bandPairRow(0, x0.parts[0], x1.parts[0], vertical[0]);
+                const uint32_t * row1 = this->bandPairRow(1, x0.parts[1], x1.parts[1], vertical[1]);
+                const uint32_t * row2 = this->bandPairRow(2, x0.parts[2], x1.parts[2], vertical[2]);
+
+                UInt128 pair_total;
+                for (const Group & group : this->groups_) {
+                    uint32_t f0 = row0[group.part0];
+                    if (f0 == 0) continue;
+                    uint64_t sum = 0;
+                    for (uint32_t i = group.first; i < group.last; i++) {
+                        const Entry & entry = this->entries_[i];
+                        sum += (uint64_t)entry.weight * row1[entry.part1] * row2[entry.part2];
+                    }
+                    pair_total += UInt128::mul(f0, sum);
+                }
+                total += pair_total * ((uint64_t)x0.weight * x1.weight);
+            }
+        }
+        return total;
+    }
+
+    // The cells of unit 0 - 26: the rows, the columns and the boxes.
+    static size_t unitCell(size_t unit, size_t k) {
+        if (unit < 9)
+            return (unit * 9 + k);
+        else if (unit < 18)
+            return (k * 9 + (unit - 9));
+        else
+            return (((unit - 18) / 3 * 3 + k / 3) * 9 + (unit - 18) % 3 * 3 + k % 3);
+    }
+
+    static uint64_t binomial(size_t n, size_t k) {
+        if (k > n) return 0;
+        uint64_t result = 1;
+        for (size_t i = 1; i <= k; i++) {
+            result = result * (n - k + i) / i;
+        }
+        return result;
+    }
+
+public:
+    //
+    // The exact number of solutions of the puzzle (81 chars, '1'-'9' for givens and anything
+    // else for empties), up to the 6670903752021072936960 of the empty grid.
+    //
+    // The d values that no clue gives can be swapped in any solution for another solution,
+    // so the solutions come in classes of d!, and exactly one solution of a class has them in
+    // increasing order along a unit. When a unit has fewer than d! ways to place them, the
+    // count is d! times the sum of the counts with every placement as clues, which are far
+    // faster: the empty grid is 9! times the grids with the first row 123456789.
+    //
+    UInt128 count(const char * puzzle) {
+        this->num_rows_ = 0;
+
+        char grid[Sudoku::BoardSize];
+        uint32_t given = 0;
+        for (size_t pos = 0; pos < Sudoku::BoardSize; pos++) {
+            char digit = puzzle[pos];
+            if (digit >= '1' && digit <= '9') {
+                grid[pos] = digit;
+                given |= (1u << (uint32_t)(digit - '1'));
+            }
+            else {
+                grid[pos] = '.';
+            }
+        }
+
+        size_t num_free = 9 - BitUtils::popcnt32(given);
+        uint64_t classes = 1;
+        for (size_t i = 2; i <= num_free; i++) {
+            classes *= i;
+        }
+
+        size_t best_unit = SIZE_MAX;
+        uint64_t best_placements = classes;
+        for (size_t unit = 0; unit < 27; unit++) {
+            size_t num_empties = 0;
+            for (size_t k = 0; k < 9; k++) {
+                num_empties += (grid[unitCell(unit, k)] == '.');
+            }
+            uint64_t placements = binomial(num_empties, num_free);
+            if (placements < best_placements) {
+                best_placements = placements;
+                best_unit = unit;
+            }
+        }
+        if (best_unit == SIZE_MAX)
+            return this->countPatterns(grid);
+
+        // Every num_free subset of the empty cells of the unit, the free values in order.
+        size_t empties[9];
+        size_t num_empties = 0;
+        for (size_t k = 0; k < 9; k++) {
+            size_t pos = unitCell(best_unit, k);
+            if (grid[pos] == '.')
+                empties[num_empties++] = pos;
+        }
+        UInt128 total;
+        for (uint32_t subset = 0; subset < (1u << num_empties); subset++) {
+            if (BitUtils::popcnt32(subset) != num_free) continue;
+            char placed[Sudoku::BoardSize];
+            std::memcpy(placed, grid, Sudoku::BoardSize);
+            uint32_t values = (~given) & 0x1FFu;
+            for (size_t i = 0; i < num_empties; i++) {
+                if ((subset & (1u << i)) == 0) continue;
+                uint32_t value = BitUtils::bsf32(values);
+                placed[empties[i]] = (char)('1' + value);
+                values = BitUtils::clearLowBit32(values);
+            }
+            total += this->countPatterns(placed);
+        }
+        return (total * classes);
+    }
+};
+
+const uint8_t SolutionCounter::kConfigElems[6][3] = {
+    { 0, 1, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 }, { 0, 2, 1 }, { 1, 0, 2 }
+};
+
+} // namespace
+
+#endif // GUDOKU_SOLUTION_COUNTER_H
@@ -0,0 +1,127 @@
+
+#ifndef GUDOKU_STATIC_DATA_H
+#define GUDOKU_STATIC_DATA_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <cstdint>
+#include <cstddef>
+
+//
+// Helpers for building lookup tables at compile time under C++11.
+//
+// A table is an aggregate of plain arrays filled by a constexpr function that expands
+// an index pack, e.g.:
+//
+//     template <size_t... I>
+//     constexpr Table makeTable(IndexSequence<I...>) {
+//         return Table { { valueOf(I)... } };
+//     }
+//     constexpr Table table = makeTable(MakeIndexSequence<N>::type());
+//
+// so the table is constant-initialized: it lands in .rodata, there is no static-init
+// constructor to run, and the pages are shared through the page cache by every process
+// using the binary or the library.
+//
+
+namespace gudoku {
+
+template <size_t... Indexes>
+struct IndexSequence {
+    static const size_t size = sizeof...(Indexes);
+};
+
+template <typename Seq1, typename Seq2>
+struct ConcatIndexSequence;
+
+template <size_t... Indexes1, size_t... Indexes2>
+struct ConcatIndexSequence<IndexSequence<Indexes1...>, IndexSequence<Indexes2...>> {
+    typedef IndexSequence<Indexes1..., (sizeof...(Indexes1) + Indexes2)...> type;
+};
+
+// Logarithmic depth, so a few thousand entries stay far below the template depth limit.
+template <size_t N>
+struct MakeIndexSequence {
+    typedef typename ConcatIndexSequence<typename MakeIndexSequence<N / 2>::type,
+                                         typename MakeIndexSequence<N - N / 2>::type>::type type;
+};
+
+template <>
+struct MakeIndexSequence<0> {
+    typedef IndexSequence<> type;
+};
+
+template <>
+struct MakeIndexSequence<1> {
+    typedef IndexSequence<0> type;
+};
+
+//
+// The storage of a BitVec constant inside a constant-initialized table. The BitVec types
+// wrap __m128i / __m256i and have non-constexpr constructors, so the tables keep their
+// raw 16-bit lanes instead and hand out a BitVecT loaded from them. The load goes through
+// the aligned load intrinsics (which may alias anything), and it folds into a plain
+// aligned memory operand of the instruction that uses it.
+//
+template <typename BitVecT>
+struct alignas(sizeof(BitVecT)) ConstBitVec {
+    static const size_t kLanes = sizeof(BitVecT) / sizeof(uint16_t);
+
+    uint16_t u16[kLanes];
+
+    inline BitVecT get() const {
+        BitVecT value;
+        value.loadAligned((const void *)&this->u16[0]);
+        return value;
+    }
+
+    // non-explicit conversions intended
+    inline operator BitVecT () const {
+        return this->get();
+    }
+};
+
+//
+// Builders of the pshufb tables that load the characters of a grid into the box layout
+// (the cell lanes cy * 4 + cx of a BitVec16x16, one byte per lane in a BitVec08x16) and
+// turn them into digit bitmasks, shared by DpllTriadSimdSolver and SudokuVerifier.
+//
+
+// The source byte of the byte k (0 - 26) of a band from the part 0 (bytes 0 - 15 of the
+// band) or the part 1 (bytes 11 - 26), or 0x80 (a zero) if it is in the other part.
+constexpr uint16_t bandBoxesSource(size_t part, size_t k) {
+    return (part == 0) ? ((k < 16) ? (uint16_t)k : (uint16_t)0x80)
+                       : ((k >= 16) ? (uint16_t)(k - 11) : (uint16_t)0x80);
+}
+
+//
+// The source byte of the byte k of a box (cell lanes cy * 4 + cx) from the band part,
+// or 0x80 (a zero) for the triad lanes and the cells in the other part.
+//
+constexpr uint16_t bandBoxesByte(size_t part, size_t box, size_t k) {
+    return (((k / 4) < 3) && ((k % 4) < 3)) ?
+           bandBoxesSource(part, (k / 4) * 9 + box * 3 + (k % 4)) : (uint16_t)0x80;
+}
+
+constexpr uint16_t bandBoxesShuffle(size_t part, size_t box, size_t lane) {
+    return (uint16_t)(bandBoxesByte(part, box, lane * 2) | (bandBoxesByte(part, box, lane * 2 + 1) << 8));
+}
+
+// The byte half (0: low, 1: high) of the bitmask of a character with the low 4 bits k:
+// '1' - '9' to 1 << 0 - 1 << 8, the other low 4 bits to 0.
+constexpr uint16_t digitBitmaskByte(size_t half, size_t k) {
+    return ((k >= 1) && (k <= 9)) ? (uint16_t)(((1u << (k - 1)) >> (half * 8)) & 0xFFu) : (uint16_t)0;
+}
+
+constexpr uint16_t digitBitmaskBytes(size_t half, size_t lane) {
+    return (uint16_t)(digitBitmaskByte(half, lane * 2) | (digitBitmaskByte(half, lane * 2 + 1) << 8));
+}
+
+} // namespace gudoku
+
+#endif // GUDOKU_STATIC_DATA_H
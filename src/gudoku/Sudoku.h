@@ -62,26 +62,18 @@ struct SearchMode {
 
 #pragma pack(push, 1)
 
-struct Board {
-    char cells[81];
+template <size_t kCells>
+struct BasicBoard {
+    char cells[kCells];
 
     void clear() {
-#if 1
         //std::fill_n(this->cells, sizeof(this->cells), 0);
         std::memset(&this->cells[0], 0, sizeof(this->cells));
-#else
-        BitVec16x16 zeros;
-        zeros.setAllZeros();
-        zeros.saveAligned(&this->cells[0]);
-        zeros.saveAligned(&this->cells[32]);
-        BitVec08x16 zeros_16;
-        zeros_16.setAllZeros();
-        zeros_16.saveAligned(&this->cells[64]);
-        this->cells[81] = 0;
-#endif
     }
 };
 
+typedef BasicBoard<81> Board;
+
 struct alignas(32) Board96 {
     char cells[96];
 
@@ -463,12 +455,13 @@ struct ConstTables {
         { 8, 17, 26, 35, 44, 53, 60, 61, 62, 62, 69, 71, 72, 73, 74, 75, 76, 77, 78, 79 }   // 80
     };
 
-    ConstTables() noexcept {
+    constexpr ConstTables() noexcept {
         //
     }
 };
 
-static const ConstTables s_tables {};
+// Constant-initialized: no static-init constructor, and the data lands in .rodata.
+static constexpr ConstTables s_tables {};
 
 template <size_t Size, size_t Alignment>
 struct AlignedTo {
@@ -477,15 +470,21 @@ struct AlignedTo {
     static const size_t value = (size + alignment - 1) / alignment * alignment;
 };
 
-struct Sudoku {
+//
+// The grid geometry: boxes of kBoxCellsX columns x kBoxCellsY rows, so kBoxCellsY boxes
+// side by side in a band and kBoxCellsX bands, one digit per box cell. Sudoku is the
+// 9 x 9 grid, Sudoku4x4 and Sudoku6x6 the small ones (6 x 6 boxes are 3 wide, 2 tall).
+//
+template <size_t kBoxCellsX, size_t kBoxCellsY>
+struct BasicSudoku {
     static const size_t Alignment = sizeof(size_t);
 
-    static const size_t BoxCellsX = 3;
-    static const size_t BoxCellsY = 3;
-    static const size_t BoxCountX = 3;
-    static const size_t BoxCountY = 3;
+    static const size_t BoxCellsX = kBoxCellsX;
+    static const size_t BoxCellsY = kBoxCellsY;
+    static const size_t BoxCountX = kBoxCellsY;
+    static const size_t BoxCountY = kBoxCellsX;
     static const size_t MinNumber = 1;
-    static const size_t MaxNumber = 9;
+    static const size_t MaxNumber = kBoxCellsX * kBoxCellsY;
 
     static const size_t Cols = BoxCellsX * BoxCountX;
     static const size_t Rows = BoxCellsY * BoxCountY;
@@ -534,14 +533,15 @@ struct Sudoku {
 
     static const bool AllDimIsSame = ((Numbers == BoxSize) && (Rows == Cols) && (Numbers == Rows));
 
-    static const size_t MinInitCandidates = 17;
+    // The fewest clues of a puzzle with a unique solution.
+    static const size_t MinInitCandidates = (Numbers == 4) ? 4 : ((Numbers == 6) ? 8 : 17);
 
-    typedef Board board_type;
+    typedef BasicBoard<BoardSize> board_type;
 
     typedef SmallBitSet<BoardSize>              BitMask;
     typedef SmallBitSet2D<BoardSize, BoardSize> BitMaskTable;
 
-    static void clear_board(Board & board) {
+    static void clear_board(board_type & board) {
         size_t pos = 0;
         for (size_t row = 0; row < Rows; row++) {
             for (size_t col = 0; col < Cols; col++) {
@@ -550,7 +550,19 @@ struct Sudoku {
         }
     }
 
-    static void display_board(Board & board,
+    static void print_separator() {
+        printf(" ");
+        for (size_t countX = 0; countX < BoxCountX; countX++) {
+            printf(" ");
+            for (size_t cellX = 0; cellX < BoxCellsX; cellX++) {
+                printf("--");
+            }
+            printf("-");
+        }
+        printf("\n");
+    }
+
+    static void display_board(board_type & board,
                               bool is_input = false,
                               int idx = -1) {
         int filled = 0;
@@ -575,11 +587,7 @@ struct Sudoku {
         }
         printf("\n");
         // printf("  ------- ------- -------\n");
-        printf(" ");
-        for (size_t countX = 0; countX < BoxCountX; countX++) {
-            printf(" -------");
-        }
-        printf("\n");
+        print_separator();
         pos = 0;
         for (size_t row = 0; row < Rows; row++) {
             printf(" | ");
@@ -600,26 +608,71 @@ struct Sudoku {
             printf("\n");
             if ((row % BoxCellsY) == (BoxCellsY - 1)) {
                 // printf("  ------- ------- -------\n");
-                printf(" ");
-                for (size_t countX = 0; countX < BoxCountX; countX++) {
-                    printf(" -------");
-                }
-                printf("\n");
+                print_separator();
             }
         }
         printf("\n");
     }
 
-    static void display_board(std::vector<Board> & board_list) {
+    static void display_board(std::vector<board_type> & board_list) {
         printf("Total answers: %d\n\n", (int)board_list.size());
         int i = 0;
         for (auto answer : board_list) {
-            Sudoku::display_board(answer, false, i);
+            display_board(answer, false, i);
             i++;
         }
     }
 };
 
+typedef BasicSudoku<3, 3> Sudoku;
+typedef BasicSudoku<2, 2> Sudoku4x4;
+typedef BasicSudoku<3, 2> Sudoku6x6;
+
+#pragma pack(push, 1)
+
+//
+// The box of a cell, and the cell's place in the box. CellStride is the distance
+// between the rows of a box in the solver's layout (BoxCellsX when packed).
+//
+template <typename SudokuT, size_t CellStride = SudokuT::BoxCellsX>
+struct BasicBoxIndexing {
+    static const size_t BoxCellsX = SudokuT::BoxCellsX;
+    static const size_t BoxCellsY = SudokuT::BoxCellsY;
+    static const size_t BoxCountX = SudokuT::BoxCountX;
+    static const size_t BoxCountY = SudokuT::BoxCountY;
+    static const size_t MinNumber = SudokuT::MinNumber;
+    static const size_t MaxNumber = SudokuT::MaxNumber;
+
+    static const size_t Rows = SudokuT::Rows;
+    static const size_t Cols = SudokuT::Cols;
+    static const size_t Boxes = SudokuT::Boxes;
+    static const size_t BoxSize = SudokuT::BoxSize;
+    static const size_t Numbers = SudokuT::Numbers;
+
+    static const size_t BoardSize = SudokuT::BoardSize;
+    static const size_t TotalSize = SudokuT::TotalSize;
+
+    uint8_t box_x;
+    uint8_t box_y;
+    uint8_t box;
+    uint8_t cell_x;
+    uint8_t cell_y;
+    uint8_t cell;
+    uint8_t reserve1;
+    uint8_t reserve2;
+
+    BasicBoxIndexing() noexcept {}
+
+    explicit constexpr BasicBoxIndexing(uint32_t pos) noexcept
+        : box_x((uint8_t)((pos % Cols) / BoxCellsX)), box_y((uint8_t)(pos / (Cols * BoxCellsY))),
+          box((uint8_t)(box_y * BoxCountX + box_x)),
+          cell_x((uint8_t)(pos % BoxCellsX)), cell_y((uint8_t)((pos / Cols) % BoxCellsY)),
+          cell((uint8_t)(cell_y * CellStride + cell_x)),
+          reserve1((uint8_t)0), reserve2((uint8_t)0) {}
+};
+
+#pragma pack(pop)
+
 } // namespace gudoku
 
 #endif // GUDOKU_SUDOKU_H
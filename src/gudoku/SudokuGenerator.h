@@ -0,0 +1,622 @@
+
+#ifndef GUDOKU_SUDOKU_GENERATOR_H
+#define GUDOKU_SUDOKU_GENERATOR_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>       // For snprintf()
+#include <cstring>      // For std::memcpy()
+#include <random>       // For std::mt19937_64
+#include <algorithm>    // For std::shuffle()
+
+#include "gudoku/Sudoku.h"
+#include "gudoku/SudokuVariant.h"
+#include "gudoku/DpllTriadSimdSolver.h"
+#include "gudoku/HexadokuSimdSolver.h"
+#include "gudoku/MiniSudokuSolver.h"
+#include "gudoku/KillerSudokuSolver.h"
+
+//
+// Synthetic puzzles for the benchmarks, of one kind and a number of clues:
+//
+//   random          unique solution, clues removed at random down to the target count
+//   minimal         unique solution, no clue can be removed
+//   contradiction   zero solutions: a random puzzle plus a clue that breaks the solution,
+//                   without a duplicate in any unit
+//   duplicate       zero solutions: a random puzzle plus a clue that repeats a given of
+//                   one of its units
+//   multi           two or more solutions
+//   sparse          a near-empty grid, a few givens of a solution grid
+//
+// Every puzzle is cut from a random solution grid, and checked with the solution counter
+// of the grid's solver: DpllTriadSimdSolver for 9x9 (SudokuGenerator), HexadokuSimdSolver
+// for 16x16 (HexadokuGenerator), MiniSudokuSolver for 4x4 and 6x6 (Sudoku4x4Generator,
+// Sudoku6x6Generator).
+//
+
+using namespace gudoku;
+
+namespace {
+
+struct PuzzleKind {
+    enum {
+        Random,
+        Minimal,
+        Contradiction,
+        Duplicate,
+        MultiSolution,
+        Sparse,
+        Last
+    };
+
+    static const char * name(int kind) {
+        static const char * s_names[Last] = {
+            "random", "minimal", "contradiction", "duplicate", "multi", "sparse"
+        };
+        return ((kind >= 0 && kind < Last) ? s_names[kind] : "unknown");
+    }
+
+    static int find(const char * name, size_t length) {
+        for (int kind = 0; kind < Last; kind++) {
+            const char * kind_name = PuzzleKind::name(kind);
+            if (std::strlen(kind_name) == length && std::strncmp(kind_name, name, length) == 0)
+                return kind;
+        }
+        return -1;
+    }
+
+    // The clue range when none is given, for a grid of 4, 6, 9 or 16 digits.
+    static void defaultClues(int kind, int & min_clues, int & max_clues, int digits = 9) {
+        if (digits == 4) {
+            switch (kind) {
+                case Minimal:       min_clues = 4;  max_clues = 10; break;
+                case MultiSolution: min_clues = 2;  max_clues = 5;  break;
+                case Sparse:        min_clues = 0;  max_clues = 3;  break;
+                default:            min_clues = 5;  max_clues = 8;  break;
+            }
+        }
+        else if (digits == 6) {
+            switch (kind) {
+                case Minimal:       min_clues = 8;  max_clues = 20; break;
+                case MultiSolution: min_clues = 5;  max_clues = 10; break;
+                case Sparse:        min_clues = 0;  max_clues = 5;  break;
+                default:            min_clues = 12; max_clues = 18; break;
+            }
+        }
+        else if (digits == 16) {
+            switch (kind) {
+                case Minimal:       min_clues = 80;  max_clues = 120; break;
+                case MultiSolution: min_clues = 60;  max_clues = 90;  break;
+                case Sparse:        min_clues = 0;   max_clues = 30;  break;
+                default:            min_clues = 100; max_clues = 130; break;
+            }
+        }
+        else {
+            switch (kind) {
+                case Minimal:       min_clues = 17; max_clues = 40; break;
+                case MultiSolution: min_clues = 17; max_clues = 30; break;
+                case Sparse:        min_clues = 0;  max_clues = 10; break;
+                default:            min_clues = 22; max_clues = 30; break;
+            }
+        }
+    }
+};
+
+//
+// The grid geometries: the box width and height, the digit characters, the extra units
+// (see SudokuVariant.h) and the solvers.
+//
+template <typename Variant = VanillaSudoku>
+struct SudokuGrid {
+    static const int kBoxCellsX = 3;
+    static const int kBoxCellsY = 3;
+    static const int kDigits = 9;
+    static const int kCells = 81;
+
+    typedef Variant                             variant_type;
+    typedef DpllTriadSimdSolver<1, Variant>     solver_type;
+    typedef DpllTriadSimdSolver<0, Variant>     counter_type;
+
+    static char charOf(int digit) { return (char)('1' + digit); }
+    static int digitOf(char ch) { return ((ch >= '1' && ch <= '9') ? (ch - '1') : -1); }
+};
+
+struct HexadokuGrid {
+    static const int kBoxCellsX = 4;
+    static const int kBoxCellsY = 4;
+    static const int kDigits = 16;
+    static const int kCells = 256;
+
+    typedef VanillaSudoku         variant_type;
+    typedef HexadokuSimdSolver<1> solver_type;
+    typedef HexadokuSimdSolver<0> counter_type;
+
+    static char charOf(int digit) { return HexBoard::charOf(digit); }
+    static int digitOf(char ch) { return HexBoard::digitOf(ch); }
+};
+
+template <typename SudokuT>
+struct MiniGrid {
+    static const int kBoxCellsX = (int)SudokuT::BoxCellsX;
+    static const int kBoxCellsY = (int)SudokuT::BoxCellsY;
+    static const int kDigits = (int)SudokuT::Numbers;
+    static const int kCells = (int)SudokuT::BoardSize;
+
+    typedef VanillaSudoku                variant_type;
+    typedef MiniSudokuSolver<1, SudokuT> solver_type;
+    typedef MiniSudokuSolver<0, SudokuT> counter_type;
+
+    static char charOf(int digit) { return (char)('1' + digit); }
+    static int digitOf(char ch) { return ((ch >= '1' && ch < (char)('1' + kDigits)) ? (ch - '1') : -1); }
+};
+
+template <typename Grid>
+class BasicSudokuGenerator {
+public:
+    typedef typename Grid::solver_type  solver_type;
+    typedef typename Grid::counter_type counter_type;
+    typedef typename Grid::variant_type variant_type;
+
+    static const int kMaxAttempts = 100;
+
+    static const int kBoxCellsX = Grid::kBoxCellsX;
+    static const int kBoxCellsY = Grid::kBoxCellsY;
+    static const int kBands = Grid::kDigits / kBoxCellsY;
+    static const int kStacks = Grid::kDigits / kBoxCellsX;
+    static const int kDigits = Grid::kDigits;
+    static const int kCells = Grid::kCells;
+    static const uint32_t kAllDigits = (1u << kDigits) - 1;
+
+private:
+    std::mt19937_64 rng_;
+    solver_type     solver_;
+    counter_type    counter_;
+    char            scratch_[kCells + 16];
+
+    int randomInt(int min_val, int max_val) {
+        std::uniform_int_distribution<int> dist(min_val, max_val);
+        return dist(this->rng_);
+    }
+
+    static bool isPeer(int pos1, int pos2) {
+        int row1 = pos1 / kDigits, col1 = pos1 % kDigits;
+        int row2 = pos2 / kDigits, col2 = pos2 % kDigits;
+        if (pos1 == pos2)
+            return false;
+        if ((row1 == row2) || (col1 == col2) ||
+            ((row1 / kBoxCellsY == row2 / kBoxCellsY) && (col1 / kBoxCellsX == col2 / kBoxCellsX)))
+            return true;
+        for (size_t unit = 0; unit < variant_type::kUnits; unit++) {
+            if (variant_type::inUnit(unit, row1, col1) && variant_type::inUnit(unit, row2, col2))
+                return true;
+        }
+        return false;
+    }
+
+public:
+    static int countClues(const char * puzzle) {
+        int clues = 0;
+        for (int pos = 0; pos < kCells; pos++) {
+            clues += (puzzle[pos] != '.');
+        }
+        return clues;
+    }
+
+private:
+    // The cells in a random order.
+    void shuffledCells(int cells[kCells]) {
+        for (int pos = 0; pos < kCells; pos++) {
+            cells[pos] = pos;
+        }
+        std::shuffle(cells, cells + kCells, this->rng_);
+    }
+
+    // Keep clues of the grid at random, down to target_clues, no check.
+    void randomSubset(const char grid[kCells], char puzzle[kCells], int target_clues) {
+        int cells[kCells];
+        this->shuffledCells(cells);
+        std::memset(puzzle, '.', kCells);
+        for (int i = 0; i < target_clues; i++) {
+            puzzle[cells[i]] = grid[cells[i]];
+        }
+    }
+
+    //
+    // Remove clues in a random order while the solution stays unique, until target_clues
+    // are left (or no clue can be removed, when target_clues is 0). Returns the clues left.
+    //
+    int reduceUnique(char puzzle[kCells], int target_clues) {
+        int cells[kCells];
+        this->shuffledCells(cells);
+        int clues = countClues(puzzle);
+        for (int i = 0; i < kCells && clues > target_clues; i++) {
+            int pos = cells[i];
+            char digit = puzzle[pos];
+            if (digit == '.')
+                continue;
+            puzzle[pos] = '.';
+            if (this->countSolutions(puzzle, 2) == 1)
+                clues--;
+            else
+                puzzle[pos] = digit;
+        }
+        return clues;
+    }
+
+    bool makeRandom(char puzzle[kCells], int target_clues) {
+        char grid[kCells];
+        this->solutionGrid(grid);
+        std::memcpy(puzzle, grid, kCells);
+        return (this->reduceUnique(puzzle, target_clues) == target_clues);
+    }
+
+    bool makeMinimal(char puzzle[kCells], int min_clues, int max_clues) {
+        char grid[kCells];
+        this->solutionGrid(grid);
+        std::memcpy(puzzle, grid, kCells);
+        int clues = this->reduceUnique(puzzle, 0);
+        return (clues >= min_clues && clues <= max_clues);
+    }
+
+    //
+    // A unique puzzle plus one wrong clue. The cell is forced to its solution digit, so any
+    // other digit leaves no solution; one that no peer holds is only found by the search.
+    //
+    bool makeContradiction(char puzzle[kCells], int target_clues) {
+        char grid[kCells];
+        this->solutionGrid(grid);
+        std::memcpy(puzzle, grid, kCells);
+        if (this->reduceUnique(puzzle, target_clues - 1) != target_clues - 1)
+            return false;
+
+        int cells[kCells];
+        this->shuffledCells(cells);
+        for (int i = 0; i < kCells; i++) {
+            int pos = cells[i];
+            if (puzzle[pos] != '.')
+                continue;
+            uint32_t used = 1u << Grid::digitOf(grid[pos]);
+            for (int peer = 0; peer < kCells; peer++) {
+                if (puzzle[peer] != '.' && isPeer(pos, peer))
+                    used |= 1u << Grid::digitOf(puzzle[peer]);
+            }
+            if (used == kAllDigits)
+                continue;
+            int digit;
+            do {
+                digit = this->randomInt(0, kDigits - 1);
+            } while ((used & (1u << digit)) != 0);
+            puzzle[pos] = Grid::charOf(digit);
+            return (this->countSolutions(puzzle, 1) == 0);
+        }
+        return false;
+    }
+
+    // A unique puzzle plus a copy of one of its givens in an empty peer cell.
+    bool makeDuplicate(char puzzle[kCells], int target_clues) {
+        if (target_clues < 2 || !this->makeRandom(puzzle, target_clues - 1))
+            return false;
+
+        int cells[kCells];
+        this->shuffledCells(cells);
+        for (int i = 0; i < kCells; i++) {
+            int given = cells[i];
+            if (puzzle[given] == '.')
+                continue;
+            int peers[kCells];
+            int num_peers = 0;
+            for (int pos = 0; pos < kCells; pos++) {
+                if (puzzle[pos] == '.' && isPeer(given, pos))
+                    peers[num_peers++] = pos;
+            }
+            if (num_peers != 0) {
+                puzzle[peers[this->randomInt(0, num_peers - 1)]] = puzzle[given];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool makeMultiSolution(char puzzle[kCells], int target_clues) {
+        char grid[kCells];
+        this->solutionGrid(grid);
+        this->randomSubset(grid, puzzle, target_clues);
+        return (this->countSolutions(puzzle, 2) >= 2);
+    }
+
+    bool makeSparse(char puzzle[kCells], int target_clues) {
+        char grid[kCells];
+        this->solutionGrid(grid);
+        this->randomSubset(grid, puzzle, target_clues);
+        return true;
+    }
+
+public:
+    explicit BasicSudokuGenerator(uint64_t seed = 1) : rng_(seed) {}
+
+    // The number of solutions, up to limit.
+    size_t countSolutions(const char * puzzle, size_t limit) {
+        return this->counter_.solve(puzzle, &this->scratch_[0], limit);
+    }
+
+    // A random permutation of the digits in the box on the diagonal.
+    void randomDiagonalBox(char puzzle[kCells], int box) {
+        int digits[kDigits];
+        for (int i = 0; i < kDigits; i++) {
+            digits[i] = i;
+        }
+        std::shuffle(digits, digits + kDigits, this->rng_);
+        for (int i = 0; i < kDigits; i++) {
+            puzzle[(box * kBoxCellsY + i / kBoxCellsX) * kDigits + box * kBoxCellsX + i % kBoxCellsX] =
+                Grid::charOf(digits[i]);
+        }
+    }
+
+    //
+    // A random solution grid of a variant. The extra units don't survive the row and band
+    // shuffles, so a random first box and a few random givens that no peer holds make the
+    // grid random instead, until the solver completes one.
+    //
+    void variantSolutionGrid(char grid[kCells]) {
+        char puzzle[kCells];
+        for (;;) {
+            std::memset(puzzle, '.', sizeof(puzzle));
+            this->randomDiagonalBox(puzzle, 0);
+            for (int i = 0; i < kDigits; i++) {
+                int pos = this->randomInt(0, kCells - 1);
+                if (puzzle[pos] != '.')
+                    continue;
+                uint32_t used = 0;
+                for (int peer = 0; peer < kCells; peer++) {
+                    if (puzzle[peer] != '.' && isPeer(pos, peer))
+                        used |= 1u << Grid::digitOf(puzzle[peer]);
+                }
+                if (used == kAllDigits)
+                    continue;
+                int digit;
+                do {
+                    digit = this->randomInt(0, kDigits - 1);
+                } while ((used & (1u << digit)) != 0);
+                puzzle[pos] = Grid::charOf(digit);
+            }
+            if (this->solver_.solve(puzzle, &this->scratch_[0], 1) == 1) {
+                std::memcpy(grid, &this->scratch_[0], kCells);
+                return;
+            }
+        }
+    }
+
+    //
+    // A random solution grid: the diagonal boxes (which don't see each other) get a random
+    // permutation each, the solver completes the grid, and the rows of each band, the bands
+    // and (for square boxes) the transposition are shuffled on top.
+    //
+    void solutionGrid(char grid[kCells]) {
+        if (variant_type::kUnits != 0) {
+            this->variantSolutionGrid(grid);
+            return;
+        }
+
+        char puzzle[kCells];
+        std::memset(puzzle, '.', sizeof(puzzle));
+        for (int box = 0; box < kBands && box < kStacks; box++) {
+            this->randomDiagonalBox(puzzle, box);
+        }
+        size_t solutions = this->solver_.solve(puzzle, &this->scratch_[0], 1);
+        assert(solutions == 1);
+        (void)solutions;
+
+        int bands[kBands];
+        for (int band = 0; band < kBands; band++) {
+            bands[band] = band;
+        }
+        std::shuffle(bands, bands + kBands, this->rng_);
+        int rows[kDigits];
+        for (int band = 0; band < kBands; band++) {
+            int band_rows[kBoxCellsY];
+            for (int i = 0; i < kBoxCellsY; i++) {
+                band_rows[i] = i;
+            }
+            std::shuffle(band_rows, band_rows + kBoxCellsY, this->rng_);
+            for (int i = 0; i < kBoxCellsY; i++) {
+                rows[band * kBoxCellsY + i] = bands[band] * kBoxCellsY + band_rows[i];
+            }
+        }
+        bool transpose = (kBoxCellsX == kBoxCellsY) && (this->randomInt(0, 1) != 0);
+        for (int row = 0; row < kDigits; row++) {
+            for (int col = 0; col < kDigits; col++) {
+                char digit = this->scratch_[rows[row] * kDigits + col];
+                if (transpose)
+                    grid[col * kDigits + row] = digit;
+                else
+                    grid[row * kDigits + col] = digit;
+            }
+        }
+    }
+
+    //
+    // One puzzle of the kind, with a number of clues in [min_clues, max_clues]. Returns
+    // false if none was found in kMaxAttempts (a clue count too low for the kind).
+    //
+    bool generate(int kind, int min_clues, int max_clues, char puzzle[kCells]) {
+        min_clues = (std::max)(min_clues, 0);
+        max_clues = (std::min)(max_clues, (int)kCells);
+        if (min_clues > max_clues)
+            return false;
+
+        for (int attempt = 0; attempt < kMaxAttempts; attempt++) {
+            int target_clues = this->randomInt(min_clues, max_clues);
+            bool success;
+            switch (kind) {
+                case PuzzleKind::Random:
+                    success = this->makeRandom(puzzle, target_clues);
+                    break;
+                case PuzzleKind::Minimal:
+                    success = this->makeMinimal(puzzle, min_clues, max_clues);
+                    break;
+                case PuzzleKind::Contradiction:
+                    success = this->makeContradiction(puzzle, target_clues);
+                    break;
+                case PuzzleKind::Duplicate:
+                    success = this->makeDuplicate(puzzle, target_clues);
+                    break;
+                case PuzzleKind::MultiSolution:
+                    success = this->makeMultiSolution(puzzle, target_clues);
+                    break;
+                case PuzzleKind::Sparse:
+                    success = this->makeSparse(puzzle, target_clues);
+                    break;
+                default:
+                    return false;
+            }
+            if (success)
+                return true;
+        }
+        return false;
+    }
+};
+
+typedef BasicSudokuGenerator<SudokuGrid<>>          SudokuGenerator;
+typedef BasicSudokuGenerator<SudokuGrid<SudokuX>>   SudokuXGenerator;
+typedef BasicSudokuGenerator<SudokuGrid<Windoku>>   WindokuGenerator;
+typedef BasicSudokuGenerator<HexadokuGrid>          HexadokuGenerator;
+typedef BasicSudokuGenerator<MiniGrid<Sudoku4x4>>   Sudoku4x4Generator;
+typedef BasicSudokuGenerator<MiniGrid<Sudoku6x6>>   Sudoku6x6Generator;
+
+//
+// Killer puzzles (see KillerSudokuSolver.h): a random solution grid cut into cages, each
+// grown from a random cell to a random size over the neighbour cells that don't repeat one
+// of its digits, until the cage sums alone have a unique solution.
+//
+class KillerSudokuGenerator {
+public:
+    static const int kMaxAttempts = 100;
+    static const int kCells = 81;
+
+private:
+    std::mt19937_64             rng_;
+    SudokuGenerator             grids_;
+    KillerSudokuSolver<0>       counter_;
+    char                        scratch_[kKillerLineSize];
+
+    int randomInt(int min_val, int max_val) {
+        std::uniform_int_distribution<int> dist(min_val, max_val);
+        return dist(this->rng_);
+    }
+
+    static char cageId(int cage) {
+        return (char)((cage < 26) ? ('a' + cage) : ('A' + cage - 26));
+    }
+
+    // Cut the grid into cages of min_size to max_size cells (fewer when a cage gets stuck).
+    // Returns the number of cages, or -1 for more than kMaxCages.
+    int makeCages(const char grid[kCells], int cages[kCells], int min_size, int max_size) {
+        int cells[kCells];
+        for (int pos = 0; pos < kCells; pos++) {
+            cells[pos] = pos;
+            cages[pos] = -1;
+        }
+        std::shuffle(cells, cells + kCells, this->rng_);
+
+        int num_cages = 0;
+        for (int i = 0; i < kCells; i++) {
+            int first = cells[i];
+            if (cages[first] >= 0)
+                continue;
+            if (num_cages >= (int)kMaxCages)
+                return -1;
+            int cage = num_cages++;
+            int target_size = this->randomInt(min_size, max_size);
+            int members[kMaxCageSize];
+            int size = 0;
+            uint32_t digits = 0;
+            members[size++] = first;
+            cages[first] = cage;
+            digits |= 1u << (grid[first] - '1');
+            while (size < target_size) {
+                // The free neighbour cells whose digit is not in the cage yet.
+                int neighbours[kMaxCageSize * 4];
+                int num_neighbours = 0;
+                for (int m = 0; m < size; m++) {
+                    int row = members[m] / 9, col = members[m] % 9;
+                    static const int kDeltas[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+                    for (int d = 0; d < 4; d++) {
+                        int row2 = row + kDeltas[d][0], col2 = col + kDeltas[d][1];
+                        if (row2 < 0 || row2 >= 9 || col2 < 0 || col2 >= 9)
+                            continue;
+                        int pos = row2 * 9 + col2;
+                        if (cages[pos] < 0 && (digits & (1u << (grid[pos] - '1'))) == 0)
+                            neighbours[num_neighbours++] = pos;
+                    }
+                }
+                if (num_neighbours == 0)
+                    break;
+                int next = neighbours[this->randomInt(0, num_neighbours - 1)];
+                members[size++] = next;
+                cages[next] = cage;
+                digits |= 1u << (grid[next] - '1');
+            }
+        }
+        return num_cages;
+    }
+
+public:
+    explicit KillerSudokuGenerator(uint64_t seed = 1) : rng_(seed), grids_(seed + 1) {}
+
+    //
+    // One killer puzzle line with cages of min_size to max_size cells and a unique solution.
+    // Returns false if none was found in kMaxAttempts.
+    //
+    bool generate(int min_size, int max_size, char line[kKillerLineSize]) {
+        min_size = (std::max)(min_size, 1);
+        max_size = (std::min)(max_size, (int)kMaxCageSize);
+        if (min_size > max_size)
+            return false;
+
+        char grid[kCells];
+        for (int attempt = 0; attempt < kMaxAttempts; attempt++) {
+            this->grids_.solutionGrid(grid);
+            int cages[kCells];
+            int num_cages = this->makeCages(grid, cages, min_size, max_size);
+            if (num_cages < 0)
+                continue;
+
+            int sums[kMaxCages] = { 0 };
+            for (int pos = 0; pos < kCells; pos++) {
+                line[pos] = cageId(cages[pos]);
+                sums[cages[pos]] += grid[pos] - '0';
+            }
+            int length = kCells;
+            line[length++] = ':';
+            for (int cage = 0; cage < num_cages; cage++) {
+                length += snprintf(line + length, kKillerLineSize - length, "%s%d",
+                                   (cage == 0) ? "" : ",", sums[cage]);
+            }
+            if (this->counter_.solve(line, &this->scratch_[0], 2) == 1)
+                return true;
+        }
+        return false;
+    }
+
+    static int countCages(const char * line) {
+        int cages = 0;
+        for (const char * p = line + kCells; *p != '\0'; p++) {
+            cages += (*p == ':' || *p == ',');
+        }
+        return cages;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_SUDOKU_GENERATOR_H
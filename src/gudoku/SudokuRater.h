@@ -0,0 +1,701 @@
+
+#ifndef GUDOKU_SUDOKU_RATER_H
+#define GUDOKU_SUDOKU_RATER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <memory.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset(), std::memcpy()
+
+#include "gudoku/BasicSolver.h"
+#include "gudoku/Sudoku.h"
+#include "gudoku/BitUtils.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/StaticData.h"
+
+#include "gudoku/DpllTriadSimdSolver.h"
+
+using namespace gudoku;
+
+namespace {
+
+//
+// The difficulty rating ladder, ordered from the easiest to the hardest technique.
+// A puzzle is rated by the hardest technique it needs when the ladder is always
+// restarted from the easiest rung after each step of progress. The nominal scores
+// roughly follow the Sudoku Explainer scale, so they can be compared with it.
+//
+struct Technique {
+    enum {
+        None,
+        HiddenSingle,
+        NakedSingle,
+        LockedCandidates,
+        NakedPair,
+        XWing,
+        HiddenPair,
+        NakedTriple,
+        Swordfish,
+        HiddenTriple,
+        SimpleColoring,
+        Backtracking,
+        Invalid,
+        Last
+    };
+
+    static const char * name(int technique) {
+        static const char * s_names[Last] = {
+            "None",
+            "HiddenSingle",
+            "NakedSingle",
+            "LockedCandidates",
+            "NakedPair",
+            "X-Wing",
+            "HiddenPair",
+            "NakedTriple",
+            "Swordfish",
+            "HiddenTriple",
+            "SimpleColoring",
+            "Backtracking",
+            "Invalid"
+        };
+        return (technique >= 0 && technique < Last) ? s_names[technique] : "Unknown";
+    }
+
+    static double score(int technique) {
+        static const double s_scores[Last] = {
+            0.0, 1.5, 2.3, 2.6, 3.0, 3.2, 3.4, 3.6, 3.8, 4.0, 4.5, 10.0, 0.0
+        };
+        return (technique >= 0 && technique < Last) ? s_scores[technique] : 0.0;
+    }
+};
+
+struct RateInfo {
+    int     rating;
+    double  score;
+    size_t  num_solutions;
+    size_t  num_guesses;
+    size_t  steps[Technique::Last];
+
+    RateInfo() noexcept {
+        this->clear();
+    }
+
+    void clear() {
+        this->rating = Technique::None;
+        this->score = 0.0;
+        this->num_solutions = 0;
+        this->num_guesses = 0;
+        std::memset((void *)&this->steps[0], 0, sizeof(this->steps));
+    }
+};
+
+//
+// The rater keeps one 81-bit candidate plane per digit in a BitVec08x16, one band per
+// 32-bit lane (27 bits each, lane 3 is always zero):
+//
+//     lane:     0: band 0 (rows 0-2)   1: band 1 (rows 3-5)   2: band 2 (rows 6-8)
+//     bit:      (row % 3) * 9 + col
+//
+// So a row is a 9-bit field of a lane, a box is three 3-bit fields of a lane, and the
+// intersection of a box and a row or a column is the triad (minirow / minicol) used by the
+// DPLL solver. Placing a digit, eliminating a unit or a peer set, and counting candidates
+// are all done on whole planes.
+//
+//
+// Constant-initialized (see StaticData.h): every mask holds 27-bit bands in its 32-bit
+// lanes, and each entry is a constexpr function of the flat table index.
+//
+struct alignas(64) RaterTables {
+    ConstBitVec<BitVec08x16> cell_mask[81];
+    ConstBitVec<BitVec08x16> peer_mask[81];
+    // rows [0, 9), cols [9, 18), boxes [18, 27)
+    ConstBitVec<BitVec08x16> unit_mask[27];
+    uint8_t     unit_cells[27][9];
+    uint8_t     cell_units[81][3];
+
+    static constexpr uint32_t rowOf(uint32_t pos) { return pos / 9; }
+    static constexpr uint32_t colOf(uint32_t pos) { return pos % 9; }
+    static constexpr uint32_t boxOf(uint32_t pos) { return (pos / 27) * 3 + (pos % 9) / 3; }
+
+    static constexpr uint32_t cellBand(uint32_t pos, uint32_t band) {
+        return (pos / 27 == band) ? (1u << (pos % 27)) : 0;
+    }
+
+    static constexpr uint32_t unitBand(uint32_t unit, uint32_t band) {
+        return (unit < 9)  ? ((unit / 3 == band) ? (0x01FFu << ((unit % 3) * 9)) : 0) :
+               (unit < 18) ? ((band < 3) ? ((1u << (unit - 9)) | (1u << (unit - 9 + 9)) |
+                                            (1u << (unit - 9 + 18))) : 0) :
+                             (((unit - 18) / 3 == band) ?
+                              ((0x07u | (0x07u << 9) | (0x07u << 18)) << (((unit - 18) % 3) * 3)) : 0);
+    }
+
+    static constexpr uint32_t peerBand(uint32_t pos, uint32_t band) {
+        return (unitBand(rowOf(pos), band) | unitBand(9 + colOf(pos), band) |
+                unitBand(18 + boxOf(pos), band)) & ~cellBand(pos, band);
+    }
+
+    // The 16-bit lane of a 32-bit band.
+    static constexpr uint16_t lane16(uint32_t band_bits, size_t lane) {
+        return (uint16_t)((lane % 2 == 0) ? (band_bits & 0xFFFFu) : (band_bits >> 16));
+    }
+
+    static constexpr uint8_t unitCell(size_t unit, size_t i) {
+        return (uint8_t)((unit < 9)  ? (unit * 9 + i) :
+                         (unit < 18) ? (i * 9 + (unit - 9)) :
+                                       (((unit - 18) / 3 * 3 + i / 3) * 9 + ((unit - 18) % 3) * 3 + i % 3));
+    }
+
+    static constexpr uint8_t cellUnit(size_t pos, size_t k) {
+        return (uint8_t)((k == 0) ? rowOf((uint32_t)pos) :
+                         (k == 1) ? (9 + colOf((uint32_t)pos)) : (18 + boxOf((uint32_t)pos)));
+    }
+
+    template <size_t... Cells, size_t... Units, size_t... UnitCells, size_t... CellUnits>
+    static constexpr RaterTables make(IndexSequence<Cells...>, IndexSequence<Units...>,
+                                      IndexSequence<UnitCells...>, IndexSequence<CellUnits...>) {
+        return RaterTables {
+            // cell_mask[81]
+            { lane16(cellBand((uint32_t)(Cells / 8), (uint32_t)(Cells % 8 / 2)), Cells % 8)... },
+            // peer_mask[81]
+            { lane16(peerBand((uint32_t)(Cells / 8), (uint32_t)(Cells % 8 / 2)), Cells % 8)... },
+            // unit_mask[27]
+            { lane16(unitBand((uint32_t)(Units / 8), (uint32_t)(Units % 8 / 2)), Units % 8)... },
+            // unit_cells[27][9]
+            { unitCell(UnitCells / 9, UnitCells % 9)... },
+            // cell_units[81][3]
+            { cellUnit(CellUnits / 3, CellUnits % 3)... }
+        };
+    }
+};
+
+static constexpr RaterTables rater_tables = RaterTables::make(MakeIndexSequence<81 * 8>::type(),
+                                                              MakeIndexSequence<27 * 8>::type(),
+                                                              MakeIndexSequence<27 * 9>::type(),
+                                                              MakeIndexSequence<81 * 3>::type());
+
+class SudokuRater {
+public:
+    static const uint32_t kBitSet27 = 0x07FFFFFFUL;
+
+private:
+    BitVec08x16 planes_[9];     // candidates of each digit (unsolved cells only)
+    BitVec08x16 placed_[9];     // cells where each digit has been placed
+    BitVec08x16 unsolved_;
+    char        grid_[81];
+    bool        invalid_;
+
+    DpllTriadSimdSolver<1> solver_;
+    DpllTriadSimdSolver<0> counter_;
+
+    // Calls visit(pos) for each cell in the 81-bit mask, in row-major order.
+    template <typename Visitor>
+    static inline void forEachCell(const BitVec08x16 & mask, Visitor visit) {
+        uint64_t low  = mask.extractU64<0>();
+        uint64_t high = mask.extractU64<1>();
+        uint32_t bands[3] = { (uint32_t)low, (uint32_t)(low >> 32), (uint32_t)high };
+        for (uint32_t band = 0; band < 3; band++) {
+            uint32_t bits = bands[band];
+            while (bits != 0) {
+                uint32_t bit = BitUtils::bsf32(bits);
+                visit((int)(band * 27 + bit));
+                bits = BitUtils::clearLowBit32(bits);
+            }
+        }
+    }
+
+    static inline int firstCell(const BitVec08x16 & mask) {
+        uint64_t low = mask.extractU64<0>();
+        if (low != 0) {
+            uint32_t bit = BitUtils::bsf64(low);
+            return (bit < 32) ? (int)bit : (int)(27 + bit - 32);
+        }
+        uint64_t high = mask.extractU64<1>();
+        return (high != 0) ? (int)(54 + BitUtils::bsf64(high)) : -1;
+    }
+
+    // 9-bit column mask of a row in the plane.
+    static inline uint32_t rowBits(const uint32_t bands[3], uint32_t row) {
+        return (bands[row / 3] >> ((row % 3) * 9)) & 0x01FFu;
+    }
+
+    static inline void getBands(const BitVec08x16 & mask, uint32_t bands[3]) {
+        uint64_t low  = mask.extractU64<0>();
+        uint64_t high = mask.extractU64<1>();
+        bands[0] = (uint32_t)low;
+        bands[1] = (uint32_t)(low >> 32);
+        bands[2] = (uint32_t)high;
+    }
+
+    void assign(int pos, int digit) {
+        const BitVec08x16 & cell = rater_tables.cell_mask[pos];
+        if (!this->planes_[digit].hasIntersects(cell)) {
+            // The digit was already eliminated from this cell (duplicate givens, or a
+            // conflicting pair of singles in the same pass).
+            this->invalid_ = true;
+            return;
+        }
+        this->grid_[pos] = (char)('1' + digit);
+        for (int d = 0; d < 9; d++) {
+            this->planes_[d] = this->planes_[d].and_not(cell);
+        }
+        this->planes_[digit] = this->planes_[digit].and_not(rater_tables.peer_mask[pos]);
+        this->placed_[digit] |= cell;
+        this->unsolved_ = this->unsolved_.and_not(cell);
+    }
+
+    // Removes the cells in mask from the plane of digit, returns true if anything changed.
+    inline bool eliminate(int digit, const BitVec08x16 & mask) {
+        if (!this->planes_[digit].hasIntersects(mask)) return false;
+        this->planes_[digit] = this->planes_[digit].and_not(mask);
+        return true;
+    }
+
+    bool isConsistent() const {
+        if (this->invalid_) return false;
+        // Every unsolved cell keeps at least one candidate
+        BitVec08x16 any = this->planes_[0];
+        for (int d = 1; d < 9; d++) {
+            any |= this->planes_[d];
+        }
+        if (this->unsolved_.and_not(any).isNotAllZeros()) return false;
+        // Every digit is still placed or placeable in every unit
+        for (int d = 0; d < 9; d++) {
+            BitVec08x16 coverage = this->planes_[d] | this->placed_[d];
+            for (int unit = 0; unit < 27; unit++) {
+                if (!coverage.hasIntersects(rater_tables.unit_mask[unit])) return false;
+            }
+        }
+        return true;
+    }
+
+    bool initSudoku(const char * puzzle) {
+        const BitVec08x16 all_cells(kBitSet27, kBitSet27, kBitSet27, 0u);
+        for (int d = 0; d < 9; d++) {
+            this->planes_[d] = all_cells;
+            this->placed_[d].setAllZeros();
+        }
+        this->unsolved_ = all_cells;
+        this->invalid_ = false;
+
+        for (int pos = 0; pos < 81; pos++) {
+            char val = puzzle[pos];
+            if (val >= '1' && val <= '9') {
+                this->assign(pos, val - '1');
+            }
+            else {
+                this->grid_[pos] = '.';
+            }
+        }
+        return !this->invalid_;
+    }
+
+    //
+    // Hidden singles: a digit that has exactly one position left in some unit.
+    //
+    size_t hiddenSingles() {
+        size_t placed = 0;
+        for (int d = 0; d < 9; d++) {
+            for (int unit = 0; unit < 27; unit++) {
+                if (this->placed_[d].hasIntersects(rater_tables.unit_mask[unit])) continue;
+                BitVec08x16 positions = this->planes_[d] & rater_tables.unit_mask[unit];
+                if (positions.popcount() == 1) {
+                    this->assign(firstCell(positions), d);
+                    placed++;
+                }
+            }
+        }
+        return placed;
+    }
+
+    //
+    // Naked singles: bit-sliced counting across the nine planes, so all the cells with
+    // exactly one candidate are found with a handful of vector ops.
+    //
+    size_t nakedSingles() {
+        BitVec08x16 one = this->planes_[0], two;
+        two.setAllZeros();
+        for (int d = 1; d < 9; d++) {
+            two |= one & this->planes_[d];
+            one |= this->planes_[d];
+        }
+        BitVec08x16 singles = one.and_not(two);
+        if (singles.isAllZeros()) return 0;
+
+        size_t placed = 0;
+        for (int d = 0; d < 9; d++) {
+            BitVec08x16 cells = singles & this->planes_[d];
+            forEachCell(cells, [&](int pos) {
+                this->assign(pos, d);
+                placed++;
+            });
+        }
+        return placed;
+    }
+
+    //
+    // Locked candidates over the 54 triads (box/line intersections):
+    //   pointing - the box positions of a digit lie in one triad, so the rest of the line loses it.
+    //   claiming - the line positions of a digit lie in one triad, so the rest of the box loses it.
+    //
+    // These are the triads of the DPLL solver, but not its band configurations: a band's
+    // configurations are narrowed by the triad clauses and by propagation to a fixpoint, all
+    // at once, so an elimination found there can't be told apart as a locked candidates
+    // step from a pair or a fish. The rater counts each technique's steps and rates by the
+    // hardest one, so it finds the eliminations on its own digit planes.
+    //
+    size_t lockedCandidates() {
+        size_t eliminated = 0;
+        for (int d = 0; d < 9; d++) {
+            const BitVec08x16 & plane = this->planes_[d];
+            for (int box = 0; box < 9; box++) {
+                const BitVec08x16 & box_mask = rater_tables.unit_mask[18 + box];
+                BitVec08x16 in_box = plane & box_mask;
+                if (in_box.isAllZeros()) continue;
+                for (int i = 0; i < 6; i++) {
+                    int line = (i < 3) ? ((box / 3) * 3 + i) : (9 + (box % 3) * 3 + (i - 3));
+                    const BitVec08x16 & line_mask = rater_tables.unit_mask[line];
+                    BitVec08x16 triad = in_box & line_mask;
+                    if (triad.isAllZeros()) continue;
+                    if (in_box.isSubsetOf(line_mask)) {
+                        eliminated += this->eliminate(d, line_mask.and_not(box_mask));
+                    }
+                    else if ((this->planes_[d] & line_mask).isSubsetOf(box_mask)) {
+                        eliminated += this->eliminate(d, box_mask.and_not(line_mask));
+                    }
+                }
+            }
+        }
+        return eliminated;
+    }
+
+    void getCellCandidates(uint16_t candidates[81]) const {
+        std::memset((void *)&candidates[0], 0, sizeof(uint16_t) * 81);
+        for (int d = 0; d < 9; d++) {
+            forEachCell(this->planes_[d], [&](int pos) {
+                candidates[pos] |= (uint16_t)(1u << d);
+            });
+        }
+    }
+
+    //
+    // Naked pairs / triples: N cells of a unit whose candidates union to N digits.
+    //
+    size_t nakedSubsets(int size) {
+        uint16_t candidates[81];
+        this->getCellCandidates(candidates);
+
+        size_t eliminated = 0;
+        for (int unit = 0; unit < 27; unit++) {
+            int cells[9], count = 0;
+            for (int i = 0; i < 9; i++) {
+                int pos = rater_tables.unit_cells[unit][i];
+                uint32_t n = BitUtils::popcnt32(candidates[pos]);
+                if (n >= 2 && n <= (uint32_t)size) {
+                    cells[count++] = pos;
+                }
+            }
+            if (count < size) continue;
+
+            const BitVec08x16 & unit_mask = rater_tables.unit_mask[unit];
+            for (int a = 0; a < count; a++) {
+                for (int b = a + 1; b < count; b++) {
+                    int c_begin = (size == 3) ? (b + 1) : count;
+                    int c_end   = (size == 3) ? count : (count + 1);
+                    for (int c = c_begin; c < c_end; c++) {
+                        uint32_t digits = candidates[cells[a]] | candidates[cells[b]];
+                        BitVec08x16 subset = rater_tables.cell_mask[cells[a]].get() | rater_tables.cell_mask[cells[b]];
+                        if (size == 3) {
+                            digits |= candidates[cells[c]];
+                            subset |= rater_tables.cell_mask[cells[c]];
+                        }
+                        if (BitUtils::popcnt32(digits) != (uint32_t)size) continue;
+
+                        BitVec08x16 others = unit_mask.and_not(subset);
+                        size_t found = 0;
+                        while (digits != 0) {
+                            int d = (int)BitUtils::bsf32(digits);
+                            found += this->eliminate(d, others);
+                            digits = BitUtils::clearLowBit32(digits);
+                        }
+                        if (found != 0) return (eliminated + found);
+                    }
+                }
+            }
+        }
+        return eliminated;
+    }
+
+    //
+    // Hidden pairs / triples: N digits of a unit whose positions union to N cells.
+    //
+    size_t hiddenSubsets(int size) {
+        size_t eliminated = 0;
+        for (int unit = 0; unit < 27; unit++) {
+            const BitVec08x16 & unit_mask = rater_tables.unit_mask[unit];
+            int digits[9], count = 0;
+            BitVec08x16 positions[9];
+            for (int d = 0; d < 9; d++) {
+                BitVec08x16 cells = this->planes_[d] & unit_mask;
+                int n = cells.popcount();
+                if (n >= 2 && n <= size) {
+                    positions[count] = cells;
+                    digits[count++] = d;
+                }
+            }
+            if (count < size) continue;
+
+            for (int a = 0; a < count; a++) {
+                for (int b = a + 1; b < count; b++) {
+                    int c_begin = (size == 3) ? (b + 1) : count;
+                    int c_end   = (size == 3) ? count : (count + 1);
+                    for (int c = c_begin; c < c_end; c++) {
+                        uint32_t digit_bits = (1u << digits[a]) | (1u << digits[b]);
+                        BitVec08x16 subset = positions[a] | positions[b];
+                        if (size == 3) {
+                            digit_bits |= (1u << digits[c]);
+                            subset |= positions[c];
+                        }
+                        if (subset.popcount() != size) continue;
+
+                        size_t found = 0;
+                        for (int d = 0; d < 9; d++) {
+                            if ((digit_bits & (1u << d)) == 0)
+                                found += this->eliminate(d, subset);
+                        }
+                        if (found != 0) return (eliminated + found);
+                    }
+                }
+            }
+        }
+        return eliminated;
+    }
+
+    //
+    // Basic fish (X-Wing, Swordfish): N rows in which a digit is confined to the same
+    // N columns, or the transposed pattern.
+    //
+    size_t basicFish(int size) {
+        size_t eliminated = 0;
+        for (int d = 0; d < 9; d++) {
+            uint32_t bands[3];
+            getBands(this->planes_[d], bands);
+            uint32_t lines[2][9];
+            for (int i = 0; i < 9; i++) {
+                lines[0][i] = rowBits(bands, i);
+                lines[1][i] = 0;
+            }
+            for (int row = 0; row < 9; row++) {
+                uint32_t bits = lines[0][row];
+                while (bits != 0) {
+                    uint32_t col = BitUtils::bsf32(bits);
+                    lines[1][col] |= (1u << row);
+                    bits = BitUtils::clearLowBit32(bits);
+                }
+            }
+
+            for (int vertical = 0; vertical < 2; vertical++) {
+                int bases[9], count = 0;
+                for (int i = 0; i < 9; i++) {
+                    uint32_t n = BitUtils::popcnt32(lines[vertical][i]);
+                    if (n >= 2 && n <= (uint32_t)size)
+                        bases[count++] = i;
+                }
+                if (count < size) continue;
+
+                for (int a = 0; a < count; a++) {
+                    for (int b = a + 1; b < count; b++) {
+                        int c_begin = (size == 3) ? (b + 1) : count;
+                        int c_end   = (size == 3) ? count : (count + 1);
+                        for (int c = c_begin; c < c_end; c++) {
+                            uint32_t covers = lines[vertical][bases[a]] | lines[vertical][bases[b]];
+                            int base_offset = vertical * 9, cover_offset = (1 - vertical) * 9;
+                            BitVec08x16 base_mask = rater_tables.unit_mask[base_offset + bases[a]].get() |
+                                                    rater_tables.unit_mask[base_offset + bases[b]];
+                            if (size == 3) {
+                                covers |= lines[vertical][bases[c]];
+                                base_mask |= rater_tables.unit_mask[base_offset + bases[c]];
+                            }
+                            if (BitUtils::popcnt32(covers) != (uint32_t)size) continue;
+
+                            BitVec08x16 cover_mask;
+                            cover_mask.setAllZeros();
+                            while (covers != 0) {
+                                cover_mask |= rater_tables.unit_mask[cover_offset + BitUtils::bsf32(covers)];
+                                covers = BitUtils::clearLowBit32(covers);
+                            }
+                            size_t found = this->eliminate(d, cover_mask.and_not(base_mask));
+                            if (found != 0) return (eliminated + found);
+                        }
+                    }
+                }
+            }
+        }
+        return eliminated;
+    }
+
+    //
+    // Simple coloring (single digit chains): conjugate pairs of a digit form chains whose
+    // cells alternate between two colors, exactly one of which is true.
+    //   color wrap - two cells of the same color see each other, that color is false.
+    //   color trap - a cell that sees both colors of a chain loses the digit.
+    //
+    size_t simpleColoring() {
+        for (int d = 0; d < 9; d++) {
+            const BitVec08x16 plane = this->planes_[d];
+
+            // Build the conjugate links, each unit with exactly two positions is a link.
+            uint8_t links[81][27];
+            uint8_t num_links[81];
+            std::memset((void *)&num_links[0], 0, sizeof(num_links));
+            for (int unit = 0; unit < 27; unit++) {
+                BitVec08x16 cells = plane & rater_tables.unit_mask[unit];
+                if (cells.popcount() != 2) continue;
+                int first = firstCell(cells);
+                int second = firstCell(cells.and_not(rater_tables.cell_mask[first]));
+                links[first][num_links[first]++] = (uint8_t)second;
+                links[second][num_links[second]++] = (uint8_t)first;
+            }
+
+            int8_t color[81];
+            std::memset((void *)&color[0], -1, sizeof(color));
+            for (int start = 0; start < 81; start++) {
+                if (num_links[start] == 0 || color[start] >= 0) continue;
+
+                // Flood the chain from start, two colors alternate along the links.
+                BitVec08x16 colors[2];
+                colors[0].setAllZeros();
+                colors[1].setAllZeros();
+                int stack[81], top = 0;
+                stack[top++] = start;
+                color[start] = 0;
+                colors[0] |= rater_tables.cell_mask[start];
+                while (top > 0) {
+                    int pos = stack[--top];
+                    for (int i = 0; i < num_links[pos]; i++) {
+                        int next = links[pos][i];
+                        if (color[next] < 0) {
+                            color[next] = (int8_t)(1 - color[pos]);
+                            colors[color[next]] |= rater_tables.cell_mask[next];
+                            stack[top++] = next;
+                        }
+                    }
+                }
+                if ((colors[0] | colors[1]).popcount() < 4) continue;
+
+                // Color wrap
+                for (int c = 0; c < 2; c++) {
+                    bool wrapped = false;
+                    forEachCell(colors[c], [&](int pos) {
+                        if (rater_tables.peer_mask[pos].get().hasIntersects(colors[c]))
+                            wrapped = true;
+                    });
+                    if (wrapped) {
+                        return this->eliminate(d, colors[c]);
+                    }
+                }
+
+                // Color trap
+                BitVec08x16 trapped;
+                trapped.setAllZeros();
+                forEachCell(plane.and_not(colors[0] | colors[1]), [&](int pos) {
+                    if (rater_tables.peer_mask[pos].get().hasIntersects(colors[0]) &&
+                        rater_tables.peer_mask[pos].get().hasIntersects(colors[1]))
+                        trapped |= rater_tables.cell_mask[pos];
+                });
+                if (trapped.isNotAllZeros()) {
+                    return this->eliminate(d, trapped);
+                }
+            }
+        }
+        return 0;
+    }
+
+    // Applies the easiest technique that makes progress, returns it or Technique::None.
+    int step() {
+        if (this->hiddenSingles() != 0)     return Technique::HiddenSingle;
+        if (this->nakedSingles() != 0)      return Technique::NakedSingle;
+        if (this->lockedCandidates() != 0)  return Technique::LockedCandidates;
+        if (this->nakedSubsets(2) != 0)     return Technique::NakedPair;
+        if (this->basicFish(2) != 0)        return Technique::XWing;
+        if (this->hiddenSubsets(2) != 0)    return Technique::HiddenPair;
+        if (this->nakedSubsets(3) != 0)     return Technique::NakedTriple;
+        if (this->basicFish(3) != 0)        return Technique::Swordfish;
+        if (this->hiddenSubsets(3) != 0)    return Technique::HiddenTriple;
+        if (this->simpleColoring() != 0)    return Technique::SimpleColoring;
+        return Technique::None;
+    }
+
+public:
+    SudokuRater() : invalid_(false), solver_(), counter_() {}
+    ~SudokuRater() {}
+
+    //
+    // Rate the puzzle and write its solution. If the ladder gets stuck the puzzle is rated
+    // Backtracking and solved by the DPLL solver, which also checks the uniqueness.
+    // Returns the number of solutions (0, 1 or 2 meaning "more than one").
+    //
+    size_t rate(const char * puzzle, char * solution, RateInfo & info) {
+        info.clear();
+
+        bool success = this->initSudoku(puzzle);
+        int hardest = Technique::None;
+        while (success && this->unsolved_.isNotAllZeros()) {
+            if (!this->isConsistent()) {
+                success = false;
+                break;
+            }
+            int technique = this->step();
+            if (technique == Technique::None) {
+                hardest = Technique::Backtracking;
+                break;
+            }
+            info.steps[technique]++;
+            if (technique > hardest)
+                hardest = technique;
+        }
+        if (success && !this->isConsistent())
+            success = false;
+
+        if (!success) {
+            info.rating = Technique::Invalid;
+            info.score = Technique::score(Technique::Invalid);
+            return 0;
+        }
+
+        if (hardest == Technique::Backtracking) {
+            // A logic stall may also mean more than one solution, the search tells.
+            info.num_solutions = this->counter_.solve(puzzle, solution, 2);
+            if (info.num_solutions == 0) {
+                info.rating = Technique::Invalid;
+                info.score = Technique::score(Technique::Invalid);
+                return 0;
+            }
+            this->solver_.solve(puzzle, solution, 1);
+            info.num_guesses = this->solver_.get_num_guesses();
+            info.steps[Technique::Backtracking]++;
+        }
+        else {
+            std::memcpy((void *)solution, (const void *)&this->grid_[0], sizeof(this->grid_));
+            info.num_solutions = 1;
+        }
+
+        info.rating = hardest;
+        info.score = Technique::score(hardest);
+        return info.num_solutions;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_SUDOKU_RATER_H
@@ -0,0 +1,87 @@
+
+#ifndef GUDOKU_SUDOKU_VARIANT_H
+#define GUDOKU_SUDOKU_VARIANT_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+#include <cstddef>
+#include <cstring>      // For std::strcmp()
+
+//
+// The variants of the 9x9 sudoku: extra units of 9 cells, where every digit is placed
+// once, on top of the rows, columns and boxes. A variant is a policy class:
+//
+//   kUnits                  the number of extra units (0: the vanilla sudoku)
+//   inUnit(unit, row, col)  whether the cell is in the extra unit
+//   name()                  the name of the variant
+//
+// The solvers take the variant as a template parameter, so the vanilla sudoku compiles
+// the extra unit code away.
+//
+
+namespace gudoku {
+
+struct VanillaSudoku {
+    static const size_t kUnits = 0;
+
+    static constexpr bool inUnit(size_t unit, size_t row, size_t col) {
+        return false;
+    }
+
+    static const char * name() { return "vanilla"; }
+};
+
+// Sudoku-X: the two main diagonals.
+struct SudokuX {
+    static const size_t kUnits = 2;
+
+    static constexpr bool inUnit(size_t unit, size_t row, size_t col) {
+        return (unit == 0) ? (row == col) : (row + col == 8);
+    }
+
+    static const char * name() { return "x"; }
+};
+
+// Windoku: the four 3x3 windows of the rows 1-3, 5-7 and the columns 1-3, 5-7.
+struct Windoku {
+    static const size_t kUnits = 4;
+
+    static constexpr bool inUnit(size_t unit, size_t row, size_t col) {
+        return ((row % 4) != 0) && ((row / 4) == (unit / 2)) &&
+               ((col % 4) != 0) && ((col / 4) == (unit % 2));
+    }
+
+    static const char * name() { return "windoku"; }
+};
+
+struct SudokuVariant {
+    enum {
+        Vanilla,
+        X,
+        Windoku,
+        Last
+    };
+
+    static const char * name(int variant) {
+        static const char * s_names[Last] = { "vanilla", "x", "windoku" };
+        return ((variant >= 0 && variant < Last) ? s_names[variant] : "unknown");
+    }
+
+    // The variant of a name, or -1.
+    static int find(const char * name) {
+        for (int variant = 0; variant < Last; variant++) {
+            if (std::strcmp(SudokuVariant::name(variant), name) == 0)
+                return variant;
+        }
+        return -1;
+    }
+};
+
+} // namespace gudoku
+
+#endif // GUDOKU_SUDOKU_VARIANT_H
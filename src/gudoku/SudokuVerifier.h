@@ -0,0 +1,186 @@
+
+#ifndef GUDOKU_SUDOKU_VERIFIER_H
+#define GUDOKU_SUDOKU_VERIFIER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "gudoku/stddef.h"
+#include "gudoku/BitVec.h"
+#include "gudoku/StaticData.h"
+
+using namespace gudoku;
+
+namespace {
+
+struct alignas(64) VerifierTables {
+    // @formatter:off
+    // pshufb controls gathering the characters of the box i of a band to the lanes
+    // cy * 4 + cx of a box, from bytes 0 - 15 and bytes 11 - 26 of the band (0 elsewhere).
+    ConstBitVec<BitVec08x16> band_boxes_shuffle[2][3];
+
+    // pshufb tables of the low and high bytes of the bitmask of a character, looked up by
+    // its low 4 bits: '1' - '9' to 1 << 0 - 1 << 8, and the other low 4 bits to 0.
+    ConstBitVec<BitVec08x16> digit_bitmask_bytes[2];
+
+    // The high 4 bits of the characters '1' - '9' in the bytes of the cells of a box.
+    ConstBitVec<BitVec08x16> cell_digit_high_bits;
+
+    // All the 9 bits in the lanes of the cells of a box.
+    ConstBitVec<BitVec16x16> cell3x3_full;
+    // @formatter:on
+
+    template <size_t... Shuffles, size_t... DigitLanes>
+    static constexpr VerifierTables make(IndexSequence<Shuffles...>, IndexSequence<DigitLanes...>) {
+        return VerifierTables {
+            // band_boxes_shuffle[2][3]
+            { bandBoxesShuffle(Shuffles / 24, (Shuffles / 8) % 3, Shuffles % 8)... },
+
+            // digit_bitmask_bytes[2]
+            { digitBitmaskBytes(DigitLanes / 8, DigitLanes % 8)... },
+
+            // cell_digit_high_bits
+            { 0x3030, 0x0030, 0x3030, 0x0030, 0x3030, 0x0030,      0,      0 },
+
+            // cell3x3_full
+            {
+                0x01FF, 0x01FF, 0x01FF,      0,
+                0x01FF, 0x01FF, 0x01FF,      0,
+                0x01FF, 0x01FF, 0x01FF,      0,
+                     0,      0,      0,      0
+            }
+        };
+    }
+};
+
+static constexpr VerifierTables verifier_tables = VerifierTables::make(MakeIndexSequence<2 * 3 * 8>::type(),
+                                                                       MakeIndexSequence<2 * 8>::type());
+
+//
+// Checks that a solution is a valid grid that keeps the givens of its puzzle, with vector
+// ops only. The digits are loaded box by box as bitmasks in the lanes cy * 4 + cx of a
+// BitVec16x16 (as the boxes of DpllTriadSimdSolver), then every row, column and box must
+// have all the 9 bits: 9 single bits that cover 9 bits are 9 different digits.
+//
+struct SudokuVerifier {
+    //
+    // The characters of the 3 boxes of a band in the lanes of a box, from two overlapping
+    // 16 byte loads of the band (bytes 0 - 15 and 11 - 26), so nothing is read past the
+    // 81 bytes of the grid.
+    //
+    static
+    JSTD_FORCED_INLINE
+    void loadBand(const char * grid, int band, BitVec08x16 chars[3]) {
+        BitVec08x16 head, tail;
+        head.loadUnaligned(grid + band * 27);
+        tail.loadUnaligned(grid + band * 27 + 11);
+        for (int i = 0; i < 3; i++) {
+            chars[i] = head.shuffle(verifier_tables.band_boxes_shuffle[0][i]) |
+                       tail.shuffle(verifier_tables.band_boxes_shuffle[1][i]);
+        }
+    }
+
+    static
+    JSTD_FORCED_INLINE
+    BitVec16x16 toBitmasks(const BitVec08x16 & chars) {
+        BitVec08x16 low = verifier_tables.digit_bitmask_bytes[0].get().shuffle(chars);
+        BitVec08x16 high = verifier_tables.digit_bitmask_bytes[1].get().shuffle(chars);
+        return BitVec16x16(low.unpackLowU8(high), low.unpackHighU8(high));
+    }
+
+    // Every cell lane gets the union of its row (the lanes 3 of the rows are 0).
+    static
+    JSTD_FORCED_INLINE
+    BitVec16x16 unionOfRows(const BitVec16x16 & cells) {
+        BitVec16x16 rows = cells | cells.rotateRows2();
+        return (rows | rows.rotateRows());
+    }
+
+    // Every cell lane gets the union of its column (the lanes of the row 3 are 0).
+    static
+    JSTD_FORCED_INLINE
+    BitVec16x16 unionOfCols(const BitVec16x16 & cells) {
+        BitVec16x16 cols = cells | cells.rotateCols2();
+        return (cols | cols.rotateCols());
+    }
+
+    //
+    // The puzzle has '1' - '9' for the givens and anything else for the empty cells, the
+    // solution must have '1' - '9' in every cell.
+    //
+    static
+    JSTD_FORCED_INLINE
+    bool verify(const char * puzzle, const char * solution) {
+        const BitVec16x16 full = verifier_tables.cell3x3_full;
+        const BitVec08x16 high_bits_mask = BitVec08x16::full16(0xF0F0);
+        const BitVec08x16 digit_high_bits = BitVec08x16::full16(0x3030);
+        const BitVec08x16 cell_digit_high_bits = verifier_tables.cell_digit_high_bits;
+
+        BitVec16x16 errors;
+        errors.setAllZeros();
+        BitVec08x16 char_errors;
+        char_errors.setAllZeros();
+
+        BitVec16x16 stacks[3];
+        for (int band = 0; band < 3; band++) {
+            BitVec08x16 solution_chars[3], puzzle_chars[3];
+            loadBand(solution, band, solution_chars);
+            loadBand(puzzle, band, puzzle_chars);
+
+            BitVec16x16 band_rows;
+            band_rows.setAllZeros();
+            for (int i = 0; i < 3; i++) {
+                // Every cell of the solution is '1' - '9' ...
+                char_errors |= (solution_chars[i] & high_bits_mask) ^ cell_digit_high_bits;
+                BitVec16x16 cells = toBitmasks(solution_chars[i]);
+
+                // ... and keeps the given of the puzzle, if any.
+                BitVec08x16 is_digit = (puzzle_chars[i] & high_bits_mask).whichIsEqual8(digit_high_bits);
+                errors |= toBitmasks(puzzle_chars[i] & is_digit).and_not(cells);
+
+                BitVec16x16 rows = unionOfRows(cells);
+                band_rows |= rows;
+                // The box
+                errors |= full.and_not(unionOfCols(rows));
+                stacks[i] = (band == 0) ? cells : (stacks[i] | cells);
+            }
+            // The rows of the band
+            errors |= full.and_not(band_rows);
+        }
+        // The columns of the stacks
+        for (int i = 0; i < 3; i++) {
+            errors |= full.and_not(unionOfCols(stacks[i]));
+        }
+        return (errors.isAllZeros() && char_errors.isAllZeros());
+    }
+
+    //
+    // Checks count solutions: puzzle i at puzzles + i * puzzle_stride, solution i at
+    // solutions + i * solution_stride. valid is an optional array of count elements set
+    // to 1 or 0. Returns the number of valid solutions.
+    //
+    static size_t verifyBatch(const char * puzzles, size_t puzzle_stride,
+                              const char * solutions, size_t solution_stride,
+                              size_t count, uint8_t * valid = nullptr) {
+        size_t num_valid = 0;
+        for (size_t i = 0; i < count; i++) {
+            bool is_valid = verify(puzzles + i * puzzle_stride, solutions + i * solution_stride);
+            if (valid != nullptr)
+                valid[i] = (uint8_t)is_valid;
+            num_valid += (size_t)is_valid;
+        }
+        return num_valid;
+    }
+};
+
+} // namespace
+
+#endif // GUDOKU_SUDOKU_VERIFIER_H
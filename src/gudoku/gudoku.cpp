@@ -11,7 +11,106 @@
 
 #if (GUDOKU_NO_MAIN != 0)
 #include "gudoku/DpllTriadSimdSolver.h"
+#include "gudoku/SudokuVerifier.h"
+#include "gudoku/BitSliceSolver.h"
+#include "gudoku/SolutionCounter.h"
+#include "gudoku/BackboneSolver.h"
+
+namespace {
+// The batch solvers, one pair per thread like the solvers of gudoku_solver().
+thread_local BitSliceSolver<0> batch_solver_none{};
+thread_local BitSliceSolver<1> batch_solver_last{};
+// The solver of gudoku_backbone(), one per thread too.
+thread_local BackboneSolver backbone_solver{};
+} // namespace
+
+#ifdef __cplusplus
+extern "C"
 #endif
+size_t gudoku_solve_batch(const char * puzzles, size_t count, size_t stride,
+                          char * solutions, uint32_t configuration, size_t limit,
+                          size_t * num_solutions, size_t * num_guesses)
+{
+    if (stride == 0)
+        stride = Sudoku::BoardSize;
+
+    // The singles of the whole batch are bit-sliced, only the puzzles left go to the search.
+    bool probing = ((configuration & GUDOKU_CONFIG_PROBING) != 0);
+    bool return_last = (limit == 1 || (configuration & ~GUDOKU_CONFIG_PROBING) != 0);
+    if (return_last) {
+        batch_solver_last.set_probing(probing);
+        return batch_solver_last.solveBatch(puzzles, stride, solutions, Sudoku::BoardSize,
+                                            count, limit, num_solutions, num_guesses);
+    }
+    else {
+        batch_solver_none.set_probing(probing);
+        return batch_solver_none.solveBatch(puzzles, stride, solutions, Sudoku::BoardSize,
+                                            count, limit, num_solutions, num_guesses);
+    }
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+int gudoku_verify(const char * sudoku, const char * solution)
+{
+    return (SudokuVerifier::verify(sudoku, solution) ? 1 : 0);
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+size_t gudoku_verify_batch(const char * puzzles, size_t count, size_t stride,
+                           const char * solutions, uint8_t * valid)
+{
+    if (stride == 0)
+        stride = Sudoku::BoardSize;
+
+    return SudokuVerifier::verifyBatch(puzzles, stride, solutions, Sudoku::BoardSize, count, valid);
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+uint64_t gudoku_count_solutions(const char * sudoku, uint64_t * count_high)
+{
+    // The tables of a count are sized by the puzzle (tens of MB for the sparsest ones),
+    // so every call has its own counter and gives the memory back.
+    SolutionCounter counter;
+    UInt128 count = counter.count(sudoku);
+    if (count_high != nullptr)
+        *count_high = count.high;
+    return count.low;
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+size_t gudoku_backbone(const char * sudoku, char * backbone, size_t * num_solutions)
+{
+    size_t num_cells = backbone_solver.backbone(sudoku, backbone);
+    if (num_solutions != nullptr)
+        *num_solutions = backbone_solver.get_num_solutions();
+    return num_cells;
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+const char * gudoku_version(void)
+{
+    return GUDOKU_VERSION_STRING;
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+uint32_t gudoku_version_number(void)
+{
+    return GUDOKU_VERSION_NUMBER;
+}
+
+#endif // (GUDOKU_NO_MAIN != 0)
 
 #if 0
 #if (GUDOKU_NO_MAIN != 0)
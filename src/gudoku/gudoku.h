@@ -9,13 +9,103 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "gudoku/version.h"
+
+//
+// GUDOKU_API: SHARED_DLL is defined when building libgudoku.so / gudoku.dll,
+// GUDOKU_DLL is defined by the users of the shared library on Windows.
+//
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__CYGWIN__)
+  #if defined(SHARED_DLL)
+    #define GUDOKU_API      __declspec(dllexport)
+  #elif defined(GUDOKU_DLL)
+    #define GUDOKU_API      __declspec(dllimport)
+  #else
+    #define GUDOKU_API
+  #endif
+#elif defined(__GNUC__) && (__GNUC__ >= 4)
+  #define GUDOKU_API        __attribute__((visibility("default")))
+#else
+  #define GUDOKU_API
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+//
+// The flags of the configuration of gudoku_solver() and gudoku_solve_batch(), any other
+// nonzero bits ask for the solution. GUDOKU_CONFIG_PROBING turns on failed-literal probing
+// before every branch of the search: fewer guesses on hard puzzles, slower on easy ones.
+//
+#define GUDOKU_CONFIG_PROBING       0x00010000u
+
+//
+// Solve one puzzle (81 chars, '1'-'9' for givens and anything else for empties).
+// The solution is written when limit == 1 or configuration has bits other than the flags.
+// Returns the number of solutions found, up to limit.
+//
+GUDOKU_API
 size_t gudoku_solver(const char * sudoku, char * solution, uint32_t configuration,
                      size_t limit, size_t * num_guesses);
 
+//
+// Solve count puzzles in one call. Puzzle i starts at puzzles + i * stride (a stride of 0
+// means 81, use 82 for newline separated text), solution i is written to solutions + i * 81.
+// num_solutions and num_guesses are optional arrays of count elements (may be NULL).
+// Returns the number of puzzles that have at least one solution.
+//
+GUDOKU_API
+size_t gudoku_solve_batch(const char * puzzles, size_t count, size_t stride,
+                          char * solutions, uint32_t configuration, size_t limit,
+                          size_t * num_solutions, size_t * num_guesses);
+
+//
+// Check that a solution (81 chars) is a valid grid that keeps the givens of the puzzle
+// ('1'-'9' for givens and anything else for empties), with SIMD ops only.
+// Returns 1 if it is, 0 if not.
+//
+GUDOKU_API
+int gudoku_verify(const char * sudoku, const char * solution);
+
+//
+// Check count solutions in one call. Puzzle i starts at puzzles + i * stride (a stride of 0
+// means 81, as in gudoku_solve_batch), solution i at solutions + i * 81. valid is an optional
+// array of count elements (may be NULL), set to 1 or 0.
+// Returns the number of valid solutions.
+//
+GUDOKU_API
+size_t gudoku_verify_batch(const char * puzzles, size_t count, size_t stride,
+                           const char * solutions, uint8_t * valid);
+
+//
+// Count all the solutions of a puzzle exactly, with no limit: count_high * 2^64 + the returned
+// low 64 bits (the empty grid has 6670903752021072936960 solutions, more than 64 bits).
+// count_high is optional (may be NULL). Meant for grids with few clues, where the search of
+// gudoku_solver() can't enumerate the solutions: 12 clues take about a second, every clue
+// less about 3 times longer (the empty grid takes about 15 seconds, by its symmetry).
+//
+GUDOKU_API
+uint64_t gudoku_count_solutions(const char * sudoku, uint64_t * count_high);
+
+//
+// Find the backbone of a puzzle, the cells with the same digit in every solution (for hints on
+// a grid the user has changed, which may have many solutions), in one search: backbone (81 chars)
+// gets the digit of every such cell and '.' elsewhere. num_solutions is optional (may be NULL),
+// set to the number of solutions the search met: 0 if none, 1 if the puzzle is unique, more
+// (but not all of them) otherwise. Returns the number of backbone cells, 0 if there is no solution.
+//
+GUDOKU_API
+size_t gudoku_backbone(const char * sudoku, char * backbone, size_t * num_solutions);
+
+// Returns GUDOKU_VERSION_STRING of the library, e.g. "1.0.0".
+GUDOKU_API
+const char * gudoku_version(void);
+
+// Returns GUDOKU_VERSION_NUMBER of the library, e.g. 10000.
+GUDOKU_API
+uint32_t gudoku_version_number(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,23 @@
+
+#ifndef GUDOKU_VERSION_H
+#define GUDOKU_VERSION_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif
+
+#define GUDOKU_VERSION_MAJOR    1
+#define GUDOKU_VERSION_MINOR    0
+#define GUDOKU_VERSION_PATCH    0
+
+#define GUDOKU_VERSION_NUMBER   ((GUDOKU_VERSION_MAJOR * 10000) + \
+                                 (GUDOKU_VERSION_MINOR * 100) + GUDOKU_VERSION_PATCH)
+
+#define GUDOKU_STRINGIFY_IMPL(x)    #x
+#define GUDOKU_STRINGIFY(x)         GUDOKU_STRINGIFY_IMPL(x)
+
+#define GUDOKU_VERSION_STRING   GUDOKU_STRINGIFY(GUDOKU_VERSION_MAJOR) "." \
+                                GUDOKU_STRINGIFY(GUDOKU_VERSION_MINOR) "." \
+                                GUDOKU_STRINGIFY(GUDOKU_VERSION_PATCH)
+
+#endif // GUDOKU_VERSION_H
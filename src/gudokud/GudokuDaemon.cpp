@@ -0,0 +1,679 @@
+
+//
+// gudokud: a long-running local solver daemon.
+//
+// The daemon listens on a Unix-domain stream socket and keeps one worker thread per core,
+// each pinned to its core and owning its own warm DpllTriadSimdSolver instances and its own
+// epoll set. Connections are handed round-robin to the workers by the accept loop, then a
+// worker reads everything that is ready on all of its connections, solves the whole batch
+// of complete requests back to back, and queues the replies, which are written without
+// blocking (EPOLLOUT is armed only while a connection has unsent output).
+//
+// A connection is not read while its unsent output is above a high-water mark, and only
+// its first kMaxRoundRequests complete requests go into a batch, the rest wait for the
+// next round, so a client that floods requests or doesn't read its replies can't starve
+// the other connections of its worker.
+//
+// Requests are pipelined, a client may send any number of them before reading replies;
+// replies come back in request order per connection. Two request formats can be mixed
+// on a connection, the first byte of each request selects it:
+//
+//   Line request:   <81 cells>[ <limit>]\n
+//                   cells are '1'-'9' for givens, '.', '0' or '-' for empties,
+//                   limit is capped at 255 like the binary one.
+//   Line reply:     <solutions> <guesses> <solution>\n
+//                   solution is 81 '.' when there is none.
+//                   "ERROR <reason>\n" for a malformed request, or for one whose
+//                   search was aborted (out of its guess budget, or the daemon stops).
+//
+//   Binary request: (85 bytes)
+//                   uint8_t  magic = 0xB5
+//                   uint8_t  limit                     (0 means 1)
+//                   uint16_t id                        (little endian, echoed back)
+//                   char     cells[81]
+//   Binary reply:   (89 bytes)
+//                   uint8_t  magic = 0xB5
+//                   uint8_t  solutions                 (saturated to 255)
+//                   uint16_t id
+//                   uint32_t guesses                   (little endian)
+//                   char     solution[81]
+//                   solutions = 0 and guesses = 0xFFFFFFFF when the search was aborted.
+//
+// Every search is bounded by a guess budget, so one request can't hold a worker's core,
+// and it is cancelled when the daemon is stopped.
+//
+// Usage: gudokud [socket_path] [num_workers]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <memory.h>
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memset(), std::memcpy()
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "gudoku/CPUWarmUp.h"
+
+#include "gudoku/gudoku.h"
+#include "gudoku/BitUtils.h"
+
+#include "gudoku/DpllTriadSimdSolver.h"
+
+using namespace gudoku;
+
+namespace {
+
+static const char *   kDefaultSocketPath  = "/tmp/gudokud.sock";
+static const uint8_t  kBinaryMagic        = 0xB5;
+static const size_t   kBinaryRequestSize  = 4 + 81;
+static const size_t   kBinaryReplySize    = 8 + 81;
+static const size_t   kMaxLineSize        = 256;
+static const uint32_t kMaxLimit           = 255;
+static const size_t   kGuessBudget        = 1024 * 1024;
+static const size_t   kReadChunkSize      = 64 * 1024;
+static const size_t   kMaxInputSize       = 4 * kReadChunkSize;
+static const size_t   kMaxOutputSize      = 4 * kReadChunkSize;
+static const size_t   kMaxRoundRequests   = 256;
+static const int      kMaxEvents          = 64;
+static const int      kWarmUpMillisecs    = 500;
+
+static std::atomic<bool> s_stop_request(false);
+
+struct Connection {
+    int         fd;
+    bool        eof;
+    bool        more_input;     // in_buf may hold complete requests left for the next round
+    uint32_t    interest;       // the epoll events asked for
+    uint32_t    revents;        // the epoll events of this round
+    size_t      round;          // the last round the connection was gathered in
+    size_t      slot;           // index in the worker's connections
+    std::string in_buf;
+    std::string out_buf;
+    size_t      out_offset;
+
+    explicit Connection(int _fd)
+        : fd(_fd), eof(false), more_input(false), interest(EPOLLIN | EPOLLRDHUP),
+          revents(0), round(0), slot(0), out_offset(0) {}
+
+    size_t pending_output() const {
+        return (this->out_buf.size() - this->out_offset);
+    }
+};
+
+struct Request {
+    Connection * conn;
+    bool         binary;
+    bool         valid;
+    uint16_t     id;
+    uint32_t     limit;
+    char         cells[81];
+};
+
+static bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return false;
+    return (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+// Parse one line request, returns false if it's malformed.
+static bool parseLineRequest(const char * line, size_t length, Request & request) {
+    size_t pos = 0, i = 0;
+    for (; i < length && pos < Sudoku::BoardSize; i++) {
+        char val = line[i];
+        if (val >= '1' && val <= '9')
+            request.cells[pos++] = val;
+        else if (val == '0' || val == '.' || val == '-')
+            request.cells[pos++] = '.';
+        else
+            return false;
+    }
+    if (pos != Sudoku::BoardSize) return false;
+
+    request.limit = 1;
+    while (i < length && (line[i] == ' ' || line[i] == '\t')) i++;
+    if (i < length) {
+        uint32_t limit = 0;
+        for (; i < length && line[i] >= '0' && line[i] <= '9'; i++) {
+            uint32_t digit = (uint32_t)(line[i] - '0');
+            if (limit > (UINT32_MAX - digit) / 10) return false;
+            limit = limit * 10 + digit;
+        }
+        if (i != length) return false;
+        if (limit > kMaxLimit) limit = kMaxLimit;
+        request.limit = (limit != 0) ? limit : 1;
+    }
+    return true;
+}
+
+class Worker {
+private:
+    int                         index_;
+    int                         cpu_;
+    int                         epoll_fd_;
+    std::thread                 thread_;
+    std::atomic<size_t>         num_requests_;
+
+    // The solvers live on the worker's own stack (see run()), so they are allocated
+    // with the right alignment and first touched by the core that uses them.
+    DpllTriadSimdSolver<1> *    solver_last_;
+    DpllTriadSimdSolver<0> *    solver_none_;
+
+    std::vector<Request>        batch_;
+    std::vector<Connection *>   ready_;
+    std::vector<Connection *>   backlog_;
+    size_t                      round_;
+
+    // All the open connections, added by the accept loop and removed by the worker.
+    std::mutex                  connections_mutex_;
+    std::vector<Connection *>   connections_;
+
+public:
+    Worker(int index, int cpu)
+        : index_(index), cpu_(cpu), epoll_fd_(-1), num_requests_(0),
+          solver_last_(nullptr), solver_none_(nullptr), round_(0) {
+    }
+
+    ~Worker() {
+        for (size_t i = 0; i < this->connections_.size(); i++) {
+            ::close(this->connections_[i]->fd);
+            delete this->connections_[i];
+        }
+        if (this->epoll_fd_ >= 0)
+            ::close(this->epoll_fd_);
+    }
+
+    size_t num_requests() const { return this->num_requests_.load(); }
+
+    bool start() {
+        this->epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (this->epoll_fd_ < 0) return false;
+        this->thread_ = std::thread(&Worker::run, this);
+        return true;
+    }
+
+    void join() {
+        if (this->thread_.joinable())
+            this->thread_.join();
+    }
+
+    // Called from the accept loop, epoll_ctl() is thread-safe.
+    bool addConnection(int fd) {
+        Connection * conn = new Connection(fd);
+        this->registerConnection(conn);
+        struct epoll_event event;
+        event.events = conn->interest;
+        event.data.ptr = (void *)conn;
+        if (::epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            this->unregisterConnection(conn);
+            delete conn;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void pinToCpu() {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(this->cpu_, &cpu_set);
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set);
+    }
+
+    void warmUp() {
+        // Spin the core up, then touch the solver and its tables.
+        test::CPU::warm_up(kWarmUpMillisecs);
+        char solution[81];
+        const char * puzzle =
+            "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..";
+        for (int i = 0; i < 100; i++) {
+            this->solver_last_->solve(puzzle, solution, 1);
+            this->solver_none_->solve(puzzle, solution, 2);
+        }
+    }
+
+    void registerConnection(Connection * conn) {
+        std::lock_guard<std::mutex> lock(this->connections_mutex_);
+        conn->slot = this->connections_.size();
+        this->connections_.push_back(conn);
+    }
+
+    void unregisterConnection(Connection * conn) {
+        std::lock_guard<std::mutex> lock(this->connections_mutex_);
+        Connection * last = this->connections_.back();
+        this->connections_[conn->slot] = last;
+        last->slot = conn->slot;
+        this->connections_.pop_back();
+    }
+
+    void closeConnection(Connection * conn) {
+        ::epoll_ctl(this->epoll_fd_, EPOLL_CTL_DEL, conn->fd, nullptr);
+        ::close(conn->fd);
+        this->unregisterConnection(conn);
+        delete conn;
+    }
+
+    // Read while the unsent output is below the high-water mark, write while there is some.
+    void updateInterest(Connection * conn) {
+        size_t pending = conn->pending_output();
+        uint32_t interest = 0;
+        if (!conn->eof && pending < kMaxOutputSize)
+            interest |= EPOLLIN | EPOLLRDHUP;
+        if (pending != 0)
+            interest |= EPOLLOUT;
+        if (conn->interest == interest) return;
+        struct epoll_event event;
+        event.events = interest;
+        event.data.ptr = (void *)conn;
+        ::epoll_ctl(this->epoll_fd_, EPOLL_CTL_MOD, conn->fd, &event);
+        conn->interest = interest;
+    }
+
+    // Returns false if the connection is broken. Reads at most about kMaxInputSize bytes
+    // ahead, the rest stays in the socket (epoll is level-triggered).
+    bool readAll(Connection * conn) {
+        char buf[kReadChunkSize];
+        while (!conn->eof && conn->in_buf.size() < kMaxInputSize) {
+            ssize_t n = ::recv(conn->fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                conn->in_buf.append(buf, (size_t)n);
+            }
+            else if (n == 0) {
+                conn->eof = true;
+            }
+            else {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns false if the connection is broken.
+    bool writeAll(Connection * conn) {
+        while (conn->out_offset < conn->out_buf.size()) {
+            ssize_t n = ::send(conn->fd, conn->out_buf.data() + conn->out_offset,
+                               conn->out_buf.size() - conn->out_offset, MSG_NOSIGNAL);
+            if (n > 0) {
+                conn->out_offset += (size_t)n;
+            }
+            else if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            else {
+                return false;
+            }
+        }
+        if (conn->out_offset == conn->out_buf.size()) {
+            conn->out_buf.clear();
+            conn->out_offset = 0;
+        }
+        else if (conn->out_offset >= kReadChunkSize) {
+            conn->out_buf.erase(0, conn->out_offset);
+            conn->out_offset = 0;
+        }
+        return true;
+    }
+
+    // Move the complete requests of a connection into the batch, at most kMaxRoundRequests.
+    void parseRequests(Connection * conn) {
+        const std::string & in = conn->in_buf;
+        size_t offset = 0, num_requests = 0;
+        conn->more_input = false;
+        while (offset < in.size()) {
+            if (num_requests == kMaxRoundRequests) {
+                conn->more_input = true;
+                break;
+            }
+            Request request;
+            request.conn = conn;
+            request.id = 0;
+            if ((uint8_t)in[offset] == kBinaryMagic) {
+                if (in.size() - offset < kBinaryRequestSize) break;
+                const uint8_t * frame = (const uint8_t *)in.data() + offset;
+                request.binary = true;
+                request.limit = (frame[1] != 0) ? frame[1] : 1;
+                request.id = (uint16_t)(frame[2] | (frame[3] << 8));
+                request.valid = true;
+                for (size_t pos = 0; pos < Sudoku::BoardSize; pos++) {
+                    char val = (char)frame[4 + pos];
+                    request.cells[pos] = (val >= '1' && val <= '9') ? val : '.';
+                }
+                offset += kBinaryRequestSize;
+            }
+            else {
+                size_t eol = in.find('\n', offset);
+                if (eol == std::string::npos) {
+                    if (in.size() - offset > kMaxLineSize) {
+                        // Garbage without a line end, drop it and report once.
+                        request.binary = false;
+                        request.valid = false;
+                        this->batch_.push_back(request);
+                        offset = in.size();
+                    }
+                    break;
+                }
+                size_t length = eol - offset;
+                if (length > 0 && in[offset + length - 1] == '\r') length--;
+                if (length != 0) {
+                    request.binary = false;
+                    request.valid = parseLineRequest(in.data() + offset, length, request);
+                    this->batch_.push_back(request);
+                    num_requests++;
+                }
+                offset = eol + 1;
+                continue;
+            }
+            this->batch_.push_back(request);
+            num_requests++;
+        }
+        conn->in_buf.erase(0, offset);
+    }
+
+    void solveRequest(const Request & request, std::string & out) {
+        char solution[81];
+        size_t solutions = 0, guesses = 0;
+        bool aborted = false;
+        if (request.valid) {
+            if (request.limit == 1) {
+                solutions = this->solver_last_->solve(request.cells, solution, 1);
+                guesses = this->solver_last_->get_num_guesses();
+                aborted = this->solver_last_->aborted();
+            }
+            else {
+                solutions = this->solver_none_->solve(request.cells, solution, request.limit);
+                guesses = this->solver_none_->get_num_guesses();
+                aborted = this->solver_none_->aborted();
+                if (solutions != 0 && !aborted) {
+                    this->solver_last_->solve(request.cells, solution, 1);
+                    aborted = this->solver_last_->aborted();
+                }
+            }
+        }
+        if (solutions == 0 || aborted) {
+            solutions = 0;
+            std::memset(solution, '.', sizeof(solution));
+        }
+
+        if (request.binary) {
+            uint8_t reply[kBinaryReplySize];
+            uint32_t guesses32 = (guesses < UINT32_MAX && !aborted) ? (uint32_t)guesses : UINT32_MAX;
+            reply[0] = kBinaryMagic;
+            reply[1] = (uint8_t)((solutions < 255) ? solutions : 255);
+            reply[2] = (uint8_t)(request.id & 0xFF);
+            reply[3] = (uint8_t)(request.id >> 8);
+            reply[4] = (uint8_t)(guesses32 & 0xFF);
+            reply[5] = (uint8_t)((guesses32 >> 8) & 0xFF);
+            reply[6] = (uint8_t)((guesses32 >> 16) & 0xFF);
+            reply[7] = (uint8_t)(guesses32 >> 24);
+            std::memcpy(&reply[8], solution, sizeof(solution));
+            out.append((const char *)reply, sizeof(reply));
+        }
+        else if (aborted) {
+            out.append("ERROR search aborted\n");
+        }
+        else if (request.valid) {
+            char header[48];
+            int len = snprintf(header, sizeof(header), "%" PRIuPTR " %" PRIuPTR " ", solutions, guesses);
+            out.append(header, (size_t)len);
+            out.append(solution, sizeof(solution));
+            out.push_back('\n');
+        }
+        else {
+            out.append("ERROR malformed request\n");
+        }
+    }
+
+    void run() {
+        this->pinToCpu();
+
+        DpllTriadSimdSolver<1> solver_last;
+        DpllTriadSimdSolver<0> solver_none;
+        this->solver_last_ = &solver_last;
+        this->solver_none_ = &solver_none;
+        this->warmUp();
+
+        solver_last.set_guess_budget(kGuessBudget);
+        solver_none.set_guess_budget(kGuessBudget);
+        solver_last.set_cancel_flag(&s_stop_request);
+        solver_none.set_cancel_flag(&s_stop_request);
+
+        struct epoll_event events[kMaxEvents];
+        while (!s_stop_request.load()) {
+            // The connections with requests left from the last round don't wait.
+            int timeout = this->backlog_.empty() ? 200 : 0;
+            int num_events = ::epoll_wait(this->epoll_fd_, events, kMaxEvents, timeout);
+            if (num_events < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            // Gather: read every ready connection and parse its complete requests.
+            this->round_++;
+            this->ready_.clear();
+            this->batch_.clear();
+            for (int i = 0; i < num_events; i++) {
+                Connection * conn = (Connection *)events[i].data.ptr;
+                conn->round = this->round_;
+                conn->revents = events[i].events;
+                this->ready_.push_back(conn);
+            }
+            for (size_t i = 0; i < this->backlog_.size(); i++) {
+                Connection * conn = this->backlog_[i];
+                if (conn->round == this->round_) continue;
+                conn->round = this->round_;
+                conn->revents = 0;
+                this->ready_.push_back(conn);
+            }
+            this->backlog_.clear();
+
+            size_t num_ready = 0;
+            for (size_t i = 0; i < this->ready_.size(); i++) {
+                Connection * conn = this->ready_[i];
+                bool alive = true;
+                if (conn->revents & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    alive = this->readAll(conn);
+                }
+                if (alive && (conn->revents & EPOLLERR)) {
+                    alive = false;
+                }
+                if (!alive) {
+                    this->closeConnection(conn);
+                    continue;
+                }
+                if (conn->pending_output() < kMaxOutputSize)
+                    this->parseRequests(conn);
+                else
+                    conn->more_input = !conn->in_buf.empty();
+                this->ready_[num_ready++] = conn;
+            }
+            this->ready_.resize(num_ready);
+
+            // Solve the whole batch back to back on this core.
+            for (size_t i = 0; i < this->batch_.size(); i++) {
+                const Request & request = this->batch_[i];
+                this->solveRequest(request, request.conn->out_buf);
+            }
+            this->num_requests_ += this->batch_.size();
+
+            // Reply: flush without blocking, keep EPOLLOUT armed for the rest.
+            for (size_t i = 0; i < this->ready_.size(); i++) {
+                Connection * conn = this->ready_[i];
+                if (!this->writeAll(conn)) {
+                    this->closeConnection(conn);
+                    continue;
+                }
+                bool pending = !conn->out_buf.empty();
+                if (conn->eof && !pending && !conn->more_input) {
+                    this->closeConnection(conn);
+                    continue;
+                }
+                this->updateInterest(conn);
+                if (conn->more_input && conn->pending_output() < kMaxOutputSize)
+                    this->backlog_.push_back(conn);
+            }
+        }
+    }
+};
+
+class Daemon {
+private:
+    std::string             socket_path_;
+    int                     listen_fd_;
+    std::vector<Worker *>   workers_;
+
+public:
+    explicit Daemon(const char * socket_path)
+        : socket_path_(socket_path), listen_fd_(-1) {}
+
+    ~Daemon() {
+        for (size_t i = 0; i < this->workers_.size(); i++) {
+            delete this->workers_[i];
+        }
+        if (this->listen_fd_ >= 0) {
+            ::close(this->listen_fd_);
+            ::unlink(this->socket_path_.c_str());
+        }
+    }
+
+    bool listen() {
+        struct sockaddr_un addr;
+        if (this->socket_path_.size() >= sizeof(addr.sun_path)) {
+            fprintf(stderr, "gudokud: socket path is too long: %s\n", this->socket_path_.c_str());
+            return false;
+        }
+        this->listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (this->listen_fd_ < 0) {
+            perror("gudokud: socket()");
+            return false;
+        }
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, this->socket_path_.c_str(), this->socket_path_.size());
+        ::unlink(this->socket_path_.c_str());
+        if (::bind(this->listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            perror("gudokud: bind()");
+            return false;
+        }
+        if (::listen(this->listen_fd_, SOMAXCONN) != 0) {
+            perror("gudokud: listen()");
+            return false;
+        }
+        return true;
+    }
+
+    bool startWorkers(int num_workers) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        ::sched_getaffinity(0, sizeof(cpu_set), &cpu_set);
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpu_set))
+                cpus.push_back(cpu);
+        }
+        if (cpus.empty())
+            cpus.push_back(0);
+        if (num_workers <= 0)
+            num_workers = (int)cpus.size();
+
+        for (int i = 0; i < num_workers; i++) {
+            Worker * worker = new Worker(i, cpus[i % cpus.size()]);
+            this->workers_.push_back(worker);
+            if (!worker->start()) {
+                perror("gudokud: epoll_create1()");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void run() {
+        size_t next_worker = 0;
+        while (!s_stop_request.load()) {
+            int fd = ::accept4(this->listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                perror("gudokud: accept4()");
+                break;
+            }
+            if (!setNonBlocking(fd) ||
+                !this->workers_[next_worker]->addConnection(fd)) {
+                ::close(fd);
+                continue;
+            }
+            next_worker = (next_worker + 1) % this->workers_.size();
+        }
+
+        size_t total_requests = 0;
+        for (size_t i = 0; i < this->workers_.size(); i++) {
+            this->workers_[i]->join();
+            total_requests += this->workers_[i]->num_requests();
+        }
+        printf("gudokud: stopped, %" PRIuPTR " request(s) served.\n", total_requests);
+    }
+};
+
+static void onStopSignal(int signum) {
+    UNUSED_VARIABLE(signum);
+    s_stop_request.store(true);
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const char * socket_path = kDefaultSocketPath;
+    int num_workers = 0;
+    if (argc > 1) {
+        socket_path = argv[1];
+    }
+    if (argc > 2) {
+        num_workers = atoi(argv[2]);
+    }
+
+    // No SA_RESTART, so accept() is interrupted and the loop sees the stop request.
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onStopSignal;
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+    ::signal(SIGPIPE, SIG_IGN);
+
+    Daemon daemon(socket_path);
+    if (!daemon.listen())
+        return 1;
+    if (!daemon.startWorkers(num_workers))
+        return 1;
+
+    printf("gudokud: listening on %s\n\n", socket_path);
+    fflush(stdout);
+
+    daemon.run();
+    return 0;
+}
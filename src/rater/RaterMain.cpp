@@ -0,0 +1,194 @@
+
+#if defined(_MSC_VER) && !defined(NDEBUG)
+#include <vld.h>
+#endif
+
+#if defined(_MSC_VER)
+#define __MMX__
+#define __SSE__
+#define __SSE2__
+#define __SSE3__
+#define __SSSE3__
+#define __SSE4A__
+#define __SSE4a__
+#define __SSE4_1__
+#define __SSE4_2__
+#define __POPCNT__
+#define __LZCNT__
+#define __AVX__
+#define __AVX2__
+#define __3dNOW__
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <memory.h>
+#include <assert.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <fstream>
+#include <cstring>      // For std::memset()
+#include <vector>
+
+#include "gudoku/StopWatch.h"
+
+#include "gudoku/SudokuRater.h"
+
+using namespace gudoku;
+
+size_t read_sudoku_board(Board & board, char line[256])
+{
+    char * pline = line;
+    // Skip the white spaces
+    while (*pline == ' ' || *pline == '\t') {
+        pline++;
+    }
+    // Is a comment ?
+    if ((*pline == '#') || ((*pline == '/') && (pline[1] == '/'))) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    char val;
+    while ((val = *pline++) != '\0' && pos < Sudoku::BoardSize) {
+        if (val >= '0' && val <= '9') {
+            if (val != '0')
+                board.cells[pos] = val;
+            else
+                board.cells[pos] = '.';
+            pos++;
+        }
+        else if ((val == '.') || (val == ' ') || (val == '-')) {
+            board.cells[pos] = '.';
+            pos++;
+        }
+    }
+    return pos;
+}
+
+//
+// Rate every puzzle of the input file (one puzzle per line) and write one line per
+// puzzle to the output file (or stdout):
+//
+//     <puzzle> <solution> <score> <technique>
+//
+// The puzzles are streamed, so the input may hold millions of them.
+//
+int rate_sudoku_puzzles(const char * in_file, const char * out_file)
+{
+    std::ifstream ifs;
+    ifs.open(in_file, std::ios::in);
+    if (!ifs.good()) {
+        printf("Error: can not open the input file: %s\n\n", in_file);
+        return 1;
+    }
+
+    FILE * fp = stdout;
+    if (out_file != nullptr) {
+        fp = fopen(out_file, "wb");
+        if (fp == nullptr) {
+            printf("Error: can not open the output file: %s\n\n", out_file);
+            return 1;
+        }
+    }
+
+    SudokuRater rater;
+    RateInfo info;
+    size_t histogram[Technique::Last] = { 0 };
+    size_t puzzleCount = 0;
+    size_t puzzleMultiSolution = 0;
+
+    Board board, solution;
+    char out_line[256];
+
+    test::StopWatch sw;
+    sw.start();
+
+    while (!ifs.eof()) {
+        char line[256];
+        std::fill_n(line, sizeof(line), 0);
+        ifs.getline(line, sizeof(line) - 1);
+
+        board.clear();
+        size_t num_grids = read_sudoku_board(board, line);
+        // Sudoku::BoardSize = 81
+        if (num_grids < Sudoku::BoardSize)
+            continue;
+
+        solution.clear();
+        size_t solutions = rater.rate(&board.cells[0], &solution.cells[0], info);
+        histogram[info.rating]++;
+        puzzleMultiSolution += (solutions > 1);
+        puzzleCount++;
+
+        char * p = out_line;
+        std::memcpy(p, &board.cells[0], Sudoku::BoardSize);
+        p += Sudoku::BoardSize;
+        *p++ = ' ';
+        if (solutions != 0)
+            std::memcpy(p, &solution.cells[0], Sudoku::BoardSize);
+        else
+            std::memset(p, '.', Sudoku::BoardSize);
+        p += Sudoku::BoardSize;
+        p += snprintf(p, sizeof(out_line) - (p - out_line), " %0.1f %s%s\n",
+                      info.score, Technique::name(info.rating),
+                      (solutions > 1) ? " (multi-solution)" : "");
+        fwrite(out_line, 1, p - out_line, fp);
+    }
+
+    sw.stop();
+    double total_time = sw.getElapsedMillisec();
+
+    if (fp != stdout)
+        fclose(fp);
+    ifs.close();
+
+    FILE * summary = (fp != stdout) ? stdout : stderr;
+    fprintf(summary, "------------------------------------------\n\n");
+    fprintf(summary, "gudoku: SudokuRater\n\n");
+    fprintf(summary, "Total puzzle(s): %u, multi-solution: %u\n\n",
+            (uint32_t)puzzleCount, (uint32_t)puzzleMultiSolution);
+    for (int technique = Technique::None; technique < Technique::Last; technique++) {
+        if (histogram[technique] == 0) continue;
+        fprintf(summary, "  %-18s (%4.1f): %10" PRIuPTR "  %5.1f %%\n",
+                Technique::name(technique), Technique::score(technique),
+                histogram[technique], calc_percent(histogram[technique], puzzleCount));
+    }
+    fprintf(summary, "\n");
+    fprintf(summary, "Total elapsed time: %0.3f ms\n\n", total_time);
+    if (puzzleCount != 0) {
+        fprintf(summary, "%0.1f usec/puzzle, %0.1f puzzles/sec\n\n",
+                total_time * 1000.0 / puzzleCount,
+                puzzleCount / (total_time / 1000.0));
+    }
+    fprintf(summary, "------------------------------------------\n\n");
+    return 0;
+}
+
+int main(int argc, char * argv[])
+{
+    const char * in_file = nullptr;
+    const char * out_file = nullptr;
+    if (argc > 2) {
+        in_file = argv[1];
+        out_file = argv[2];
+    }
+    else if (argc > 1) {
+        in_file = argv[1];
+    }
+
+    if (in_file == nullptr) {
+        printf("Usage: rater <puzzles_file> [output_file]\n\n");
+        return 1;
+    }
+
+    return rate_sudoku_puzzles(in_file, out_file);
+}